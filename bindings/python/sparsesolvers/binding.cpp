@@ -5,7 +5,12 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 
+#include <chrono>
 #include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -65,6 +70,14 @@ namespace util
 namespace builders
 {
     using namespace ss;
+
+    struct py_blas_threads
+    {
+        explicit py_blas_threads(int threads) : threads(threads) {}
+
+        int threads;
+        std::unique_ptr<blas_thread_scope> scope;
+    };
     
     template <typename Policy>
     struct py_solver
@@ -74,17 +87,162 @@ namespace builders
         kernelpp::variant<
             solver<float, Policy>, solver<double, Policy>
             > m;
+
+        /* arrays the solver holds views of, when not the constructor argument */
+        std::vector<py::object> m_refs;
     };
 
+    /* note: the solver holds a view of A, which is kept alive with the solver */
     template <typename T, typename P>
     void init(py::class_<py_solver<P>>& cls)
     {
         cls.def(py::init([](py::array_t<T> A_) {
             auto A = as_span<2>(A_);
             return new py_solver<P>{ A.shape(), solver<T, P>(A) };
-        }));
+        }), py::arg("A").noconvert(), py::keep_alive<1, 2>());
+    }
+
+    template <typename T, typename P>
+    void init_options(py::class_<py_solver<P>>& cls)
+    {
+        using options_type = typename P::options_type;
+
+        cls.def(py::init([](py::array_t<T> A_, const options_type& options) {
+            auto A = as_span<2>(A_);
+            return new py_solver<P>{ A.shape(), solver<T, P>(A, options) };
+        }), py::arg("A").noconvert(), py::arg("options"), py::keep_alive<1, 2>());
     }
     
+    /* warns that a saved state was not used, and was recomputed instead */
+    inline void warn_recomputed(const std::string& error)
+    {
+        if (!error.empty()) {
+            PyErr_WarnEx(PyExc_RuntimeWarning, ("state recomputed, " + error).c_str(), 1);
+        }
+    }
+
+    /* reloads the state written by save() */
+    template <typename T, typename P>
+    void init_state(py::class_<py_solver<P>>& cls)
+    {
+        cls.def(py::init([](py::array_t<T> A_, const std::string& state) {
+            auto A = as_span<2>(A_);
+            std::string error;
+
+            auto* instance = new py_solver<P>{ A.shape(), solver<T, P>::load(A, state, &error) };
+            warn_recomputed(error);
+            return instance;
+        }), py::arg("A").noconvert(), py::arg("state"), py::keep_alive<1, 2>());
+    }
+
+    template <typename T, typename P>
+    void init_options_state(py::class_<py_solver<P>>& cls)
+    {
+        using options_type = typename P::options_type;
+
+        cls.def(py::init([](py::array_t<T> A_, const options_type& options, const std::string& state) {
+            auto A = as_span<2>(A_);
+            std::string error;
+
+            auto* instance = new py_solver<P>{
+                A.shape(), solver<T, P>::load(A, options, state, &error) };
+            warn_recomputed(error);
+            return instance;
+        }), py::arg("A").noconvert(), py::arg("options"), py::arg("state"), py::keep_alive<1, 2>());
+    }
+
+    template <typename P>
+    void save(py::class_<py_solver<P>>& cls)
+    {
+        cls.def("save",
+            [](py_solver<P>& instance, const std::string& path)
+            {
+                std::string error;
+                const bool saved = instance.m.template is<solver<float, P>>()
+                    ? instance.m.template get<solver<float, P>>().save(path, &error)
+                    : instance.m.template get<solver<double, P>>().save(path, &error);
+
+                if (!saved) { throw std::runtime_error(error); }
+            },
+
+            "Write the state precomputed from the sensing matrix to a file, "
+            "which may be passed as the state of a new solver.",
+            py::arg("path"));
+    }
+
+    /* the solver holds views of the CSC arrays and a CSR mirror of A */
+    template <typename T, typename P>
+    py_solver<P>* make_sparse(py::object csc, py::object csr)
+    {
+        using values  = py::array_t<T, py::array::c_style | py::array::forcecast>;
+        using indices = py::array_t<int32_t, py::array::c_style | py::array::forcecast>;
+
+        auto shape = csc.attr("shape").cast<std::pair<size_t, size_t>>();
+
+        auto csc_values = py::cast<values>(csc.attr("data"));
+        auto csc_rows   = py::cast<indices>(csc.attr("indices"));
+        auto csc_ptr    = py::cast<indices>(csc.attr("indptr"));
+        auto csr_values = py::cast<values>(csr.attr("data"));
+        auto csr_cols   = py::cast<indices>(csr.attr("indices"));
+        auto csr_ptr    = py::cast<indices>(csr.attr("indptr"));
+
+        auto A = as_csc_span(shape.first, shape.second,
+            csc_values.mutable_data(), csc_rows.data(), csc_ptr.data(),
+            csr_values.mutable_data(), csr_cols.data(), csr_ptr.data());
+
+        return new py_solver<P>{ A.shape(), solver<T, P>(A),
+            { csc_values, csc_rows, csc_ptr, csr_values, csr_cols, csr_ptr } };
+    }
+
+    /* accepts any scipy.sparse matrix, in single or double precision */
+    template <typename P>
+    void init_sparse(py::class_<py_solver<P>>& cls)
+    {
+        cls.def(py::init([](py::object A) {
+            auto sparse = py::module::import("scipy.sparse");
+
+            if (!sparse.attr("issparse")(A).template cast<bool>()) {
+                throw std::invalid_argument("Expected a scipy.sparse matrix");
+            }
+
+            py::object csc = sparse.attr("csc_matrix")(A);
+            py::object csr = csc.attr("tocsr")();
+
+            return py::str(csc.attr("dtype")).template cast<std::string>() == "float32"
+                ? make_sparse<float, P>(csc, csr)
+                : make_sparse<double, P>(csc, csr);
+        }), py::arg("A"));
+    }
+
+    /*  a read-only numpy array viewing the mapped matrix, which owns the
+     *  mapping; its pages are never copied in to numpy storage
+     */
+    template <typename T>
+    py::array mapped_array(mapped_matrix<T>&& mapped)
+    {
+        if (!mapped) { throw std::runtime_error(mapped.error()); }
+
+        auto* owner = new mapped_matrix<T>(std::move(mapped));
+        py::capsule base(owner, [](void* p) { delete static_cast<mapped_matrix<T>*>(p); });
+
+        const auto view = owner->view();
+        const std::vector<size_t> shape   = { view.shape()[0], view.shape()[1] };
+        const std::vector<size_t> strides = {
+            view.strides()[0] * sizeof(T), view.strides()[1] * sizeof(T) };
+
+        py::array_t<T> array(shape, strides, view.raw_data() + view.raw_data_offset(), base);
+        array.attr("setflags")(py::arg("write") = false);
+        return array;
+    }
+
+    inline map_options make_map_options(bool populate, bool huge_pages)
+    {
+        map_options options;
+        options.populate = populate;
+        options.huge_pages = huge_pages;
+        return options;
+    }
+
     template <typename T, typename P>
     void solve(py::class_<py_solver<P>>& cls)
     {
@@ -92,22 +250,31 @@ namespace builders
             [](py_solver<P>& instance,
                py::array_t<T> b,
                T tol = std::numeric_limits<T>::epsilon() * 10,
-               uint32_t maxiter = 100)
+               uint32_t maxiter = 100,
+               double time_budget = 0)
             {
                 using report_type = typename P::report_type;
                 py::array_t<T> x(instance.m_shape[1]);
 
                 auto& s = instance.m.template get<solver<T, P>>();
-                auto result = s.solve(as_span<1>(b), tol, maxiter, as_span<1>(x));
+                ss::solve_control control;
+                if (time_budget > 0) {
+                    using duration = ss::solve_control::clock::duration;
+                    control = ss::solve_control::within(std::chrono::duration_cast<duration>(
+                        std::chrono::duration<double>(time_budget)));
+                }
+                auto result = s.solve(as_span<1>(b), tol, maxiter, as_span<1>(x), control);
 
                 util::try_throw(result);
                 return std::make_tuple(x, result.template get<report_type>());
             },
 
-            "Execute the solver on the given inputs.",
+            "Execute the solver on the given inputs, stopping after time_budget "
+            "seconds if it is positive.",
             py::arg("b").noconvert(),
             py::arg("tolerance") = std::numeric_limits<T>::epsilon() * 10,
-            py::arg("max_iterations") = 100);
+            py::arg("max_iterations") = 100,
+            py::arg("time_budget") = 0.);
     }
 }
 
@@ -116,34 +283,164 @@ PYBIND11_PLUGIN(binding)
     py::module m("binding", "python binding example");
     m.def("version", &::util::get_version, LIB_NAME " version");
 
+    /* blas configuration */
+    py::enum_<ss::blas_backend>(m, "BlasBackend")
+        .value("automatic", ss::blas_backend::automatic)
+        .value("openblas_nehalem", ss::blas_backend::openblas_nehalem)
+        .value("openblas_haswell", ss::blas_backend::openblas_haswell)
+        .value("openblas_skylakex", ss::blas_backend::openblas_skylakex)
+        .value("system_openblas", ss::blas_backend::system_openblas)
+        .value("blis", ss::blas_backend::blis)
+        .value("mkl", ss::blas_backend::mkl)
+        .value("linked", ss::blas_backend::linked);
+
+    py::class_<ss::blas_info>(m, "BlasInfo")
+        .def_readonly("backend", &ss::blas_info::backend)
+        .def_readonly("library", &ss::blas_info::library)
+        .def_readonly("variant", &ss::blas_info::variant)
+        .def_readonly("threading", &ss::blas_info::threading)
+        .def_readonly("threads", &ss::blas_info::threads)
+        .def_readonly("error", &ss::blas_info::error);
+
+    m.def("set_blas_backend", &ss::set_blas_backend,
+        "Select the BLAS library to load on first use.",
+        py::arg("backend"), py::arg("path") = "");
+
+    m.def("blas_info", &ss::get_blas_info, "Describe the BLAS library in use.");
+
+    py::enum_<ss::blas_threading>(m, "BlasThreading")
+        .value("unknown", ss::blas_threading::unknown)
+        .value("sequential", ss::blas_threading::sequential)
+        .value("pthreads", ss::blas_threading::pthreads)
+        .value("openmp", ss::blas_threading::openmp);
+
+    m.def("set_blas_threads", &ss::set_blas_threads,
+        "Set the number of BLAS threads for all threads.", py::arg("threads"));
+
+    m.def("blas_threads", &ss::get_blas_threads,
+        "The number of BLAS threads used by the calling thread.");
+
+    /* blas profiling */
+    py::class_<ss::blas_op_profile>(m, "BlasOpProfile")
+        .def_readonly("op", &ss::blas_op_profile::op)
+        .def_readonly("calls", &ss::blas_op_profile::calls)
+        .def_readonly("seconds", &ss::blas_op_profile::seconds)
+        .def_readonly("flops", &ss::blas_op_profile::flops)
+        .def_readonly("bytes", &ss::blas_op_profile::bytes);
+
+    m.def("blas_profiling_enabled", &ss::blas_profiling_enabled,
+        "True when built with BLAS profiling.");
+    m.def("blas_profile", &ss::get_blas_profile,
+        "Per-operation BLAS statistics recorded since the last reset.");
+    m.def("reset_blas_profile", &ss::reset_blas_profile,
+        "Clear the recorded BLAS statistics.");
+
+    /* context manager limiting the BLAS threads of the calling thread */
+    py::class_<builders::py_blas_threads>(m, "BlasThreads")
+        .def(py::init<int>(), py::arg("threads") = 1)
+        .def("__enter__", [](builders::py_blas_threads& self) {
+            self.scope.reset(new ss::blas_thread_scope(self.threads));
+            return &self;
+        })
+        .def("__exit__", [](builders::py_blas_threads& self, py::args) {
+            self.scope.reset();
+        });
+
+    /* memory mapped matrices */
+    m.def("map_npy",
+        [](const std::string& path, bool populate, bool huge_pages) {
+            const auto options = builders::make_map_options(populate, huge_pages);
+
+            if (ss::npy_dtype(path) == "f4") {
+                return builders::mapped_array(ss::mapped_matrix<float>::npy(path, options));
+            }
+            return builders::mapped_array(ss::mapped_matrix<double>::npy(path, options));
+        },
+        "Map a 2-d float32 or float64 .npy file, without copying it.",
+        py::arg("path"), py::arg("populate") = false, py::arg("huge_pages") = false);
+
+    m.def("map_raw",
+        [](const std::string& path, size_t rows, size_t cols, const std::string& dtype,
+           const std::string& order, size_t offset, bool populate, bool huge_pages)
+        {
+            const auto options = builders::make_map_options(populate, huge_pages);
+            const auto layout = order == "F" ?
+                ss::matrix_layout::column_major : ss::matrix_layout::row_major;
+
+            if (dtype == "float32") {
+                return builders::mapped_array(
+                    ss::mapped_matrix<float>::raw(path, rows, cols, layout, offset, options));
+            }
+            if (dtype == "float64") {
+                return builders::mapped_array(
+                    ss::mapped_matrix<double>::raw(path, rows, cols, layout, offset, options));
+            }
+            throw std::invalid_argument("dtype must be float32 or float64");
+        },
+        "Map a file of rows x cols elements in C (row-major) or F (column-major) order.",
+        py::arg("path"), py::arg("rows"), py::arg("cols"), py::arg("dtype") = "float64",
+        py::arg("order") = "C", py::arg("offset") = 0,
+        py::arg("populate") = false, py::arg("huge_pages") = false);
+
     /* homotopy report */
     py::class_<ss::homotopy_report>(m, "HomotopyReport")
         .def(py::init())
         .def_readwrite("iter", &ss::homotopy_report::iter)
-        .def_readwrite("solution_error", &ss::homotopy_report::solution_error);
+        .def_readwrite("solution_error", &ss::homotopy_report::solution_error)
+        .def_readwrite("truncated", &ss::homotopy_report::truncated);
+
+    /* homotopy options */
+    py::enum_<ss::homotopy_storage>(m, "HomotopyStorage")
+        .value("native", ss::homotopy_storage::native)
+        .value("fp16", ss::homotopy_storage::fp16)
+        .value("bf16", ss::homotopy_storage::bf16);
+
+    py::class_<ss::homotopy_options>(m, "HomotopyOptions")
+        .def(py::init())
+        .def_readwrite("column_major_copy", &ss::homotopy_options::column_major_copy)
+        .def_readwrite("storage", &ss::homotopy_options::storage)
+        .def_readwrite("quantized_screening", &ss::homotopy_options::quantized_screening);
 
     /* homotopy solver */
     auto homotopy = py::class_<builders::py_solver<ss::homotopy_policy>>(m, "Homotopy");
 
     builders::init<float>(homotopy);
     builders::init<double>(homotopy);
+    builders::init_options<float>(homotopy);
+    builders::init_options<double>(homotopy);
+    builders::init_state<float>(homotopy);
+    builders::init_state<double>(homotopy);
+    builders::init_options_state<float>(homotopy);
+    builders::init_options_state<double>(homotopy);
     builders::solve<float>(homotopy);
     builders::solve<double>(homotopy);
+    builders::save(homotopy);
+
+    /* homotopy solver for scipy.sparse matrices */
+    auto sparse_homotopy = py::class_<builders::py_solver<ss::sparse_homotopy_policy>>(m, "SparseHomotopy");
+
+    builders::init_sparse(sparse_homotopy);
+    builders::solve<float>(sparse_homotopy);
+    builders::solve<double>(sparse_homotopy);
 
     /* irls report */
     py::class_<ss::irls_report>(m, "IrlsReport")
         .def(py::init())
         .def_readwrite("iter", &ss::irls_report::iter)
         .def_readwrite("spd_failure", &ss::irls_report::spd_failure)
-        .def_readwrite("solution_error", &ss::irls_report::solution_error);
+        .def_readwrite("solution_error", &ss::irls_report::solution_error)
+        .def_readwrite("truncated", &ss::irls_report::truncated);
 
     /* irls solver */
     auto irls = py::class_<builders::py_solver<ss::irls_policy>>(m, "Irls");
 
     builders::init<float>(irls);
     builders::init<double>(irls);
+    builders::init_state<float>(irls);
+    builders::init_state<double>(irls);
     builders::solve<float>(irls);
     builders::solve<double>(irls);
+    builders::save(irls);
 
     return m.ptr();
 }
\ No newline at end of file
@@ -2,10 +2,17 @@
 Python binding tests
 '''
 
+import os
+import tempfile
 import unittest
 import sparsesolvers as ss
 import numpy as np
 
+try:
+    import scipy.sparse
+except ImportError:
+    scipy = None
+
 def _test_smoke(S, N, T):
     A = np.identity(N, dtype=T)
     solver = S(A)
@@ -67,6 +74,89 @@ class HomotopySolverTest(unittest.TestCase):
         assert len(x) == 5
         assert np.argmax(x) == 3
 
+    def test_fortran_order(self):
+        '''column-major and strided inputs are read in place'''
+
+        A = np.random.rand(10, 8) * 0.1
+        A[:, 3] = 1 # needle to find
+
+        signal = np.ones(10)
+        expect, _ = ss.Homotopy(A).solve(signal)
+
+        x, _ = ss.Homotopy(np.asfortranarray(A)).solve(signal)
+        assert np.allclose(x, expect)
+
+        # neither rows nor columns are contiguous
+        B = np.zeros((20, 16))
+        B[::2, ::2] = A
+        x, _ = ss.Homotopy(B[::2, ::2]).solve(signal)
+        assert np.allclose(x, expect)
+
+        options = ss.HomotopyOptions()
+        options.column_major_copy = True
+        x, _ = ss.Homotopy(A, options).solve(signal)
+        assert np.allclose(x, expect)
+
+    def test_reduced_storage(self):
+        '''16-bit storage of the sensing matrix agrees with float'''
+
+        A = np.random.rand(10, 8) * 0.1
+        A[:, 3] = 1 # needle to find
+
+        signal = np.ones(10)
+        expect, _ = ss.Homotopy(A).solve(signal)
+
+        for storage in (ss.HomotopyStorage.fp16, ss.HomotopyStorage.bf16):
+            options = ss.HomotopyOptions()
+            options.storage = storage
+            x, _ = ss.Homotopy(A, options).solve(signal)
+            assert np.argmax(x) == 3
+            assert np.allclose(x, expect, rtol=1e-2, atol=1e-2)
+
+    def test_quantized_screening(self):
+        '''int8 screening leaves the solution unchanged'''
+
+        A = np.random.rand(50, 200) * 0.1
+        A[:, 30] += 0.5 # needle to find
+
+        signal = np.ones(50)
+        expect, expect_info = ss.Homotopy(A).solve(signal, tolerance=0.01)
+
+        options = ss.HomotopyOptions()
+        options.quantized_screening = True
+        x, info = ss.Homotopy(A, options).solve(signal, tolerance=0.01)
+
+        assert info.iter == expect_info.iter
+        assert np.allclose(x, expect)
+
+@unittest.skipIf(scipy is None, 'scipy is not installed')
+class SparseHomotopySolverTest(unittest.TestCase):
+    def test_smoke_f32(self):
+        '''smoke test (float32)'''
+        _test_smoke(lambda A: ss.SparseHomotopy(scipy.sparse.csr_matrix(A)), 5, np.float32)
+
+    def test_smoke_f64(self):
+        '''smoke test (float64)'''
+        _test_smoke(lambda A: ss.SparseHomotopy(scipy.sparse.csc_matrix(A)), 5, np.float64)
+
+    def test_dense_equivalence(self):
+        '''sparse and dense matrices give the same solution'''
+
+        A = np.random.rand(10, 8) * 0.1
+        A[A < 0.075] = 0
+        A[:, 3] = 1 # needle to find
+
+        signal = np.ones(10)
+        expect, _ = ss.Homotopy(A).solve(signal)
+
+        x, _ = ss.SparseHomotopy(scipy.sparse.coo_matrix(A)).solve(signal)
+        assert np.allclose(x, expect)
+
+    def test_dense_rejected(self):
+        '''dense arrays are not accepted'''
+        with self.assertRaises(ValueError):
+            ss.SparseHomotopy(np.identity(5))
+
 class IrlsSolverTest(unittest.TestCase):
     def test_smoke_f32(self):
         '''smoke test (float32)'''
@@ -76,6 +166,109 @@ class IrlsSolverTest(unittest.TestCase):
         '''smoke test (float64)'''
         _test_smoke(ss.Irls, 5, np.float64)
 
+class SavedStateTest(unittest.TestCase):
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp()
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def test_reload(self):
+        '''solvers reloaded from a saved state give the same solution'''
+
+        A = np.random.rand(10, 5) * 0.1 + np.eye(10, 5)
+        signal = A[:, 2].copy()
+
+        for S in (ss.Irls, ss.Homotopy):
+            solver = S(A)
+            solver.save(self.path)
+
+            expect, _ = solver.solve(signal)
+            x, _ = S(A, state=self.path).solve(signal)
+            assert np.array_equal(x, expect)
+
+    def test_recomputed(self):
+        '''a state which doesn't match the matrix is recomputed, with a warning'''
+
+        A = np.random.rand(10, 5) * 0.1 + np.eye(10, 5)
+        ss.Irls(A).save(self.path)
+
+        with self.assertWarns(RuntimeWarning):
+            ss.Irls(A[:9, :].copy(), state=self.path)
+
+class MappedTest(unittest.TestCase):
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix='.npy')
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def test_npy(self):
+        '''.npy files are mapped in either order'''
+
+        A = np.random.rand(10, 8) * 0.1
+        A[:, 3] = 1
+
+        for a in (A, np.asfortranarray(A), A.astype(np.float32)):
+            np.save(self.path, a)
+            mapped = ss.map_npy(self.path, populate=True)
+
+            assert mapped.dtype == a.dtype
+            assert mapped.flags['F_CONTIGUOUS'] == a.flags['F_CONTIGUOUS']
+            assert not mapped.flags['OWNDATA']
+            assert not mapped.flags['WRITEABLE']
+            assert np.array_equal(mapped, a)
+
+        signal = np.ones(10)
+        np.save(self.path, A)
+        expect, _ = ss.Homotopy(A).solve(signal)
+        x, _ = ss.Homotopy(ss.map_npy(self.path)).solve(signal)
+        assert np.allclose(x, expect)
+
+    def test_raw(self):
+        '''raw files are mapped with the given shape and order'''
+
+        A = np.random.rand(3, 4).astype(np.float32)
+        with open(self.path, 'wb') as f:
+            f.write(b'x' * 16)
+            f.write(np.asfortranarray(A).tobytes(order='F'))
+
+        mapped = ss.map_raw(self.path, 3, 4, dtype='float32', order='F', offset=16)
+        assert np.array_equal(mapped, A)
+
+        with self.assertRaises(RuntimeError):
+            ss.map_raw(self.path, 30, 4, dtype='float32')
+
+class BlasTest(unittest.TestCase):
+    def test_info(self):
+        '''the loaded library is described'''
+        info = ss.blas_info()
+        assert len(info.library) > 0
+
+        # the library is already loaded, so the selection is ignored
+        assert not ss.set_blas_backend(ss.BlasBackend.mkl)
+
+    def test_threads(self):
+        '''the thread count is restored on leaving the context'''
+        threads = ss.blas_threads()
+        with ss.BlasThreads(1):
+            x, info = ss.Homotopy(np.identity(5)).solve(np.ones(5))
+
+        assert ss.blas_threads() == threads
+
+    def test_profile(self):
+        '''operations are recorded only when profiling is enabled'''
+        ss.reset_blas_profile()
+        ss.Homotopy(np.identity(5)).solve(np.ones(5))
+
+        profile = ss.blas_profile()
+        if ss.blas_profiling_enabled():
+            assert sum(op.calls for op in profile) > 0
+        else:
+            assert len(profile) == 0
+
 if __name__ == '__main__':
     print("[sparsesolvers] version={}".format(ss.version()))
     unittest.main()
\ No newline at end of file
@@ -29,20 +29,66 @@ macro (blas_init target blas_target)
     endif ()
 
     # get the latest OpenBLAS builds
+    set (components NEHALEM HASWELL)
+    set (BLAS_RUNTIME_FILE "$<TARGET_FILE_NAME:OpenBLAS::NEHALEM>")
+    set (BLAS_AVX_RUNTIME_FILE "$<TARGET_FILE_NAME:OpenBLAS::HASWELL>")
+
+    if (${ss}_WITH_SKYLAKEX_BLAS)
+        list (APPEND components SKYLAKEX)
+        set (BLAS_AVX512_RUNTIME_FILE "$<TARGET_FILE_NAME:OpenBLAS::SKYLAKEX>")
+    endif ()
+
     include ("${bootstrap}")
     OpenBLAS_find_archive (BUILD_URL url)
-    OpenBLAS_init (BUILD_URL "${url}" COMPONENTS NEHALEM HASWELL)
+    OpenBLAS_init (BUILD_URL "${url}" COMPONENTS ${components})
+
+    set (runtime_files)
+    foreach (component ${components})
+        add_dependencies (${target} "OpenBLAS::${component}")
+        list (APPEND runtime_files "$<TARGET_FILE:OpenBLAS::${component}>")
+    endforeach ()
 
-    add_dependencies (${target}
-        "OpenBLAS::NEHALEM" "OpenBLAS::HASWELL"
-    )
     set_target_properties (${target} PROPERTIES
-        REQUIRED_RUNTIME_FILES "$<TARGET_FILE:OpenBLAS::NEHALEM>;$<TARGET_FILE:OpenBLAS::HASWELL>"
+        REQUIRED_RUNTIME_FILES "${runtime_files}"
     )
     set (BLAS_OpenBLAS 1)
     set (${blas_target} OpenBLAS::NEHALEM)
 endmacro ()
 
+# links 'target' against a static BLAS found with find_package, which is
+# then called directly rather than loaded at runtime
+macro (blas_init_static target)
+    include (CheckFunctionExists)
+    find_package (Threads REQUIRED)
+
+    set (BLA_STATIC ON)
+    find_package (BLAS REQUIRED)
+
+    find_path (CBLAS_INCLUDE_DIR cblas.h PATH_SUFFIXES openblas blis)
+    if (NOT CBLAS_INCLUDE_DIR)
+        message (FATAL_ERROR "Static BLAS: couldn't find cblas.h (set CBLAS_INCLUDE_DIR)")
+    endif ()
+
+    target_include_directories (${target} PUBLIC "${CBLAS_INCLUDE_DIR}")
+    target_link_libraries (${target} PUBLIC ${BLAS_LIBRARIES} Threads::Threads)
+
+    if (EXISTS "${CBLAS_INCLUDE_DIR}/openblas_config.h")
+        set (BLAS_OpenBLAS 1)
+    endif ()
+
+    # the LAPACK routines are optional. They are declared by blas_prelude.h
+    # rather than lapacke.h, so only whether they link is checked
+    set (CMAKE_REQUIRED_LIBRARIES ${BLAS_LIBRARIES} Threads::Threads)
+    check_function_exists (LAPACKE_dgeqrf BLAS_LAPACKE_GEQRF_LINKS)
+    check_function_exists (LAPACKE_strtrs BLAS_LAPACKE_TRTRS_LINKS)
+    unset (CMAKE_REQUIRED_LIBRARIES)
+
+    if (BLAS_LAPACKE_GEQRF_LINKS AND BLAS_LAPACKE_TRTRS_LINKS)
+        set (BLAS_LAPACKE 1)
+    endif ()
+    set (BLAS_STATIC 1)
+endmacro ()
+
 macro (set_rpath target rpath)
     set_target_properties (${target} PROPERTIES 
         BUILD_WITH_INSTALL_RPATH TRUE
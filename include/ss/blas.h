@@ -0,0 +1,158 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ss
+{
+    /* BLAS configuration -------------------------------------------------- */
+
+    enum class blas_backend
+    {
+        /* the bundled OpenBLAS build best suited to the runtime cpu */
+        automatic,
+
+        /* a specific bundled OpenBLAS build */
+        openblas_nehalem,
+        openblas_haswell,
+        openblas_skylakex,
+
+        /* a library installed on the system */
+        system_openblas,
+        blis,
+        mkl,
+
+        /* linked statically when the library was built */
+        linked
+    };
+
+    enum class blas_threading
+    {
+        unknown,
+        sequential,
+        pthreads,
+        openmp
+    };
+
+    struct blas_info
+    {
+        /* the backend in use */
+        blas_backend backend;
+
+        /* the file name (or path) of the loaded library */
+        std::string library;
+
+        /* the instruction set variant reported by the library,
+           e.g. "Haswell", or empty if it isn't known */
+        std::string variant;
+
+        /* the threading model the library was built with */
+        blas_threading threading;
+
+        /* the number of threads used by the calling thread, or 0 if
+           the library doesn't report it */
+        int threads;
+
+        /* why the requested backend isn't the one in use, or empty */
+        std::string error;
+    };
+
+    /*  Selects the BLAS library to load on first use of the solvers, and
+     *  optionally the path to load it from. The environment variables
+     *  SS_BLAS_BACKEND (one of auto, nehalem, haswell, skylakex, openblas,
+     *  blis or mkl) and SS_BLAS_LIBRARY are consulted when no backend has
+     *  been selected. If the library can't be loaded the bundled OpenBLAS
+     *  is used instead.
+     *
+     *    returns : false if a library has already been loaded
+     */
+    bool set_blas_backend(blas_backend backend, const std::string& path = "");
+
+    /* Loads BLAS if necessary, and describes the library in use. */
+    blas_info get_blas_info();
+
+    /*  Sets the number of threads used by BLAS routines in every thread,
+     *  where the library supports it. Sequential builds ignore this. While
+     *  a blas_thread_scope limits every thread, the count takes effect
+     *  when the last such scope ends.
+     */
+    void set_blas_threads(int threads);
+
+    /* The number of threads used by BLAS routines in the calling thread */
+    int get_blas_threads();
+
+    struct blas_op_profile
+    {
+        /*  the routine, e.g. "dgemv_t" for a transposed double gemv. Calls
+         *  taken by the built-in kernels for small operands end in "_small",
+         *  and products with the 16-bit, int8 or CSC storage of a sensing
+         *  matrix in "_half", "_int8" or "_csc", e.g. "sgemv_t_int8".
+         */
+        std::string op;
+
+        uint64_t calls;
+        double seconds;
+
+        /* estimated from the operand dimensions */
+        uint64_t flops;
+        uint64_t bytes;
+    };
+
+    /* true when the library was built with ${ss}_WITH_BLAS_PROFILING */
+    bool blas_profiling_enabled();
+
+    /*  The time spent in, and the work done by, each BLAS (and LAPACK)
+     *  routine called since the last reset. Empty when profiling is
+     *  disabled.
+     */
+    std::vector<blas_op_profile> get_blas_profile();
+
+    /* Clears the recorded profile. */
+    void reset_blas_profile();
+
+    /*  Limits the number of BLAS threads for the lifetime of the scope,
+     *  restoring the previous count on destruction. The limit applies only
+     *  to the calling thread when the library supports thread-local
+     *  settings (OpenBLAS 0.3.27+, MKL), and to every thread otherwise.
+     *  Such process-wide scopes may overlap on any threads: the count in
+     *  use before the first, or set by set_blas_threads since, is restored
+     *  when the last ends. The count is left alone if the library can't
+     *  report it, which limited() tells.
+     *
+     *  Solves run from the library's own worker threads are wrapped in a
+     *  single-threaded scope, so parallel solvers don't oversubscribe the
+     *  machine.
+     */
+    class blas_thread_scope
+    {
+      public:
+        explicit blas_thread_scope(int threads = 1);
+        ~blas_thread_scope();
+
+        blas_thread_scope(const blas_thread_scope&) = delete;
+        blas_thread_scope& operator=(const blas_thread_scope&) = delete;
+
+        /* whether the scope limits BLAS, i.e. the library's count is known */
+        bool limited() const { return _local || _global; }
+
+      private:
+        int _previous;
+        bool _local;
+        bool _global;
+    };
+}
@@ -27,7 +27,7 @@ namespace ss {
          */
         template <typename P, typename T>
         using solvable = decltype(
-            P::run(declval<typename P::template state_type<T>&>(),
+            P::run(declval<const typename P::template state_type<T>&>(),
                    declval<ndspan<T>>(), T{0}, std::size_t{0},
                    declval<ndspan<T>>()));
         
@@ -36,5 +36,27 @@ namespace ss {
         
         template <typename P, typename T>
         struct is_solver <P, T, xt::void_t<solvable<P, T>>> : std::true_type {};
+
+        /*  the type of the sensing matrix the state of policy P is constructed
+         *  from; ndspan<T, 2>, unless P defines matrix_type<T>
+         */
+        template <typename P, typename T, typename = void>
+        struct matrix_of { using type = ndspan<T, 2>; };
+
+        template <typename P, typename T>
+        struct matrix_of <P, T, xt::void_t<typename P::template matrix_type<T>>> {
+            using type = typename P::template matrix_type<T>;
+        };
+
+        /* the construction options of policy P, if it defines options_type */
+        struct no_options {};
+
+        template <typename P, typename = void>
+        struct options_of { using type = no_options; };
+
+        template <typename P>
+        struct options_of <P, xt::void_t<typename P::options_type>> {
+            using type = typename P::options_type;
+        };
     }
 }
\ No newline at end of file
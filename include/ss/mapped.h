@@ -0,0 +1,225 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include "ss/ndspan.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ss
+{
+    /* Memory mapped matrices ---------------------------------------------- */
+
+    enum class matrix_layout
+    {
+        row_major,
+        column_major
+    };
+
+    struct map_options
+    {
+        /* fault in every page when mapping (MAP_POPULATE) */
+        bool populate = false;
+
+        /* advise the kernel to back the mapping with transparent huge pages */
+        bool huge_pages = false;
+    };
+
+    /*  A read-only mapping of a whole file. Its pages are those of the
+     *  page cache, and so shared with every other process mapping the
+     *  same file; writing to them faults.
+     */
+    class mapped_file
+    {
+      public:
+        mapped_file() = default;
+        mapped_file(const std::string& path, const map_options& options = {});
+
+        mapped_file(mapped_file&&);
+        mapped_file& operator=(mapped_file&&);
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file();
+
+        const char* data() const { return _data; }
+        size_t size() const { return _size; }
+
+        /* false if the file could not be mapped, see error() */
+        explicit operator bool() const { return _data != nullptr; }
+
+        const std::string& error() const { return _error; }
+
+      private:
+        char*       _data = nullptr;
+        size_t      _size = 0;
+        std::string _error;
+    };
+
+    namespace detail
+    {
+        /* the element type, shape and data offset of a .npy file */
+        struct npy_header
+        {
+            /* e.g. "f4", empty if the header could not be read */
+            std::string dtype;
+
+            std::array<size_t, 2> shape;
+            bool fortran_order;
+            size_t offset;
+        };
+
+        /* parses the header of the 2-d .npy file mapped by `file` */
+        npy_header read_npy_header(const mapped_file& file, std::string& error);
+
+        /*  true if a rows x cols matrix of `element_size` byte elements
+         *  fits in `bytes`, without overflowing the element count
+         */
+        inline bool shape_fits(size_t rows, size_t cols, size_t element_size, size_t bytes)
+        {
+            if (cols != 0 && rows > SIZE_MAX / cols) { return false; }
+            return rows * cols <= bytes / element_size;
+        }
+
+        /* the .npy type code of T */
+        template <typename T> const char* npy_dtype();
+        template <> inline const char* npy_dtype<float>()  { return "f4"; }
+        template <> inline const char* npy_dtype<double>() { return "f8"; }
+    }
+
+    /*  the element type of the .npy file at `path`, e.g. "f4" for float or
+     *  "f8" for double; empty if the file can't be read
+     */
+    std::string npy_dtype(const std::string& path);
+
+    /*  A matrix read directly from a memory mapped file, viewed by an
+     *  ndspan which may be passed to any solver. The view is read-only,
+     *  and valid for the lifetime of the mapped_matrix.
+     */
+    template <typename T>
+    class mapped_matrix
+    {
+      public:
+        /* maps a 2-d .npy file of element type T, in either order */
+        static mapped_matrix npy(const std::string& path, const map_options& options = {});
+
+        /* maps a file of rows x cols elements of type T, starting at `offset` bytes */
+        static mapped_matrix raw(const std::string& path,
+            size_t rows, size_t cols,
+            matrix_layout layout = matrix_layout::row_major,
+            size_t offset = 0,
+            const map_options& options = {});
+
+        const ndspan<T, 2> view() const {
+            return as_span<2>(_data, _shape, _strides);
+        }
+
+        const std::array<size_t, 2>& shape() const { return _shape; }
+
+        /* false if the matrix could not be mapped, see error() */
+        explicit operator bool() const { return _data != nullptr; }
+
+        const std::string& error() const { return _error; }
+
+      private:
+        mapped_matrix() = default;
+
+        void fail(std::string error) {
+            _file = mapped_file{};
+            _data = nullptr;
+            _error = std::move(error);
+        }
+
+        mapped_file           _file;
+        const T*              _data = nullptr;
+        std::array<size_t, 2> _shape{ { 0, 0 } };
+        std::array<size_t, 2> _strides{ { 0, 0 } };
+        std::string           _error;
+    };
+
+    /* Definitions --------------------------------------------------------- */
+
+    template <typename T>
+    mapped_matrix<T> mapped_matrix<T>::npy(const std::string& path, const map_options& options)
+    {
+        mapped_matrix m;
+        m._file = mapped_file(path, options);
+
+        if (!m._file) {
+            m.fail(m._file.error());
+            return m;
+        }
+
+        std::string error;
+        const auto header = detail::read_npy_header(m._file, error);
+
+        if (!error.empty()) {
+            m.fail(path + ": " + error);
+            return m;
+        }
+        if (header.dtype != detail::npy_dtype<T>()) {
+            m.fail(path + ": element type " + header.dtype +
+                " is not the expected " + detail::npy_dtype<T>());
+            return m;
+        }
+
+        const size_t rows = header.shape[0], cols = header.shape[1];
+
+        if (!detail::shape_fits(rows, cols, sizeof(T), m._file.size() - header.offset)) {
+            m.fail(path + ": file is smaller than its shape");
+            return m;
+        }
+
+        m._data  = reinterpret_cast<const T*>(m._file.data() + header.offset);
+        m._shape = { rows, cols };
+        m._strides = header.fortran_order ?
+            std::array<size_t, 2>{ { 1, rows } } : std::array<size_t, 2>{ { cols, 1 } };
+
+        return m;
+    }
+
+    template <typename T>
+    mapped_matrix<T> mapped_matrix<T>::raw(const std::string& path,
+        size_t rows, size_t cols, matrix_layout layout, size_t offset, const map_options& options)
+    {
+        mapped_matrix m;
+        m._file = mapped_file(path, options);
+
+        if (!m._file) {
+            m.fail(m._file.error());
+            return m;
+        }
+        if (offset % alignof(T) != 0) {
+            m.fail(path + ": offset is not aligned to the element type");
+            return m;
+        }
+        if (m._file.size() < offset
+            || !detail::shape_fits(rows, cols, sizeof(T), m._file.size() - offset)) {
+            m.fail(path + ": file is smaller than the given shape");
+            return m;
+        }
+
+        m._data  = reinterpret_cast<const T*>(m._file.data() + offset);
+        m._shape = { rows, cols };
+        m._strides = layout == matrix_layout::column_major ?
+            std::array<size_t, 2>{ { 1, rows } } : std::array<size_t, 2>{ { cols, 1 } };
+
+        return m;
+    }
+}
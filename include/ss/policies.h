@@ -15,11 +15,73 @@ limitations under the License.  */
 #pragma once
 
 #include "ss/ndspan.h"
+#include "ss/sparse.h"
 #include <kernelpp/types.h>
 #include <xtl/xany.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace ss
 {
+    /*  Stops a solve before max_iterations or its tolerance is reached,
+     *  once the deadline has passed or cancel is set, whichever is first.
+     *  Both are checked once per iteration. A stopped solve returns its
+     *  current iterate, with truncated set in its report.
+     */
+    struct solve_control
+    {
+        using clock = std::chrono::steady_clock;
+
+        clock::time_point deadline = clock::time_point::max();
+
+        /* set from any thread to cancel the solve; may be null */
+        const std::atomic<bool>* cancel = nullptr;
+
+        /* a deadline of budget from now */
+        static solve_control within(clock::duration budget) {
+            solve_control control;
+            control.deadline = clock::now() + budget;
+            return control;
+        }
+
+        bool expired() const {
+            return (cancel && cancel->load(std::memory_order_relaxed))
+                || (deadline != clock::time_point::max() && clock::now() >= deadline);
+        }
+    };
+
+    namespace detail
+    {
+        /*  Makes control that of the solves run on the calling thread for
+         *  the lifetime of the scope, where the solver kernels find it.
+         */
+        class control_scope
+        {
+          public:
+            explicit control_scope(const solve_control& control);
+            ~control_scope();
+
+            control_scope(const control_scope&) = delete;
+            control_scope& operator=(const control_scope&) = delete;
+
+          private:
+            const solve_control* _previous;
+        };
+
+        /* the control of the calling thread, or null outside a control_scope */
+        const solve_control* current_control();
+
+        /* true when the solve on the calling thread should stop early */
+        inline bool expired(const solve_control* control) {
+            return control && control->expired();
+        }
+    }
+
     /* Homotopy ------------------------------------------------------------ */
 
     struct homotopy_report
@@ -29,23 +91,110 @@ namespace ss
 
         /* The solution error */
         double solution_error;
+
+        /* Whether the solve was stopped early by its solve_control. */
+        bool truncated = false;
     };
 
     /* Make std::variant happy */
     inline bool operator== (const homotopy_report&, const homotopy_report&) { return false; }
 
+    /* element storage of the sensing matrix read by the homotopy solver */
+    enum class homotopy_storage
+    {
+        /* the caller's matrix, in place */
+        native,
+        /* a column-major IEEE half precision copy */
+        fp16,
+        /* a column-major bfloat16 copy */
+        bf16
+    };
+
+    struct homotopy_options
+    {
+        /*  Keep a column-major copy of the sensing matrix, such that every
+         *  column the solver reads is contiguous. Otherwise the solver reads
+         *  the caller's matrix in place, whatever its layout.
+         */
+        bool column_major_copy = false;
+
+        /*  Keep a 16-bit copy of the sensing matrix instead, halving (or for
+         *  double, quartering) the memory read by each iteration. Products
+         *  are accumulated in float; the solution, residual and active set
+         *  inverse keep the precision of the solver.
+         */
+        homotopy_storage storage = homotopy_storage::native;
+
+        /*  Keep an int8 copy of the sensing matrix, scaled per column, for
+         *  estimating the correlations of each iteration. The columns where
+         *  the estimates can't decide the next step are re-evaluated from
+         *  the matrix itself, so the solution path is unchanged while most
+         *  of the matrix is read at a quarter of the bandwidth (or an eighth
+         *  for double). Ignored with 16-bit storage.
+         */
+        bool quantized_screening = false;
+    };
+
+    template <typename T>
+    struct homotopy_state
+    {
+        homotopy_state(const ndspan<T, 2> A, const homotopy_options& options = {});
+
+        homotopy_state(const homotopy_state&) = delete;
+        homotopy_state& operator=(const homotopy_state&) = delete;
+
+        /*  the state written by save() to `path`, if it was computed from a
+         *  matrix of the shape and checksum of A with the same options;
+         *  otherwise the state computed from A, with `error` set to the reason
+         */
+        static std::unique_ptr<homotopy_state> load(const ndspan<T, 2> A,
+            const std::string& path, std::string* error, const homotopy_options& options = {});
+
+        /* writes the copies of the sensing matrix to a state file */
+        bool save(const std::string& path, std::string* error) const;
+
+        /* storage of the column-major copy, if requested */
+        std::vector<T> copy;
+
+        /* storage of the 16-bit copy, if requested */
+        std::vector<uint16_t> reduced;
+        homotopy_storage storage;
+
+        /* storage of the int8 copy and its column scales, if requested */
+        std::vector<int8_t> quantized;
+        std::vector<float> scales;
+
+        /*  the sensing matrix read by the solver; with 16-bit storage only
+         *  its shape is kept, as the solver reads the 16-bit copy alone, so
+         *  the caller's matrix may be released once the state is constructed
+         */
+        const ndspan<T, 2> A;
+
+        /* the checksum of the sensing matrix, written with its state */
+        uint64_t checksum;
+
+      private:
+        /* restores the copies of a saved state */
+        homotopy_state(const ndspan<T, 2> A, const homotopy_options& options,
+            std::vector<T> copy, std::vector<uint16_t> reduced,
+            std::vector<int8_t> quantized, std::vector<float> scales, uint64_t checksum);
+
+        homotopy_options options;
+    };
+
     /* A solver policy which implements the homotopy method */
     struct homotopy_policy
     {
-        using report_type = homotopy_report;
+        using report_type  = homotopy_report;
+        using options_type = homotopy_options;
 
-        template <typename T> using state_type = const ndspan<T, 2>;
+        template <typename T> using state_type = homotopy_state<T>;
 
-        static kernelpp::maybe<homotopy_report> run(
-            state_type<float>&, const ndspan<float>, float, uint32_t, ndspan<float>);
+        static kernelpp::maybe<homotopy_report> run(const state_type<float>&,
+            const ndspan<float>, float, uint32_t, ndspan<float>);
 
-        static kernelpp::maybe<homotopy_report> run(
-            state_type<double>&, const ndspan<double>, double, uint32_t, ndspan<double>);
+        static kernelpp::maybe<homotopy_report> run(const state_type<double>&,
+            const ndspan<double>, double, uint32_t, ndspan<double>);
 
         homotopy_policy();
         homotopy_policy(homotopy_policy&&);
@@ -53,6 +202,23 @@ namespace ss
         ~homotopy_policy();
     };
 
+    /*  A solver policy which implements the homotopy method for a sparse
+     *  sensing matrix, held in CSC format
+     */
+    struct sparse_homotopy_policy
+    {
+        using report_type = homotopy_report;
+
+        template <typename T> using state_type  = const csc_span<T>;
+        template <typename T> using matrix_type = csc_span<T>;
+
+        static kernelpp::maybe<homotopy_report> run(const state_type<float>&,
+            const ndspan<float>, float, uint32_t, ndspan<float>);
+
+        static kernelpp::maybe<homotopy_report> run(const state_type<double>&,
+            const ndspan<double>, double, uint32_t, ndspan<double>);
+    };
+
     /* IRLS ---------------------------------------------------------------- */
 
     struct irls_report
@@ -68,12 +234,17 @@ namespace ss
          *  have a full cholesky decomposition.
          */
         bool spd_failure;
+
+        /* Whether the solve was stopped early by its solve_control. */
+        bool truncated = false;
     };
 
     /* make std::variant happy */
     inline bool operator== (const irls_report&, const irls_report&) { return false; }
 
-    /* */
+    /*  The state of an IRLS solver: the QR factorization of the sensing
+     *  matrix, in the precision of the solutions, and its explicit factors
+     */
     struct irls_state
     {
         irls_state(const ndspan<float, 2>);
@@ -81,7 +252,29 @@ namespace ss
 
         ~irls_state();
 
+        /*  the factorization written by save() to `path`, if it is of a
+         *  matrix of the shape and checksum of A; otherwise the
+         *  factorization of A, with `error` set to the reason
+         */
+        static std::unique_ptr<irls_state> load(
+            const ndspan<float, 2> A, const std::string& path, std::string* error);
+
+        static std::unique_ptr<irls_state> load(
+            const ndspan<double, 2> A, const std::string& path, std::string* error);
+
+        /* writes the factorization to a state file */
+        bool save(const std::string& path, std::string* error) const;
+
         xtl::any QR;
+
+        /* Q and R formed once from the factorization, and read by every solve */
+        xtl::any factors;
+
+        /* the checksum of the factorized matrix, written with its state */
+        uint64_t checksum;
+
+      private:
+        irls_state(xtl::any QR, uint64_t checksum);
     };
 
     /* A solver policy which implements the Iteratively Reweighted Least Squares method */
@@ -91,10 +284,60 @@ namespace ss
 
         template <typename> using state_type = irls_state;
 
-        static kernelpp::maybe<irls_report> run(
-            state_type<float>&, const ndspan<float>, float, uint32_t, ndspan<float>);
+        static kernelpp::maybe<irls_report> run(const state_type<float>&,
+            const ndspan<float>, float, uint32_t, ndspan<float>);
+
+        static kernelpp::maybe<irls_report> run(const state_type<double>&,
+            const ndspan<double>, double, uint32_t, ndspan<double>);
+    };
+
+    /*  The state of a mixed precision IRLS solver: the single precision QR
+     *  factorization of the sensing matrix, and its orthogonal factor
+     *  refined in double precision
+     */
+    struct irls_mixed_state
+    {
+        irls_mixed_state(const ndspan<float, 2>);
+
+        ~irls_mixed_state();
+
+        /* as irls_state::load */
+        static std::unique_ptr<irls_mixed_state> load(
+            const ndspan<float, 2> A, const std::string& path, std::string* error);
+
+        /* writes the factorization to a state file */
+        bool save(const std::string& path, std::string* error) const;
+
+        /* non-owning view of the sensing matrix */
+        const ndspan<float, 2> A;
+
+        xtl::any QR;
+
+        /*  the orthogonal factor of A in double precision, formed once from
+         *  the factorization, and read by every solve
+         */
+        xtl::any Q;
+
+      private:
+        irls_mixed_state(const ndspan<float, 2> A, xtl::any QR);
+    };
+
+    /*  A solver policy which implements IRLS with single precision storage
+     *  and factorization of the sensing matrix, and double precision
+     *  solutions by iterative refinement of each least squares solve. The
+     *  Newton step uses an orthogonal factor of A reorthogonalized in double
+     *  precision, so solutions agree with irls<double> of the same matrix
+     *  to double precision, provided the refinement converges, i.e. the
+     *  condition number of A is well below 1 / epsilon of float.
+     */
+    struct irls_mixed_policy
+    {
+        using report_type = irls_report;
+
+        template <typename> using state_type  = irls_mixed_state;
+        template <typename> using matrix_type = ndspan<float, 2>;
 
-        static kernelpp::maybe<irls_report> run(
-            state_type<double>&, const ndspan<double>, double, uint32_t, ndspan<double>);
+        static kernelpp::maybe<irls_report> run(const state_type<double>&,
+            const ndspan<double>, double, uint32_t, ndspan<double>);
     };
 }
\ No newline at end of file
@@ -0,0 +1,690 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include "ss/blas.h"
+#include "ss/fwd.h"
+#include "ss/ndspan.h"
+#include "ss/policies.h"
+
+#include <kernelpp/types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ss
+{
+    namespace detail
+    {
+        /*  A bounded multi-producer, multi-consumer queue, where each cell
+         *  carries a sequence number which tells producers and consumers
+         *  whether it is free or full (D. Vyukov). Neither operation takes
+         *  a lock; each fails instead of waiting when the queue is full or
+         *  empty.
+         */
+        template <typename T>
+        class mpmc_queue
+        {
+          public:
+            /* capacity is rounded up to a power of two */
+            explicit mpmc_queue(size_t capacity)
+            {
+                size_t n = 2;
+                while (n < capacity) { n *= 2; }
+
+                _cells.reset(new cell[n]);
+                _mask = n - 1;
+
+                for (size_t i = 0; i < n; i++) {
+                    _cells[i].seq.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            mpmc_queue(const mpmc_queue&) = delete;
+            mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+            /* moves from value only when it is queued */
+            bool try_push(T&& value)
+            {
+                size_t pos = _tail.load(std::memory_order_relaxed);
+                for (;;) {
+                    cell& c = _cells[pos & _mask];
+                    const size_t seq = c.seq.load(std::memory_order_acquire);
+                    const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+
+                    if (diff == 0) {
+                        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            c.value = std::move(value);
+                            c.seq.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) {
+                        return false;
+                    }
+                    else {
+                        pos = _tail.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            bool try_pop(T& value)
+            {
+                size_t pos = _head.load(std::memory_order_relaxed);
+                for (;;) {
+                    cell& c = _cells[pos & _mask];
+                    const size_t seq = c.seq.load(std::memory_order_acquire);
+                    const intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+
+                    if (diff == 0) {
+                        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            value = std::move(c.value);
+                            c.seq.store(pos + _mask + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) {
+                        return false;
+                    }
+                    else {
+                        pos = _head.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+          private:
+            struct cell
+            {
+                std::atomic<size_t> seq;
+                T value;
+            };
+
+            std::unique_ptr<cell[]> _cells;
+            size_t _mask;
+
+            /* producers and consumers on separate cache lines */
+            char _pad0[64];
+            std::atomic<size_t> _tail{ 0 };
+            char _pad1[64];
+            std::atomic<size_t> _head{ 0 };
+            char _pad2[64];
+        };
+
+        /*  Splits the indices [0, n) between a number of owners, each of
+         *  which takes indices from the front of its own range, and when
+         *  that is empty steals the back half of another's. Each range is
+         *  a single atomic word, so neither taking nor stealing locks.
+         */
+        class work_ranges
+        {
+          public:
+            work_ranges(uint32_t n, size_t owners)
+                : _ranges(new range[owners]), _owners(owners)
+            {
+                for (size_t i = 0; i < owners; i++) {
+                    _ranges[i].bounds.store(
+                        pack(uint32_t(n * i / owners), uint32_t(n * (i + 1) / owners)),
+                        std::memory_order_relaxed);
+                }
+            }
+
+            /* the next index for owner, or false when every range is empty */
+            bool next(size_t owner, uint32_t& index)
+            {
+                return take(owner, index) || steal(owner, index);
+            }
+
+          private:
+            /* on separate cache lines */
+            struct range
+            {
+                std::atomic<uint64_t> bounds;
+                char _pad[64 - sizeof(std::atomic<uint64_t>)];
+            };
+
+            static uint64_t pack(uint32_t begin, uint32_t end) {
+                return uint64_t(begin) << 32 | end;
+            }
+            static uint32_t begin_of(uint64_t r) { return uint32_t(r >> 32); }
+            static uint32_t end_of(uint64_t r)   { return uint32_t(r); }
+
+            bool take(size_t owner, uint32_t& index)
+            {
+                auto& bounds = _ranges[owner].bounds;
+                uint64_t r = bounds.load(std::memory_order_acquire);
+
+                while (begin_of(r) < end_of(r)) {
+                    if (bounds.compare_exchange_weak(r, pack(begin_of(r) + 1, end_of(r)),
+                            std::memory_order_acq_rel)) {
+                        index = begin_of(r);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool steal(size_t owner, uint32_t& index)
+            {
+                for (size_t k = 1; k < _owners; k++)
+                {
+                    auto& bounds = _ranges[(owner + k) % _owners].bounds;
+                    uint64_t r = bounds.load(std::memory_order_acquire);
+
+                    while (begin_of(r) < end_of(r)) {
+                        const uint32_t mid = begin_of(r) + (end_of(r) - begin_of(r)) / 2;
+
+                        if (bounds.compare_exchange_weak(r, pack(begin_of(r), mid),
+                                std::memory_order_acq_rel)) {
+                            /* keep the rest of [mid, end) as our own range */
+                            index = mid;
+                            _ranges[owner].bounds.store(
+                                pack(mid + 1, end_of(r)), std::memory_order_release);
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            std::unique_ptr<range[]> _ranges;
+            size_t _owners;
+        };
+
+        /*  Pins the calling thread to the given cpu. Returns false where
+         *  affinity is unsupported, or the cpu is unavailable.
+         */
+        bool pin_thread(int cpu);
+
+        /* Pins the calling thread to any of the given cpus. */
+        bool pin_thread(const std::vector<int>& cpus);
+
+        struct numa_node
+        {
+            int id;
+            std::vector<int> cpus;
+        };
+
+        /*  The NUMA nodes with cpus, from /sys/devices/system/node, or none
+         *  where the topology is unknown.
+         */
+        std::vector<numa_node> numa_nodes();
+
+        /*  Allocates bytes on the given NUMA node, with numa_alloc_onnode
+         *  when libnuma can be loaded. Otherwise the memory is aligned and
+         *  placed by the kernel on first touch, i.e. on the node of the
+         *  thread which first writes it.
+         *
+         *  throws std::bad_alloc on failure
+         */
+        void* numa_allocate(size_t bytes, int node);
+
+        void numa_deallocate(void* p, size_t bytes) noexcept;
+
+        /* a copy of a matrix on a NUMA node, and the state computed from it */
+        template <typename State>
+        struct replica
+        {
+            std::vector<int> cpus;
+            std::shared_ptr<void> matrix;
+            std::shared_ptr<const State> state;
+        };
+
+        /*  Copies A to each of the given nodes, e.g. numa_nodes(), and
+         *  computes its state from each copy with make. Returns none for
+         *  fewer than two nodes, or a sparse matrix.
+         */
+        template <typename State, typename E, typename Make>
+        std::vector<replica<State>> replicate(
+            const ndspan<E, 2> A, const std::vector<numa_node>& nodes, Make make)
+        {
+            if (nodes.size() < 2) { return {}; }
+
+            const size_t m = A.shape()[0], n = A.shape()[1];
+            std::vector<replica<State>> replicas(nodes.size());
+
+            /*  each copy is written, and its state computed, by a thread on its
+                node, so memory placed on first touch is local to the node too */
+            std::vector<std::thread> threads;
+            std::exception_ptr error;
+            std::mutex mutex;
+
+            for (size_t node = 0; node < nodes.size(); node++) {
+                threads.emplace_back([&, node] {
+                    replica<State>& r = replicas[node];
+                    r.cpus = nodes[node].cpus;
+
+                    try {
+                        pin_thread(r.cpus);
+                        blas_thread_scope scope(1);
+
+                        const size_t bytes = m * n * sizeof(E);
+                        E* copy = static_cast<E*>(numa_allocate(bytes, nodes[node].id));
+                        r.matrix.reset(copy, [bytes](void* p) { numa_deallocate(p, bytes); });
+
+                        for (size_t i = 0; i < m; i++) {
+                            for (size_t j = 0; j < n; j++) { copy[i * n + j] = A(i, j); }
+                        }
+                        r.state = make(as_span<2>(copy, { m, n }));
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        error = std::current_exception();
+                    }
+                });
+            }
+            for (auto& t : threads) { t.join(); }
+
+            if (error) { std::rethrow_exception(error); }
+            return replicas;
+        }
+
+        template <typename State, typename E, typename Make>
+        std::vector<replica<State>> replicate(
+            const csc_span<E>&, const std::vector<numa_node>&, Make)
+        {
+            return {};
+        }
+    }
+
+    struct pool_options
+    {
+        /* the number of worker threads, or 0 for one per hardware thread */
+        unsigned workers = 0;
+
+        /*  the cpu each worker is pinned to, in turn, such that worker i
+         *  runs on cpus[i % cpus.size()]; empty to leave them unpinned
+         */
+        std::vector<int> cpus;
+
+        /*  the number of solves which may be queued, rounded up to a power
+         *  of two; submitting to a full queue waits for a free slot
+         */
+        size_t queue_capacity = 1024;
+
+        /*  Copies a dense sensing matrix to each NUMA node, and computes its
+         *  state there from the copy, so each worker reads memory local to
+         *  its node. Workers are spread over the nodes, and pinned to the
+         *  cpus of theirs unless cpus is given, in which case each worker
+         *  uses the copy of its cpu's node.
+         *
+         *  Ignored with a single node, an unknown topology, a sparse matrix,
+         *  or a pool constructed from an existing state.
+         */
+        bool numa_replicas = false;
+    };
+
+    /*  Solves signals submitted from any thread on a set of worker threads,
+     *  which share one copy of the state precomputed from the sensing
+     *  matrix (e.g. the QR factorization of IRLS). The state is only read
+     *  by a solve, so no solve waits for another. With
+     *  pool_options::numa_replicas, each NUMA node has its own copy of the
+     *  matrix and state.
+     *
+     *  Each worker limits BLAS to a single thread with blas_thread_scope.
+     *  Where the library has no thread-local setting, that limits every
+     *  thread until the last worker exits, which restores the count.
+     */
+    template <typename T, typename SolverPolicy>
+    class solver_pool
+    {
+      public:
+        using report_type   = typename SolverPolicy::report_type;
+        using state_type    = typename SolverPolicy::template state_type<T>;
+        using matrix_type   = typename detail::matrix_of<SolverPolicy, T>::type;
+        using options_type  = typename detail::options_of<SolverPolicy>::type;
+        using solve_result  = kernelpp::maybe<report_type>;
+        using callback_type = std::function<void(solve_result)>;
+
+        /* A : non-owning view of a sensing matrix */
+        explicit solver_pool(const matrix_type A, const pool_options& pool = {});
+
+        /* options : policy specific options, e.g. homotopy_options */
+        solver_pool(const matrix_type A, const options_type& options, const pool_options& pool = {});
+
+        /* state : the state of a solver, see solver::state() */
+        explicit solver_pool(
+            std::shared_ptr<const state_type> state, const pool_options& pool = {});
+
+        /* completes every submitted solve, then stops the workers */
+        ~solver_pool();
+
+        solver_pool(const solver_pool&) = delete;
+        solver_pool& operator=(const solver_pool&) = delete;
+
+        /*  Queues a solve, as solver::solve. y and x must remain valid
+         *  until the returned future is ready.
+         */
+        std::future<solve_result> submit(
+            const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x);
+
+        /*  As submit, but the solve stops early when control expires, as
+         *  solver::solve. A deadline includes the time spent queued.
+         */
+        std::future<solve_result> submit(
+            const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x,
+            const solve_control& control);
+
+        /*  Queues a solve, and calls done with its result on the worker
+         *  which solved it. done must not throw.
+         */
+        void submit(const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x,
+            callback_type done);
+
+        /*  Solves the signals in the rows of Y into the rows of X on every
+         *  worker, and waits for them to complete. The rows are divided
+         *  evenly between the workers, and a worker which runs out steals
+         *  half of the rows another has left, so a few slow solves don't
+         *  leave the other workers idle.
+         *
+         *  Must not be called from a callback of the same pool.
+         *
+         *    returns : the result of each solve, in the order of the rows
+         */
+        std::vector<solve_result> solve_batch(
+            const ndspan<T, 2> Y, T tol, std::uint32_t max_iterations, ndspan<T, 2> X);
+
+        size_t workers() const { return _workers.size(); }
+
+      private:
+        using job_type = std::function<void(const state_type&)>;
+
+        using replica = detail::replica<state_type>;
+
+        void start(const pool_options& pool);
+        void enqueue(job_type job);
+        void work(const state_type* state, std::vector<int> cpus);
+
+        std::shared_ptr<const state_type> _state;
+        std::vector<replica> _replicas;
+        detail::mpmc_queue<job_type> _queue;
+
+        /* queued jobs, and the workers waiting for one */
+        std::atomic<size_t> _pending{ 0 };
+        std::atomic<size_t> _sleeping{ 0 };
+        std::atomic<bool>   _stop{ false };
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::vector<std::thread> _workers;
+    };
+
+    /* Pool types ---------------------------------------------------------- */
+
+    template <typename T>
+    using homotopy_pool = solver_pool<T, homotopy_policy>;
+
+    template <typename T>
+    using sparse_homotopy_pool = solver_pool<T, sparse_homotopy_policy>;
+
+    template <typename T>
+    using irls_pool = solver_pool<T, irls_policy>;
+
+    template <typename T>
+    using irls_mixed_pool = solver_pool<T, irls_mixed_policy>;
+
+
+    /* Definitions --------------------------------------------------------- */
+
+    template <typename T, typename S>
+    solver_pool<T, S>::solver_pool(const matrix_type A, const pool_options& pool)
+        : _queue(pool.queue_capacity)
+    {
+        static_assert(
+            detail::is_solver<S, T>::value,
+            "The specified solver policy does not implment the required interface");
+
+        if (pool.numa_replicas) {
+            _replicas = detail::replicate<state_type>(A, detail::numa_nodes(),
+                [](const matrix_type local) {
+                    return std::make_shared<state_type>(local);
+                });
+        }
+        if (_replicas.empty()) { _state = std::make_shared<state_type>(A); }
+
+        start(pool);
+    }
+
+    template <typename T, typename S>
+    solver_pool<T, S>::solver_pool(
+            const matrix_type A, const options_type& options, const pool_options& pool)
+        : _queue(pool.queue_capacity)
+    {
+        static_assert(
+            detail::is_solver<S, T>::value,
+            "The specified solver policy does not implment the required interface");
+
+        if (pool.numa_replicas) {
+            _replicas = detail::replicate<state_type>(A, detail::numa_nodes(),
+                [&options](const matrix_type local) {
+                    return std::make_shared<state_type>(local, options);
+                });
+        }
+        if (_replicas.empty()) { _state = std::make_shared<state_type>(A, options); }
+
+        start(pool);
+    }
+
+    template <typename T, typename S>
+    solver_pool<T, S>::solver_pool(
+            std::shared_ptr<const state_type> state, const pool_options& pool)
+        : _state(std::move(state))
+        , _queue(pool.queue_capacity)
+    {
+        static_assert(
+            detail::is_solver<S, T>::value,
+            "The specified solver policy does not implment the required interface");
+
+        start(pool);
+    }
+
+    template <typename T, typename S>
+    solver_pool<T, S>::~solver_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+
+        for (auto& worker : _workers) { worker.join(); }
+    }
+
+    template <typename T, typename S>
+    void solver_pool<T, S>::start(const pool_options& pool)
+    {
+        size_t n = pool.workers;
+        if (n == 0) { n = std::max(1u, std::thread::hardware_concurrency()); }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            std::vector<int> cpus;
+            if (!pool.cpus.empty()) { cpus = { pool.cpus[i % pool.cpus.size()] }; }
+
+            const state_type* state = _state.get();
+            if (!_replicas.empty())
+            {
+                /* the node of the given cpu, or the next node in turn */
+                size_t node = i % _replicas.size();
+                for (size_t k = 0; !cpus.empty() && k < _replicas.size(); k++) {
+                    const auto& local = _replicas[k].cpus;
+                    if (std::find(local.begin(), local.end(), cpus[0]) != local.end()) { node = k; }
+                }
+
+                if (cpus.empty()) { cpus = _replicas[node].cpus; }
+                state = _replicas[node].state.get();
+            }
+
+            _workers.emplace_back(&solver_pool::work, this, state, std::move(cpus));
+        }
+    }
+
+    template <typename T, typename S>
+    void solver_pool<T, S>::enqueue(job_type job)
+    {
+        while (!_queue.try_push(std::move(job))) {
+            std::this_thread::yield();
+        }
+
+        /*  a worker which found no job increments _sleeping before waiting
+            for _pending, so one of the two sees the other's update */
+        _pending.fetch_add(1);
+        if (_sleeping.load() > 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _wake.notify_one();
+        }
+    }
+
+    template <typename T, typename S>
+    void solver_pool<T, S>::work(const state_type* state, std::vector<int> cpus)
+    {
+        if (!cpus.empty()) { detail::pin_thread(cpus); }
+        blas_thread_scope scope(1);
+
+        job_type job;
+        for (;;)
+        {
+            if (_queue.try_pop(job)) {
+                _pending.fetch_sub(1);
+                job(*state);
+                job = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_pending.load() == 0 && _stop) { return; }
+
+            _sleeping.fetch_add(1);
+            _wake.wait(lock, [this] { return _pending.load() > 0 || _stop; });
+            _sleeping.fetch_sub(1);
+        }
+    }
+
+    template <typename T, typename S>
+    std::future<typename solver_pool<T, S>::solve_result> solver_pool<T, S>::submit(
+        const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x)
+    {
+        auto promise = std::make_shared<std::promise<solve_result>>();
+        auto result = promise->get_future();
+
+        enqueue([promise, y, tol, max_iterations, x](const state_type& state) {
+            try {
+                promise->set_value(S::run(state, y, tol, max_iterations, x));
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+
+        return result;
+    }
+
+    template <typename T, typename S>
+    std::future<typename solver_pool<T, S>::solve_result> solver_pool<T, S>::submit(
+        const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x,
+        const solve_control& control)
+    {
+        auto promise = std::make_shared<std::promise<solve_result>>();
+        auto result = promise->get_future();
+
+        enqueue([promise, y, tol, max_iterations, x, control](
+                const state_type& state) {
+            detail::control_scope scope(control);
+            try {
+                promise->set_value(S::run(state, y, tol, max_iterations, x));
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+
+        return result;
+    }
+
+    template <typename T, typename S>
+    std::vector<typename solver_pool<T, S>::solve_result> solver_pool<T, S>::solve_batch(
+        const ndspan<T, 2> Y, T tol, std::uint32_t max_iterations, ndspan<T, 2> X)
+    {
+        const uint32_t n = uint32_t(Y.shape()[0]);
+        std::vector<solve_result> results(n, solve_result(kernelpp::error_code::KERNEL_FAILED));
+        if (n == 0) { return results; }
+
+        struct batch
+        {
+            batch(uint32_t n, size_t owners) : ranges(n, owners), remaining(n) {}
+
+            detail::work_ranges ranges;
+            std::atomic<size_t> owners{ 0 };
+            std::atomic<uint32_t> remaining;
+
+            std::mutex mutex;
+            std::exception_ptr error;
+            std::promise<void> done;
+        };
+
+        const size_t owners = std::min<size_t>(workers(), n);
+        auto b = std::make_shared<batch>(n, owners);
+        auto complete = b->done.get_future();
+
+        solve_result* out = results.data();
+
+        for (size_t i = 0; i < owners; i++) {
+            enqueue([b, out, Y, tol, max_iterations, X](const state_type& state) {
+                const size_t owner = b->owners.fetch_add(1);
+                const size_t m = Y.shape()[1], sy = Y.strides()[1];
+                const size_t k = X.shape()[1], sx = X.strides()[1];
+
+                uint32_t row;
+                while (b->ranges.next(owner, row))
+                {
+                    try {
+                        out[row] = S::run(state,
+                            as_span<1>(&Y(row, 0), { m }, { sy }), tol, max_iterations,
+                            as_span<1>(&X(row, 0), { k }, { sx }));
+                    }
+                    catch (...) {
+                        std::lock_guard<std::mutex> lock(b->mutex);
+                        if (!b->error) { b->error = std::current_exception(); }
+                    }
+                    if (b->remaining.fetch_sub(1) == 1) { b->done.set_value(); }
+                }
+            });
+        }
+
+        complete.wait();
+        if (b->error) { std::rethrow_exception(b->error); }
+
+        return results;
+    }
+
+    template <typename T, typename S>
+    void solver_pool<T, S>::submit(
+        const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x,
+        callback_type done)
+    {
+        enqueue([done, y, tol, max_iterations, x](const state_type& state) {
+            done(S::run(state, y, tol, max_iterations, x));
+        });
+    }
+}
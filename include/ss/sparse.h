@@ -0,0 +1,77 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace ss
+{
+    /*
+     *  A non-owning view of an m x n sparse matrix in compressed sparse
+     *  column (CSC) format, i.e. the nonzeros of column j are
+     *
+     *    values[k], at row row_indices[k], for k in [col_ptr[j], col_ptr[j + 1])
+     *
+     *  with an optional compressed sparse row (CSR) mirror of the same
+     *  matrix, which is used for products with A when it is present.
+     */
+    template <typename T>
+    struct csc_span
+    {
+        using value_type = T;
+        using index_type = int32_t;
+
+        std::array<size_t, 2> dims;
+
+        T*                values;
+        const index_type* row_indices;
+        const index_type* col_ptr;
+
+        /* the CSR mirror, or null */
+        T*                row_values;
+        const index_type* col_indices;
+        const index_type* row_ptr;
+
+        const std::array<size_t, 2>& shape() const { return dims; }
+
+        size_t nnz() const { return size_t(col_ptr[dims[1]] - col_ptr[0]); }
+
+        bool has_csr() const { return row_values != nullptr; }
+    };
+
+    /*
+     *  constructs a view of an m x n CSC matrix
+     */
+    template <typename T>
+    csc_span<T> as_csc_span(size_t m, size_t n,
+        T* values, const int32_t* row_indices, const int32_t* col_ptr)
+    {
+        return { { m, n }, values, row_indices, col_ptr, nullptr, nullptr, nullptr };
+    }
+
+    /*
+     *  constructs a view of an m x n CSC matrix, with a CSR mirror
+     *  holding the same nonzeros
+     */
+    template <typename T>
+    csc_span<T> as_csc_span(size_t m, size_t n,
+        T* values, const int32_t* row_indices, const int32_t* col_ptr,
+        T* row_values, const int32_t* col_indices, const int32_t* row_ptr)
+    {
+        return { { m, n }, values, row_indices, col_ptr, row_values, col_indices, row_ptr };
+    }
+}
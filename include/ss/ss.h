@@ -14,12 +14,20 @@ limitations under the License.  */
 
 #pragma once
 
+#include "ss/blas.h"
 #include "ss/fwd.h"
+#include "ss/mapped.h"
 #include "ss/ndspan.h"
 #include "ss/policies.h"
+#include "ss/pool.h"
+#include "ss/sparse.h"
+#include "ss/stream.h"
 
 #include <kernelpp/types.h>
 
+#include <memory>
+#include <string>
+
 namespace ss
 {
     /* Solver base --------------------------------------------------------- */
@@ -29,10 +37,22 @@ namespace ss
     {   
         using report_type  = typename SolverPolicy::report_type;
         using state_type   = typename SolverPolicy::template state_type<T>;
+        using matrix_type  = typename detail::matrix_of<SolverPolicy, T>::type;
+        using options_type = typename detail::options_of<SolverPolicy>::type;
         using solve_result = kernelpp::maybe<report_type>;
 
         /* A : non-owning view of a sensing matrix */
-        solver(const ndspan<T, 2> A);
+        solver(const matrix_type A);
+
+        /*  A : non-owning view of a sensing matrix
+         *  options : policy specific options, e.g. homotopy_options
+         */
+        solver(const matrix_type A, const options_type& options);
+
+        /*  Shares the state precomputed by another solver, e.g. to give
+         *  each thread its own solver without factorizing A again.
+         */
+        explicit solver(std::shared_ptr<const state_type> state);
 
         ~solver() = default;
         
@@ -46,13 +66,51 @@ namespace ss
          *                     of length n
          *
          *    returns : an instance of report_type, or an error
+         *
+         *  A solver holds per-solve scratch, so must not solve on two
+         *  threads at once; solvers sharing a state may, provided the
+         *  sensing matrix is not modified meanwhile.
          */
         solve_result solve(const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x);
 
-        solver(solver<T, SolverPolicy>&& other) : m{ std::move(other.m) } {}
+        /*  As solve, but stops early when control expires, returning the
+         *  current iterate with truncated set in the report, e.g.
+         *
+         *    solver.solve(y, tol, n, x, solve_control::within(std::chrono::milliseconds(5)));
+         */
+        solve_result solve(const ndspan<T> y, T tol, std::uint32_t max_iterations, ndspan<T> x,
+            const solve_control& control);
+
+        /*  Writes the state precomputed from the sensing matrix, e.g. its
+         *  QR factorization, to a versioned binary file.
+         *
+         *    returns : false on failure, with the reason in error
+         */
+        bool save(const std::string& path, std::string* error = nullptr) const;
+
+        /*  Reloads the state written by save() from a memory mapped file,
+         *  instead of computing it again. If the file can't be used, e.g. it
+         *  holds the state of another solver, of another matrix, or with
+         *  other options, the state is computed from A and error set to the
+         *  reason.
+         *
+         *    A : the sensing matrix the state was computed from; its shape
+         *        and a checksum of its elements, one pass over A, are checked
+         */
+        static solver load(const matrix_type A,
+            const std::string& path, std::string* error = nullptr);
+
+        static solver load(const matrix_type A, const options_type& options,
+            const std::string& path, std::string* error = nullptr);
+
+        /* the immutable state, which may be shared with other solvers */
+        std::shared_ptr<const state_type> state() const { return m; }
+
+        solver(solver<T, SolverPolicy>&& other)
+            : m{ std::move(other.m) } {}
 
       private:
-        std::unique_ptr<state_type> m;
+        std::shared_ptr<const state_type> m;
     };
 
     /* Solver types  ------------------------------------------------------- */
@@ -60,9 +118,19 @@ namespace ss
     template <typename T>
     using homotopy = solver<T, homotopy_policy>;
 
+    /* homotopy with a sparse (CSC) sensing matrix */
+    template <typename T>
+    using sparse_homotopy = solver<T, sparse_homotopy_policy>;
+
     template <typename T>
     using irls = solver<T, irls_policy>;
 
+    /*  IRLS with a single precision sensing matrix and
+     *  double precision solutions, i.e. irls_mixed<double>
+     */
+    template <typename T>
+    using irls_mixed = solver<T, irls_mixed_policy>;
+
 
     /* Utilities ----------------------------------------------------------- */
 
@@ -82,6 +150,46 @@ namespace ss
     void reconstruct_signal(
         const ndspan<double, 2> A, const ndspan<double> x, ndspan<double> y);
 
+    void reconstruct_signal(
+        const csc_span<float> A, const ndspan<float> x, ndspan<float> y);
+
+    void reconstruct_signal(
+        const csc_span<double> A, const ndspan<double> x, ndspan<double> y);
+
+
+    /*  computes || y - A delta_i(x) ||_2 for each class i
+     *  The residual of a signal for each class of the columns of A, as
+     *  used to classify a signal by its sparse representation (e.g. the
+     *  face recognition of Yang et al.), where delta_i(x) keeps the
+     *  elements of x whose column is labelled i. Only the nonzero
+     *  elements of x are read, so all classes together cost about one
+     *  gemv of the columns of those elements, rather than a
+     *  reconstruct_signal per class.
+     *
+     *          A : input matrix A used to construct x
+     *     labels : the class of each column of A, of length n
+     *          y : the signal, of length m
+     *          x : the sparse representation vector, of length n
+     *  residuals : the output residual of each class, of length
+     *              greater than every label
+     */
+    void class_residuals(const ndspan<float, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<float> y, const ndspan<float> x, ndspan<float> residuals);
+
+    void class_residuals(const ndspan<double, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<double> y, const ndspan<double> x, ndspan<double> residuals);
+
+    /*  As above, for a batch of signals in the rows of Y and their
+     *  representations in the rows of X, with the residuals of each
+     *  signal in a row of residuals. Each class is a single gemm over
+     *  its columns which are nonzero in any row of X.
+     */
+    void class_residuals(const ndspan<float, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<float, 2> Y, const ndspan<float, 2> X, ndspan<float, 2> residuals);
+
+    void class_residuals(const ndspan<double, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<double, 2> Y, const ndspan<double, 2> X, ndspan<double, 2> residuals);
+
 
     /*  Normalizes the columns of a given matrix in-place according
      *  to the L1-norm of each column.
@@ -92,18 +200,61 @@ namespace ss
 
     void norm_l1(ndspan<double, 2> A);
 
+    /* also normalizes the CSR mirror of A, if present */
+    void norm_l1(csc_span<float> A);
+
+    void norm_l1(csc_span<double> A);
+
 
     /* Definitions --------------------------------------------------------- */
     
     template <typename T, typename S>
-    solver<T, S>::solver(const ndspan<T, 2> A)
-        : m(std::make_unique<state_type>(A))
+    solver<T, S>::solver(const matrix_type A)
+        : m(std::make_shared<state_type>(A))
+    {
+        static_assert(
+            detail::is_solver<S, T>::value,
+            "The specified solver policy does not implment the required interface");
+    }
+
+    template <typename T, typename S>
+    solver<T, S>::solver(const matrix_type A, const options_type& options)
+        : m(std::make_shared<state_type>(A, options))
+    {
+        static_assert(
+            detail::is_solver<S, T>::value,
+            "The specified solver policy does not implment the required interface");
+    }
+
+    template <typename T, typename S>
+    solver<T, S>::solver(std::shared_ptr<const state_type> state)
+        : m(std::move(state))
     {
         static_assert(
             detail::is_solver<S, T>::value,
             "The specified solver policy does not implment the required interface");
     }
 
+    template <typename T, typename S>
+    bool solver<T, S>::save(const std::string& path, std::string* error) const {
+        return m->save(path, error);
+    }
+
+    template <typename T, typename S>
+    solver<T, S> solver<T, S>::load(
+        const matrix_type A, const std::string& path, std::string* error)
+    {
+        return solver(std::shared_ptr<const state_type>(state_type::load(A, path, error)));
+    }
+
+    template <typename T, typename S>
+    solver<T, S> solver<T, S>::load(const matrix_type A,
+        const options_type& options, const std::string& path, std::string* error)
+    {
+        return solver(std::shared_ptr<const state_type>(
+            state_type::load(A, path, error, options)));
+    }
+
     template <typename T, typename S>
     typename solver<T, S>::solve_result solver<T, S>::solve(
         const ndspan<T>     y,
@@ -113,4 +264,16 @@ namespace ss
     {
         return S::run(*m, y, tolerance, max_iterations, x);
     }
+
+    template <typename T, typename S>
+    typename solver<T, S>::solve_result solver<T, S>::solve(
+        const ndspan<T>     y,
+              T             tolerance,
+              std::uint32_t max_iterations,
+              ndspan<T>     x,
+        const solve_control& control)
+    {
+        detail::control_scope scope(control);
+        return S::run(*m, y, tolerance, max_iterations, x);
+    }
 }
\ No newline at end of file
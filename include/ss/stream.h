@@ -0,0 +1,87 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include "ss/ndspan.h"
+#include "ss/policies.h"
+
+#include <kernelpp/types.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ss
+{
+    /*  Solves a signal which arrives a few samples at a time, i.e. the last
+     *  m samples of a time series, where m is the number of rows of A.
+     *
+     *  The window is a ring: sample t is held in row t mod m, so a new
+     *  sample replaces the oldest, and only the rows of A it touches are
+     *  used to update the correlations of the previous solution. Each
+     *  solve starts from the active set of the previous one, following
+     *  the solution from the old window to the new, and falls back to a
+     *  solve from zero when that fails or isn't within tolerance.
+     *
+     *  Solutions are written to a ring of capacity solutions, which one
+     *  other thread may pop while samples are pushed; when it is full the
+     *  newest solution is dropped, and counted in dropped().
+     */
+    template <typename T>
+    class homotopy_stream
+    {
+      public:
+        using solve_result = kernelpp::maybe<homotopy_report>;
+
+        /*  A : non-owning view of a sensing matrix of n columns, and m rows
+         *      ordered by ring position, i.e. row r is matched with the
+         *      sample held in row r of the window, t mod m = r
+         *  tolerance, max_iterations : as solver::solve
+         *  capacity : the number of solutions held until they are popped
+         *
+         *  The window starts as zeros.
+         */
+        homotopy_stream(const ndspan<T, 2> A,
+            T tolerance, std::uint32_t max_iterations, size_t capacity = 64);
+
+        ~homotopy_stream();
+
+        /* appends samples to the window, and solves it */
+        solve_result push(const ndspan<T> samples);
+
+        solve_result push(const ndspan<T> samples, const solve_control& control);
+
+        /*  replaces the samples from position first of the window, without
+         *  advancing it, and solves it
+         */
+        solve_result update(size_t first, const ndspan<T> values);
+
+        /*  takes the oldest solution in the ring, of length n
+         *
+         *    returns : false if the ring is empty
+         */
+        bool pop(ndspan<T> x, homotopy_report* report = nullptr);
+
+        /* the position of the next sample, i.e. the number pushed mod m */
+        size_t head() const;
+
+        /* the number of solutions dropped because the ring was full */
+        std::uint64_t dropped() const;
+
+      private:
+        struct impl;
+        std::unique_ptr<impl> m;
+    };
+}
@@ -0,0 +1,239 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "ss/mapped.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ss
+{
+    /* mapped_file --------------------------------------------------------- */
+
+    mapped_file::mapped_file(const std::string& path, const map_options& options)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            _error = path + ": " + std::strerror(errno);
+            return;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            _error = path + ": " + std::strerror(errno);
+            ::close(fd);
+            return;
+        }
+        if (st.st_size == 0) {
+            _error = path + ": empty file";
+            ::close(fd);
+            return;
+        }
+
+        int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+        if (options.populate) { flags |= MAP_POPULATE; }
+#endif
+
+        /* read-only, so that every page is the page cache's own */
+        void* addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ, flags, fd, 0);
+        const int err = errno;
+
+        /* the mapping holds its own reference to the file */
+        ::close(fd);
+
+        if (addr == MAP_FAILED) {
+            _error = path + ": " + std::strerror(err);
+            return;
+        }
+
+#if defined(MADV_HUGEPAGE)
+        /* only a hint; unsupported by some file systems */
+        if (options.huge_pages) { ::madvise(addr, size_t(st.st_size), MADV_HUGEPAGE); }
+#endif
+        _data = static_cast<char*>(addr);
+        _size = size_t(st.st_size);
+    }
+
+    mapped_file::mapped_file(mapped_file&& other)
+        : _data{ other._data }, _size{ other._size }, _error{ std::move(other._error) }
+    {
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other)
+    {
+        if (this != &other) {
+            if (_data) { ::munmap(_data, _size); }
+
+            _data  = other._data;
+            _size  = other._size;
+            _error = std::move(other._error);
+
+            other._data = nullptr;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    mapped_file::~mapped_file()
+    {
+        if (_data) { ::munmap(_data, _size); }
+    }
+
+    /* npy ----------------------------------------------------------------- */
+
+    namespace
+    {
+        /* the text following `'key':` in the header dictionary, or npos */
+        size_t find_value(const std::string& header, const char* key)
+        {
+            size_t pos = header.find(std::string("'") + key + "'");
+            if (pos == std::string::npos) { return pos; }
+
+            pos = header.find(':', pos);
+            if (pos == std::string::npos) { return pos; }
+
+            return header.find_first_not_of(" ", pos + 1);
+        }
+
+        bool little_endian()
+        {
+            const uint16_t one = 1;
+            uint8_t first;
+            std::memcpy(&first, &one, 1);
+            return first == 1;
+        }
+    }
+
+    namespace detail
+    {
+        npy_header read_npy_header(const mapped_file& file, std::string& error)
+        {
+            static const char magic[] = "\x93NUMPY";
+
+            npy_header h{ "", { { 0, 0 } }, false, 0 };
+            const char* data = file.data();
+            const size_t size = file.size();
+
+            if (size < 10 || std::memcmp(data, magic, 6) != 0) {
+                error = "not a .npy file";
+                return h;
+            }
+
+            /* version 1.0 has a 2 byte header length, later versions 4 bytes */
+            const uint8_t major = uint8_t(data[6]);
+            size_t length = 0, start = 0;
+
+            if (major == 1) {
+                length = size_t(uint8_t(data[8])) | size_t(uint8_t(data[9])) << 8;
+                start = 10;
+            }
+            else if ((major == 2 || major == 3) && size >= 12) {
+                for (int i = 3; i >= 0; i--) { length = length << 8 | uint8_t(data[8 + i]); }
+                start = 12;
+            }
+            else {
+                error = "unsupported .npy version " + std::to_string(major);
+                return h;
+            }
+
+            if (size < start + length) {
+                error = "truncated .npy header";
+                return h;
+            }
+
+            const std::string header(data + start, length);
+            h.offset = start + length;
+
+            /* descr, e.g. '<f8' */
+            size_t pos = find_value(header, "descr");
+            if (pos == std::string::npos || header[pos] != '\'' || header.size() < pos + 4) {
+                error = "missing element type";
+                return h;
+            }
+            const std::string descr = header.substr(pos + 1, header.find('\'', pos + 1) - pos - 1);
+
+            const char order = descr.empty() ? '?' : descr[0];
+            if ((order == '<' && !little_endian()) || (order == '>' && little_endian())) {
+                error = "element type " + descr + " is not in native byte order";
+                return h;
+            }
+
+            /* fortran_order */
+            pos = find_value(header, "fortran_order");
+            if (pos == std::string::npos) {
+                error = "missing fortran_order";
+                return h;
+            }
+            h.fortran_order = header.compare(pos, 4, "True") == 0;
+
+            /* shape, e.g. (3, 4) */
+            pos = find_value(header, "shape");
+            if (pos == std::string::npos || header[pos] != '(') {
+                error = "missing shape";
+                return h;
+            }
+            const size_t end = header.find(')', pos);
+            if (end == std::string::npos) {
+                error = "malformed shape";
+                return h;
+            }
+
+            size_t dims = 0;
+            const char* it = header.c_str() + pos + 1;
+            const char* last = header.c_str() + end;
+
+            while (it < last)
+            {
+                char* next;
+                const unsigned long long d = std::strtoull(it, &next, 10);
+                if (next == it) { break; }
+
+                if (dims < 2) { h.shape[dims] = size_t(d); }
+                dims++;
+
+                it = next;
+                while (it < last && (*it == ',' || *it == ' ')) { it++; }
+            }
+
+            if (dims != 2) {
+                error = "expected a 2-d array, not " + std::to_string(dims) + "-d";
+                return h;
+            }
+
+            h.dtype = (order == '<' || order == '>' || order == '=' || order == '|') ?
+                descr.substr(1) : descr;
+            return h;
+        }
+    }
+
+    std::string npy_dtype(const std::string& path)
+    {
+        mapped_file file(path);
+        if (!file) { return {}; }
+
+        std::string error;
+        return detail::read_npy_header(file, error).dtype;
+    }
+}
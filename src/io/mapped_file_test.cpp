@@ -0,0 +1,123 @@
+#include <ss/ss.h>
+#include <ss/mapped.h>
+#include "test_util.h"
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+#include <xtensor/xio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+using xt::xtensor;
+
+namespace
+{
+    /* writes A as a version 1.0 .npy file, in either order */
+    template <typename T>
+    void save_npy(const std::string& path, const xtensor<T, 2>& A, bool fortran_order)
+    {
+        std::string header = std::string("{'descr': '<") + ss::detail::npy_dtype<T>() + "', "
+            + "'fortran_order': " + (fortran_order ? "True" : "False") + ", "
+            + "'shape': (" + std::to_string(A.shape()[0]) + ", " + std::to_string(A.shape()[1]) + "), }";
+
+        /* the data is aligned to 64 bytes */
+        header.append(64 - (10 + header.size() + 1) % 64, ' ');
+        header += '\n';
+
+        std::ofstream out(path, std::ios::binary);
+        const uint16_t length = uint16_t(header.size());
+
+        out.write("\x93NUMPY\x01\x00", 8);
+        out.put(char(length & 0xff)).put(char(length >> 8));
+        out.write(header.data(), header.size());
+
+        for (size_t k = 0; k < A.size(); k++) {
+            const size_t i = fortran_order ? k % A.shape()[0] : k / A.shape()[1];
+            const size_t j = fortran_order ? k / A.shape()[0] : k % A.shape()[1];
+            out.write(reinterpret_cast<const char*>(&A(i, j)), sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void test_npy(bool fortran_order)
+    {
+        xt::random::seed(0);
+        xtensor<T, 2> A = xt::random::rand<T>({ 20, 10 }, T(0), T(.1));
+        xt::view(A, xt::all(), 5) = T(1);
+
+        temp_file file;
+        save_npy(file.path, A, fortran_order);
+
+        EXPECT_EQ(ss::detail::npy_dtype<T>(), ss::npy_dtype(file.path));
+
+        auto mapped = ss::mapped_matrix<T>::npy(file.path, { true, true });
+        ASSERT_TRUE(bool(mapped)) << mapped.error();
+        EXPECT_EQ(A.shape()[0], mapped.shape()[0]);
+        EXPECT_EQ(A.shape()[1], mapped.shape()[1]);
+        EXPECT_EQ(A, mapped.view());
+
+        /* solved from the mapping as from memory */
+        xtensor<T, 1> signal = xt::ones<T>({ 20 });
+        xtensor<T, 1> expect = xt::zeros<T>({ 10 }), x = expect;
+
+        ss::homotopy<T>(ss::as_span(A)).solve(ss::as_span(signal), T(.01), 50, ss::as_span(expect));
+        ss::homotopy<T>(mapped.view()).solve(ss::as_span(signal), T(.01), 50, ss::as_span(x));
+
+        EXPECT_EQ(expect, x);
+
+        /* the element type is checked */
+        using other = typename std::conditional<std::is_same<T, float>::value, double, float>::type;
+        EXPECT_FALSE(bool(ss::mapped_matrix<other>::npy(file.path)));
+    }
+}
+
+TEST(mapped, npy)
+{
+    test_npy<float>(false);
+    test_npy<double>(true);
+}
+
+TEST(mapped, raw)
+{
+    xtensor<float, 2> A = xt::random::rand<float>({ 3, 4 });
+
+    temp_file file;
+    {   /* column-major, after a 16 byte header */
+        std::ofstream out(file.path, std::ios::binary);
+        out.write("0123456789abcdef", 16);
+
+        for (size_t j = 0; j < 4; j++) {
+            for (size_t i = 0; i < 3; i++) { out.write(reinterpret_cast<const char*>(&A(i, j)), 4); }
+        }
+    }
+
+    auto mapped = ss::mapped_matrix<float>::raw(file.path, 3, 4, ss::matrix_layout::column_major, 16);
+    ASSERT_TRUE(bool(mapped)) << mapped.error();
+    EXPECT_EQ(A, mapped.view());
+
+    EXPECT_FALSE(bool(ss::mapped_matrix<float>::raw(file.path, 4, 4, ss::matrix_layout::row_major, 16)));
+    EXPECT_FALSE(bool(ss::mapped_matrix<float>::raw(file.path, 3, 4, ss::matrix_layout::row_major, 2)));
+
+    /* a shape whose element count overflows is rejected */
+    const size_t huge = SIZE_MAX / 2 + 1;
+    EXPECT_FALSE(bool(ss::mapped_matrix<float>::raw(file.path, huge, 4)));
+    EXPECT_FALSE(bool(ss::mapped_matrix<float>::raw(file.path, huge, 2, ss::matrix_layout::column_major)));
+}
+
+TEST(mapped, errors)
+{
+    auto missing = ss::mapped_matrix<float>::npy("/nonexistent/dictionary.npy");
+    EXPECT_FALSE(bool(missing));
+    EXPECT_FALSE(missing.error().empty());
+
+    temp_file file;
+    std::ofstream(file.path) << "not a numpy file";
+
+    EXPECT_FALSE(bool(ss::mapped_matrix<float>::npy(file.path)));
+    EXPECT_TRUE(ss::npy_dtype(file.path).empty());
+}
@@ -0,0 +1,237 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "io/state_file.h"
+
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ss {
+namespace io
+{
+    namespace
+    {
+        const char magic[8] = { 'S', 'S', 'S', 'T', 'A', 'T', 'E', '\0' };
+
+        /* reads back as another value on a machine of the other byte order */
+        constexpr uint32_t byte_order_mark = 0x01020304;
+
+        size_t align(size_t offset) {
+            return (offset + state_alignment - 1) / state_alignment * state_alignment;
+        }
+
+        /* the offset of each section, and the size of the whole file */
+        std::vector<uint64_t> layout(const std::vector<size_t>& bytes, size_t& size)
+        {
+            std::vector<uint64_t> offsets(bytes.size());
+            size = sizeof(state_header) + bytes.size() * 2 * sizeof(uint64_t);
+
+            for (size_t i = 0; i < bytes.size(); i++) {
+                offsets[i] = align(size);
+                size = offsets[i] + bytes[i];
+            }
+            return offsets;
+        }
+
+        /* writes all of `bytes`, retrying short writes */
+        bool write_all(int fd, const char* data, size_t bytes)
+        {
+            while (bytes > 0) {
+                const ssize_t n = ::write(fd, data, bytes);
+                if (n < 0) {
+                    if (errno == EINTR) { continue; }
+                    return false;
+                }
+                data  += n;
+                bytes -= size_t(n);
+            }
+            return true;
+        }
+
+        /* the directory holding `path` */
+        std::string directory(const std::string& path)
+        {
+            const size_t slash = path.rfind('/');
+            if (slash == std::string::npos) { return "."; }
+            return slash == 0 ? "/" : path.substr(0, slash);
+        }
+    }
+
+    state_header make_header(state_kind kind,
+        size_t element_size, size_t rows, size_t cols, uint64_t checksum)
+    {
+        state_header h;
+        std::memcpy(h.magic, magic, sizeof(magic));
+
+        h.version       = state_version;
+        h.byte_order    = byte_order_mark;
+        h.kind          = uint32_t(kind);
+        h.element_size  = uint32_t(element_size);
+        h.rows          = rows;
+        h.cols          = cols;
+        h.checksum      = checksum;
+        h.section_count = 0;
+        return h;
+    }
+
+    /* state_writer -------------------------------------------------------- */
+
+    bool state_writer::write(const std::string& path, std::string* error) const
+    {
+        std::vector<size_t> bytes;
+        for (auto& s : _sections) { bytes.push_back(s.bytes); }
+
+        size_t size;
+        const auto offsets = layout(bytes, size);
+
+        state_header header = _header;
+        header.section_count = _sections.size();
+
+        /* written to a unique temporary file, then renamed over `path`, so
+           that a reader never maps a partially written file */
+        std::string temp = path + ".XXXXXX";
+        const int fd = ::mkstemp(&temp[0]);
+        if (fd < 0) {
+            if (error) { *error = path + ": " + std::strerror(errno); }
+            return false;
+        }
+
+        bool ok = write_all(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+        for (size_t i = 0; ok && i < _sections.size(); i++) {
+            const uint64_t entry[2] = { offsets[i], _sections[i].bytes };
+            ok = write_all(fd, reinterpret_cast<const char*>(entry), sizeof(entry));
+        }
+
+        size_t pos = sizeof(header) + _sections.size() * 2 * sizeof(uint64_t);
+        for (size_t i = 0; ok && i < _sections.size(); i++)
+        {
+            static const char zeros[state_alignment] = {};
+            ok = write_all(fd, zeros, offsets[i] - pos)
+                && write_all(fd, _sections[i].data, _sections[i].bytes);
+
+            pos = offsets[i] + _sections[i].bytes;
+        }
+
+        /* the data must be on disk before the rename makes it visible */
+        ok = ok && ::fsync(fd) == 0;
+        int err = ok ? 0 : errno;
+
+        if (::close(fd) != 0 && ok) {
+            ok = false;
+            err = errno;
+        }
+        if (!ok) {
+            if (error) { *error = temp + ": " + std::strerror(err); }
+            std::remove(temp.c_str());
+            return false;
+        }
+
+        if (std::rename(temp.c_str(), path.c_str()) != 0) {
+            if (error) { *error = path + ": " + std::strerror(errno); }
+            std::remove(temp.c_str());
+            return false;
+        }
+
+        /* and the rename itself, with the directory */
+        const int dir = ::open(directory(path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir >= 0) {
+            ::fsync(dir);
+            ::close(dir);
+        }
+        return true;
+    }
+
+    /* state_reader -------------------------------------------------------- */
+
+    state_reader::state_reader(const std::string& path, const state_header& expect)
+        : _path(path)
+        , _file(path, map_options{ true, false })
+    {
+        if (!_file) {
+            _error = _file.error();
+            return;
+        }
+        if (_file.size() < sizeof(state_header)) {
+            _error = path + ": not a state file";
+            return;
+        }
+
+        state_header h;
+        std::memcpy(&h, _file.data(), sizeof(h));
+
+        if (std::memcmp(h.magic, magic, sizeof(magic)) != 0) {
+            _error = path + ": not a state file";
+        }
+        else if (h.byte_order != byte_order_mark) {
+            _error = path + ": written on a machine of another byte order";
+        }
+        else if (h.version != expect.version) {
+            _error = path + ": unsupported state file version " + std::to_string(h.version);
+        }
+        else if (h.kind != expect.kind) {
+            _error = path + ": the state of another solver";
+        }
+        else if (h.element_size != expect.element_size) {
+            _error = path + ": the state of a solver of another element type";
+        }
+        else if (h.rows != expect.rows || h.cols != expect.cols) {
+            _error = path + ": the state of a " + std::to_string(h.rows) + "x"
+                + std::to_string(h.cols) + " sensing matrix, not "
+                + std::to_string(expect.rows) + "x" + std::to_string(expect.cols);
+        }
+        else if (h.checksum != expect.checksum) {
+            _error = path + ": the state of another sensing matrix of the same shape";
+        }
+        else if (_file.size() - sizeof(h) < h.section_count * 2 * sizeof(uint64_t)) {
+            _error = path + ": truncated state file";
+        }
+        else {
+            _count = h.section_count;
+        }
+    }
+
+    bool state_reader::next_section(size_t element_size, const char*& data, size_t& bytes)
+    {
+        if (!_error.empty()) { return false; }
+
+        if (_next >= _count) {
+            _error = _path + ": missing section " + std::to_string(_next);
+            return false;
+        }
+
+        uint64_t entry[2];
+        std::memcpy(entry,
+            _file.data() + sizeof(state_header) + _next * sizeof(entry), sizeof(entry));
+
+        const uint64_t offset = entry[0], size = entry[1];
+
+        if (offset > _file.size() || size > _file.size() - offset) {
+            _error = _path + ": section " + std::to_string(_next) + " is truncated";
+            return false;
+        }
+        if (size % element_size != 0) {
+            _error = _path + ": section " + std::to_string(_next) + " has an unexpected size";
+            return false;
+        }
+
+        data  = _file.data() + offset;
+        bytes = size_t(size);
+        _next++;
+        return true;
+    }
+}}
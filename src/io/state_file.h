@@ -0,0 +1,192 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include "ss/mapped.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ss {
+namespace io
+{
+    /*  Solver state files
+     *
+     *  A state file holds the data a solver precomputes from its sensing
+     *  matrix, such as a factorization, such that it can be reloaded
+     *  instead of recomputed. The layout is
+     *
+     *    header   : state_header
+     *    sections : section_count x { uint64 offset, uint64 bytes }
+     *    data     : each section, aligned to state_alignment bytes
+     *
+     *  in the byte order of the machine which wrote it. Files of another
+     *  version, byte order, solver, element type or matrix shape, or of a
+     *  matrix of another checksum, are rejected.
+     */
+    constexpr uint32_t state_version   = 2;
+    constexpr size_t   state_alignment = 64;
+
+    /* the solver whose state is held in a file */
+    enum class state_kind : uint32_t
+    {
+        homotopy   = 1,
+        irls       = 2,
+        irls_mixed = 3
+    };
+
+    struct state_header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t kind;
+        uint32_t element_size;
+        uint64_t rows;
+        uint64_t cols;
+        uint64_t checksum;
+        uint64_t section_count;
+    };
+
+    namespace detail
+    {
+        /* the finalizer of splitmix64 */
+        inline uint64_t mix(uint64_t z)
+        {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+    }
+
+    /*  A checksum of the elements of A and their positions, read in a
+     *  single pass in the order of its storage, so that it doesn't depend
+     *  on whether A is row or column-major.
+     */
+    template <typename T>
+    uint64_t checksum(const ndspan<T, 2> A)
+    {
+        static_assert(sizeof(T) <= sizeof(uint64_t), "element too large");
+
+        const size_t m = A.shape()[0], n = A.shape()[1];
+        const size_t s0 = A.strides()[0], s1 = A.strides()[1];
+        const T* a = A.raw_data() + A.raw_data_offset();
+
+        /* the inner loop runs along the dimension of smaller stride */
+        const bool by_row = m <= 1 || (n > 1 && s1 <= s0);
+        const size_t outer = by_row ? m : n, inner = by_row ? n : m;
+        const size_t so = by_row ? s0 : s1, si = by_row ? s1 : s0;
+
+        uint64_t sum = 0;
+        for (size_t o = 0; o < outer; o++) {
+            for (size_t k = 0; k < inner; k++) {
+                uint64_t bits = 0;
+                std::memcpy(&bits, a + o * so + k * si, sizeof(T));
+
+                const uint64_t pos = by_row ? o * n + k : k * n + o;
+                sum += detail::mix(bits ^ (pos * 0x9e3779b97f4a7c15ull));
+            }
+        }
+        return sum;
+    }
+
+    /* describes the state a file is expected to hold, of a matrix of the given checksum */
+    state_header make_header(state_kind kind,
+        size_t element_size, size_t rows, size_t cols, uint64_t checksum);
+
+    /* collects the sections of a state, then writes them to a file */
+    class state_writer
+    {
+      public:
+        state_writer(state_kind kind,
+            size_t element_size, size_t rows, size_t cols, uint64_t checksum)
+            : _header{ make_header(kind, element_size, rows, cols, checksum) }
+        {}
+
+        /* appends a section of `count` elements, which must outlive the writer */
+        template <typename T>
+        void add(const T* data, size_t count) {
+            _sections.push_back({ reinterpret_cast<const char*>(data), count * sizeof(T) });
+        }
+
+        template <typename C>
+        void add(const C& c) { add(c.data(), c.size()); }
+
+        /*  writes the file, or returns false and sets `error`; it is written
+         *  to a temporary file in the same directory, synced, and renamed
+         *  over `path`, so `path` is only ever a complete file. As with
+         *  mkstemp, only its owner may read it.
+         */
+        bool write(const std::string& path, std::string* error) const;
+
+      private:
+        struct section { const char* data; size_t bytes; };
+
+        state_header         _header;
+        std::vector<section> _sections;
+    };
+
+    /*  Maps a state file and reads its sections in the order they were
+     *  added to the writer.
+     */
+    class state_reader
+    {
+      public:
+        /* maps the file at `path`, which must match `expect` */
+        state_reader(const std::string& path, const state_header& expect);
+
+        /* false if the file can't be used, see error() */
+        explicit operator bool() const { return _error.empty(); }
+
+        const std::string& error() const { return _error; }
+
+        /* copies the next section in to `out`, resized to fit */
+        template <typename T>
+        bool next(std::vector<T>& out)
+        {
+            const char* data; size_t bytes;
+            if (!next_section(sizeof(T), data, bytes)) { return false; }
+
+            out.resize(bytes / sizeof(T));
+            if (bytes) { std::memcpy(out.data(), data, bytes); }
+            return true;
+        }
+
+        /* copies the next section in to `out`, which must be exactly `count` elements */
+        template <typename T>
+        bool next(T* out, size_t count)
+        {
+            const char* data; size_t bytes;
+            if (!next_section(sizeof(T), data, bytes)) { return false; }
+
+            if (bytes != count * sizeof(T)) {
+                _error = _path + ": section " + std::to_string(_next - 1) + " has an unexpected size";
+                return false;
+            }
+            if (bytes) { std::memcpy(out, data, bytes); }
+            return true;
+        }
+
+      private:
+        bool next_section(size_t element_size, const char*& data, size_t& bytes);
+
+        std::string _path;
+        mapped_file _file;
+        uint64_t    _count = 0;
+        uint64_t    _next = 0;
+        std::string _error;
+    };
+}}
@@ -0,0 +1,241 @@
+#include <ss/ss.h>
+#include <io/state_file.h>
+#include "test_util.h"
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using xt::xtensor;
+using ss::as_span;
+
+TEST(state_file, sections)
+{
+    using namespace ss::io;
+
+    const std::vector<uint32_t> a = { 1, 2, 3 };
+    const std::vector<double>   b = { .5, -1 };
+    const std::vector<int8_t>   empty;
+
+    temp_file file;
+    std::string error;
+
+    state_writer writer(state_kind::irls, sizeof(double), 3, 2, 7);
+    writer.add(a);
+    writer.add(b);
+    writer.add(empty);
+    ASSERT_TRUE(writer.write(file.path, &error)) << error;
+
+    state_reader reader(file.path, make_header(state_kind::irls, sizeof(double), 3, 2, 7));
+    ASSERT_TRUE(bool(reader)) << reader.error();
+
+    std::vector<uint32_t> read_a;
+    double read_b[2];
+    std::vector<int8_t> read_empty = { 1 };
+
+    EXPECT_TRUE(reader.next(read_a));
+    EXPECT_TRUE(reader.next(read_b, 2));
+    EXPECT_TRUE(reader.next(read_empty));
+
+    EXPECT_EQ(a, read_a);
+    EXPECT_EQ(b[0], read_b[0]);
+    EXPECT_EQ(b[1], read_b[1]);
+    EXPECT_TRUE(read_empty.empty());
+
+    /* no more sections */
+    EXPECT_FALSE(reader.next(read_a));
+    EXPECT_FALSE(bool(reader));
+}
+
+TEST(state_file, rejected)
+{
+    using namespace ss::io;
+
+    temp_file file;
+    const std::vector<float> a = { 1, 2 };
+
+    state_writer writer(state_kind::homotopy, sizeof(float), 2, 1, 7);
+    writer.add(a);
+    ASSERT_TRUE(writer.write(file.path, nullptr));
+
+    /* another solver, element type, shape or checksum */
+    EXPECT_FALSE(bool(state_reader(file.path, make_header(state_kind::irls, sizeof(float), 2, 1, 7))));
+    EXPECT_FALSE(bool(state_reader(file.path, make_header(state_kind::homotopy, sizeof(double), 2, 1, 7))));
+    EXPECT_FALSE(bool(state_reader(file.path, make_header(state_kind::homotopy, sizeof(float), 1, 2, 7))));
+    EXPECT_FALSE(bool(state_reader(file.path, make_header(state_kind::homotopy, sizeof(float), 2, 1, 8))));
+
+    /* a section of another size */
+    state_reader reader(file.path, make_header(state_kind::homotopy, sizeof(float), 2, 1, 7));
+    float three[3];
+    EXPECT_FALSE(reader.next(three, 3));
+
+    /* not a state file, or missing */
+    {
+        std::ofstream out(file.path, std::ios::binary | std::ios::trunc);
+        out << "not a state file, but long enough to hold a header";
+    }
+    EXPECT_FALSE(bool(state_reader(file.path, make_header(state_kind::homotopy, sizeof(float), 2, 1, 7))));
+    EXPECT_FALSE(bool(state_reader(file.path + ".missing", make_header(state_kind::homotopy, sizeof(float), 2, 1, 7))));
+}
+
+TEST(state_file, checksum)
+{
+    using ss::io::checksum;
+
+    xt::random::seed(0);
+    xtensor<double, 2> A = xt::random::rand<double>({ 7, 5 });
+
+    /* independent of the layout of A */
+    std::vector<double> col_major(A.size());
+    for (size_t j = 0; j < 5; j++) {
+        for (size_t i = 0; i < 7; i++) { col_major[j * 7 + i] = A(i, j); }
+    }
+    EXPECT_EQ(checksum(as_span(A)),
+        checksum(as_span<2>(col_major.data(), { 7, 5 }, { 1, 7 })));
+
+    /* but not of its elements, or their positions */
+    xtensor<double, 2> B = A;
+    B(3, 2) += 1e-12;
+    EXPECT_NE(checksum(as_span(A)), checksum(as_span(B)));
+
+    B = A;
+    std::swap(B(0, 0), B(0, 1));
+    EXPECT_NE(checksum(as_span(A)), checksum(as_span(B)));
+}
+
+namespace
+{
+    /* a solver reloaded from its saved state solves as the original */
+    template <template <typename> class Solver, typename T, typename U, typename... Options>
+    void reload_test(xtensor<U, 2>& A, const Options&... options)
+    {
+        const size_t M = A.shape()[0], N = A.shape()[1];
+
+        xtensor<T, 1> signal = xt::view(A, xt::all(), N / 2);
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+        xtensor<T, 1> x      = xt::zeros<T>({ N });
+
+        temp_file file;
+        std::string error;
+
+        Solver<T> solver(as_span(A), options...);
+        ASSERT_TRUE(solver.save(file.path, &error)) << error;
+        solver.solve(as_span(signal), T(.01), 50, as_span(expect));
+
+        auto loaded = Solver<T>::load(as_span(A), options..., file.path, &error);
+        EXPECT_TRUE(error.empty()) << error;
+
+        loaded.solve(as_span(signal), T(.01), 50, as_span(x));
+        EXPECT_EQ(expect, x);
+
+        /* the state of a matrix of another shape is recomputed */
+        xtensor<U, 2> B = xt::view(A, xt::range(0, M - 1), xt::all());
+        Solver<T>::load(as_span(B), options..., file.path, &error);
+        EXPECT_FALSE(error.empty());
+
+        /* as is the state of another matrix of the same shape */
+        error.clear();
+        xtensor<U, 2> C = A;
+        C(M / 2, N / 2) += U(1);
+        Solver<T>::load(as_span(C), options..., file.path, &error);
+        EXPECT_FALSE(error.empty());
+    }
+}
+
+TEST(state_file, irls)
+{
+    xt::random::seed(0);
+
+    xtensor<float, 2> A = xt::random::randn({ 10, 5 }, 0.0f, 0.01f);
+    for (size_t n = 0; n < 5; n++) { A(n, n) += 1.0f; }
+    xtensor<double, 2> A_d = A;
+
+    reload_test<ss::irls, float>(A);
+    reload_test<ss::irls, double>(A_d);
+    reload_test<ss::irls_mixed, double>(A);
+}
+
+TEST(state_file, homotopy)
+{
+    xt::random::seed(0);
+
+    xtensor<float, 2> A = xt::random::rand<float>({ 20, 30 }, 0.f, .1f);
+    xt::view(A, xt::all(), 15) = 1.f;
+    xtensor<double, 2> A_d = A;
+
+    ss::homotopy_options options;
+    reload_test<ss::homotopy, float>(A, options);
+
+    options.column_major_copy = true;
+    reload_test<ss::homotopy, double>(A_d, options);
+
+    options.quantized_screening = true;
+    reload_test<ss::homotopy, float>(A, options);
+
+    options.storage = ss::homotopy_storage::bf16;
+    reload_test<ss::homotopy, double>(A_d, options);
+
+    /* a state saved with other options is recomputed */
+    temp_file file;
+    std::string error;
+
+    ss::homotopy<float>(as_span(A)).save(file.path, &error);
+    ss::homotopy<float>::load(as_span(A), options, file.path, &error);
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(state_file, homotopy_sections)
+{
+    using namespace ss::io;
+
+    xt::random::seed(0);
+
+    xtensor<float, 2> A = xt::random::rand<float>({ 20, 30 }, 0.f, .1f);
+    xt::view(A, xt::all(), 15) = 1.f;
+
+    ss::homotopy_options options;
+    options.storage = ss::homotopy_storage::bf16;
+
+    xtensor<float, 1> signal = xt::view(A, xt::all(), 15);
+    xtensor<float, 1> expect = xt::zeros<float>({ 30 });
+    ss::homotopy<float>(as_span(A), options).solve(as_span(signal), .01f, 50, as_span(expect));
+
+    /* the 16-bit copy missing, or twice its size */
+    const std::vector<uint32_t> saved_options = { 0, uint32_t(options.storage), 0 };
+    const std::vector<float> none;
+    const std::vector<int8_t> unquantized;
+    const std::vector<uint16_t> sizes[] = {
+        {}, std::vector<uint16_t>(2 * A.size(), 0)
+    };
+
+    for (auto& reduced : sizes)
+    {
+        temp_file file;
+        std::string error;
+
+        state_writer writer(state_kind::homotopy, sizeof(float), 20, 30, checksum(as_span(A)));
+        writer.add(saved_options);
+        writer.add(none);
+        writer.add(reduced);
+        writer.add(unquantized);
+        writer.add(none);
+        ASSERT_TRUE(writer.write(file.path, &error)) << error;
+
+        /* recomputed, so solved as the original */
+        auto loaded = ss::homotopy<float>::load(as_span(A), options, file.path, &error);
+        EXPECT_FALSE(error.empty());
+
+        xtensor<float, 1> x = xt::zeros<float>({ 30 });
+        loaded.solve(as_span(signal), .01f, 50, as_span(x));
+        EXPECT_EQ(expect, x);
+    }
+}
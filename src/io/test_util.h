@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+    /* a temporary file, removed with the object */
+    struct temp_file
+    {
+        temp_file() {
+            char name[] = "/tmp/ss_test_XXXXXX";
+            const int fd = mkstemp(name);
+            close(fd);
+            path = name;
+        }
+
+        ~temp_file() { std::remove(path.c_str()); }
+
+        std::string path;
+    };
+}
@@ -17,59 +17,419 @@ limitations under the License.  */
 #include "ss/ss.h"
 #include "solvers/homotopy.h"
 #include "solvers/irls.h"
+#include "solvers/fixed_size.h"
 
 #include "linalg/common.h"
 #include "linalg/norms.h"
+#include "linalg/residuals.h"
 #include "linalg/blas_wrapper.h"
 #include "linalg/qr_decomposition.h"
+#include "linalg/iterative_refinement.h"
+#include "linalg/sparse.h"
+#include "linalg/half.h"
+#include "linalg/quantized.h"
+#include "linalg/aligned_allocator.h"
+#include "io/state_file.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#if defined(__linux__)
+# include <dirent.h>
+# include <dlfcn.h>
+# include <pthread.h>
+# include <sched.h>
+#endif
 
 namespace ss
 {
     /* Homotopy solver ----------------------------------------------------- */
 
+    namespace detail
+    {
+        template <typename T>
+        std::vector<T> column_major(const ndspan<T, 2> A)
+        {
+            const size_t m = dim<0>(A), n = dim<1>(A);
+            std::vector<T> copy(m * n);
+
+            for (size_t j = 0; j < n; j++) {
+                for (size_t i = 0; i < m; i++) { copy[j * m + i] = A(i, j); }
+            }
+            return copy;
+        }
+
+        inline half::format format_of(homotopy_storage storage) {
+            return storage == homotopy_storage::fp16 ? half::format::fp16 : half::format::bf16;
+        }
+
+        template <typename T>
+        quantized::matrix quantized_matrix(const homotopy_state<T>& state) {
+            return { { dim<0>(state.A), dim<1>(state.A) },
+                state.quantized.data(), state.scales.data() };
+        }
+
+        /*  the view of the sensing matrix kept by a homotopy state: its
+         *  column-major copy, if any, or only its shape with 16-bit storage,
+         *  so the caller's matrix isn't read after construction
+         */
+        template <typename T>
+        ndspan<T, 2> solved_view(const ndspan<T, 2> A,
+            const std::vector<T>& copy, homotopy_storage storage)
+        {
+            const size_t m = dim<0>(A), n = dim<1>(A);
+            if (!copy.empty()) {
+                return as_span<2>(const_cast<T*>(copy.data()), { m, n }, { 1, m });
+            }
+            if (storage != homotopy_storage::native) {
+                return as_span<2>(static_cast<T*>(nullptr), { m, n });
+            }
+            return A;
+        }
+
+        template <typename T>
+        half::matrix reduced_matrix(const homotopy_state<T>& state) {
+            return { { dim<0>(state.A), dim<1>(state.A) },
+                state.reduced.data(), format_of(state.storage) };
+        }
+    }
+
+    template <typename T>
+    homotopy_state<T>::homotopy_state(const ndspan<T, 2> A, const homotopy_options& options)
+        : copy(options.column_major_copy && options.storage == homotopy_storage::native ?
+            detail::column_major(A) : std::vector<T>{})
+        , reduced(options.storage != homotopy_storage::native ?
+            half::column_major(detail::format_of(options.storage), A) : std::vector<uint16_t>{})
+        , storage(options.storage)
+        , A(detail::solved_view(A, copy, storage))
+        , checksum(io::checksum(A))
+        , options(options)
+    {
+        if (options.quantized_screening && storage == homotopy_storage::native) {
+            ss::quantized::quantize(A, quantized, scales);
+        }
+    }
+
+    template <typename T>
+    homotopy_state<T>::homotopy_state(const ndspan<T, 2> A, const homotopy_options& options,
+            std::vector<T> copy, std::vector<uint16_t> reduced,
+            std::vector<int8_t> quantized, std::vector<float> scales, uint64_t checksum)
+        : copy(std::move(copy))
+        , reduced(std::move(reduced))
+        , storage(options.storage)
+        , quantized(std::move(quantized))
+        , scales(std::move(scales))
+        , A(detail::solved_view(A, this->copy, storage))
+        , checksum(checksum)
+        , options(options)
+    {}
+
+    namespace detail
+    {
+        inline std::vector<uint32_t> encode_options(const homotopy_options& options) {
+            return { options.column_major_copy, uint32_t(options.storage),
+                options.quantized_screening };
+        }
+    }
+
+    template <typename T>
+    std::unique_ptr<homotopy_state<T>> homotopy_state<T>::load(const ndspan<T, 2> A,
+        const std::string& path, std::string* error, const homotopy_options& options)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+        const uint64_t checksum = io::checksum(A);
+        io::state_reader file(path,
+            io::make_header(io::state_kind::homotopy, sizeof(T), m, n, checksum));
+
+        std::vector<uint32_t> saved_options;
+        std::vector<T> copy;
+        std::vector<uint16_t> reduced;
+        std::vector<int8_t> quantized;
+        std::vector<float> scales;
+
+        bool ok = file.next(saved_options);
+        if (ok && saved_options != detail::encode_options(options)) {
+            if (error) { *error = path + ": saved with other options"; }
+            return std::make_unique<homotopy_state>(A, options);
+        }
+
+        /* each copy is present exactly when the options ask for it */
+        const bool native = options.storage == homotopy_storage::native;
+        const bool screened = options.quantized_screening && native;
+
+        ok = ok && file.next(copy) && file.next(reduced) && file.next(quantized) && file.next(scales);
+        if (ok && (copy.size() != (options.column_major_copy && native ? m * n : 0)
+                || reduced.size() != (!native ? m * n : 0)
+                || quantized.size() != (screened ? m * n : 0)
+                || scales.size() != (screened ? n : 0))) {
+            ok = false;
+        }
+        if (!ok) {
+            if (error) { *error = file ? path + ": malformed state" : file.error(); }
+            return std::make_unique<homotopy_state>(A, options);
+        }
+
+        return std::unique_ptr<homotopy_state>(new homotopy_state(A, options,
+            std::move(copy), std::move(reduced), std::move(quantized), std::move(scales),
+            checksum));
+    }
+
+    template <typename T>
+    bool homotopy_state<T>::save(const std::string& path, std::string* error) const
+    {
+        const auto saved_options = detail::encode_options(options);
+
+        io::state_writer file(io::state_kind::homotopy,
+            sizeof(T), dim<0>(A), dim<1>(A), checksum);
+        file.add(saved_options);
+        file.add(copy);
+        file.add(reduced);
+        file.add(quantized);
+        file.add(scales);
+
+        return file.write(path, error);
+    }
+
+    template struct homotopy_state<float>;
+    template struct homotopy_state<double>;
+
     kernelpp::maybe<ss::homotopy_report> homotopy_policy::run(
-        const ndspan<float, 2>& A,
+        const homotopy_state<float>& state,
         const ndspan<float> y,
         float tol, uint32_t maxiter,
         ndspan<float> x)
     {
-        return kernelpp::run<solve_homotopy>(A, y, tol, maxiter, x);
+        if (state.storage != homotopy_storage::native) {
+            return kernelpp::run<solve_homotopy_reduced>(
+                detail::reduced_matrix(state), y, tol, maxiter, x);
+        }
+        if (!state.quantized.empty()) {
+            return kernelpp::run<solve_homotopy_screened>(
+                state.A, detail::quantized_matrix(state), y, tol, maxiter, x);
+        }
+        if (fixed::homotopy_eligible(dim<0>(state.A), dim<1>(state.A))) {
+            return kernelpp::run<solve_homotopy_fixed>(state.A, y, tol, maxiter, x);
+        }
+        return kernelpp::run<solve_homotopy>(state.A, y, tol, maxiter, x);
     }
 
     kernelpp::maybe<ss::homotopy_report> homotopy_policy::run(
-        const ndspan<double, 2>& A,
+        const homotopy_state<double>& state,
         const ndspan<double> y,
         double tol, uint32_t maxiter,
         ndspan<double> x)
     {
-        return kernelpp::run<solve_homotopy>(A, y, tol, maxiter, x);
+        if (state.storage != homotopy_storage::native) {
+            return kernelpp::run<solve_homotopy_reduced>(
+                detail::reduced_matrix(state), y, tol, maxiter, x);
+        }
+        if (!state.quantized.empty()) {
+            return kernelpp::run<solve_homotopy_screened>(
+                state.A, detail::quantized_matrix(state), y, tol, maxiter, x);
+        }
+        if (fixed::homotopy_eligible(dim<0>(state.A), dim<1>(state.A))) {
+            return kernelpp::run<solve_homotopy_fixed>(state.A, y, tol, maxiter, x);
+        }
+        return kernelpp::run<solve_homotopy>(state.A, y, tol, maxiter, x);
     }
 
 
-    /* IRLS solver --------------------------------------------------------- */
+    kernelpp::maybe<ss::homotopy_report> sparse_homotopy_policy::run(
+        const csc_span<float>& A,
+        const ndspan<float> y,
+        float tol, uint32_t maxiter,
+        ndspan<float> x)
+    {
+        return kernelpp::run<solve_homotopy_sparse>(A, y, tol, maxiter, x);
+    }
 
-    irls_state::irls_state(const ndspan<float, 2> A) {
-        QR = ss::qr_decomposition<float>(A);
+    kernelpp::maybe<ss::homotopy_report> sparse_homotopy_policy::run(
+        const csc_span<double>& A,
+        const ndspan<double> y,
+        double tol, uint32_t maxiter,
+        ndspan<double> x)
+    {
+        return kernelpp::run<solve_homotopy_sparse>(A, y, tol, maxiter, x);
     }
 
-    irls_state::irls_state(const ndspan<double, 2> A) {
-        QR = ss::qr_decomposition<double>(A);
+
+    /* IRLS solver --------------------------------------------------------- */
+
+    irls_state::irls_state(const ndspan<float, 2> A)
+        : irls_state(ss::qr_decomposition<float>(A), io::checksum(A))
+    {}
+
+    irls_state::irls_state(const ndspan<double, 2> A)
+        : irls_state(ss::qr_decomposition<double>(A), io::checksum(A))
+    {}
+
+    irls_state::irls_state(xtl::any QR, uint64_t checksum)
+        : QR(std::move(QR)), checksum(checksum)
+    {
+        if (auto* qr = xtl::any_cast<qr_decomposition<float>>(&this->QR)) {
+            factors = irls_factors<float>(*qr);
+        }
+        else {
+            factors = irls_factors<double>(
+                xtl::any_cast<const qr_decomposition<double>&>(this->QR));
+        }
     }
         
     irls_state::~irls_state() = default;
 
-    kernelpp::maybe<irls_report> irls_policy::run(
-        irls_state& state, const ndspan<float> y, float tol, uint32_t maxiter, ndspan<float> x)
+    namespace detail
+    {
+        /*  the factorization of the m-by-n matrix A, of the given checksum,
+         *  saved to `path`, or empty with `error` set to the reason it can't
+         *  be read
+         */
+        template <typename T>
+        xtl::any load_qr(io::state_kind kind, const ndspan<T, 2> A, uint64_t checksum,
+            const std::string& path, std::string* error)
+        {
+            const size_t m = dim<0>(A), n = dim<1>(A);
+            io::state_reader file(path, io::make_header(kind, sizeof(T), m, n, checksum));
+
+            std::vector<uint32_t> backend;
+            if (!file.next(backend) || backend.size() != 1) {
+                if (error) { *error = file ? path + ": malformed state" : file.error(); }
+                return {};
+            }
+
+            const bool lapack = backend[0] != 0;
+            if (lapack && !blas::use_lapack(decomposition_backend::automatic)) {
+                if (error) { *error = path + ": factorized by lapack, which is not available"; }
+                return {};
+            }
+
+            /* the transpose of A with the lapack backend, see qr_decomposition */
+            auto qr = xt::xtensor<T, 2>::from_shape(
+                lapack ? std::array<size_t, 2>{ { n, m } } : std::array<size_t, 2>{ { m, n } });
+            auto rdiag = xt::xtensor<T, 1>::from_shape({ n });
+            auto tau = xt::xtensor<T, 1>::from_shape({ lapack ? n : size_t(0) });
+
+            if (!file.next(qr.raw_data(), qr.size())
+                || !file.next(rdiag.raw_data(), rdiag.size())
+                || !file.next(tau.raw_data(), tau.size()))
+            {
+                if (error) { *error = file.error(); }
+                return {};
+            }
+
+            return qr_decomposition<T>(lapack, std::move(qr), std::move(rdiag), std::move(tau));
+        }
+
+        template <typename T>
+        bool save_qr(io::state_kind kind, const qr_decomposition<T>& qr, uint64_t checksum,
+            const std::string& path, std::string* error)
+        {
+            const auto& f = qr.factors();
+            const size_t m = qr.lapack() ? dim<1>(f) : dim<0>(f);
+            const size_t n = qr.lapack() ? dim<0>(f) : dim<1>(f);
+
+            const uint32_t backend = qr.lapack();
+
+            io::state_writer file(kind, sizeof(T), m, n, checksum);
+            file.add(&backend, 1);
+            file.add(f.raw_data(), f.size());
+            file.add(qr.rdiag().raw_data(), qr.rdiag().size());
+            file.add(qr.tau().raw_data(), qr.tau().size());
+
+            return file.write(path, error);
+        }
+    }
+
+    std::unique_ptr<irls_state> irls_state::load(
+        const ndspan<float, 2> A, const std::string& path, std::string* error)
+    {
+        const uint64_t checksum = io::checksum(A);
+
+        auto QR = detail::load_qr<float>(io::state_kind::irls, A, checksum, path, error);
+        if (QR.empty()) { return std::make_unique<irls_state>(A); }
+
+        return std::unique_ptr<irls_state>(new irls_state(std::move(QR), checksum));
+    }
+
+    std::unique_ptr<irls_state> irls_state::load(
+        const ndspan<double, 2> A, const std::string& path, std::string* error)
+    {
+        const uint64_t checksum = io::checksum(A);
+
+        auto QR = detail::load_qr<double>(io::state_kind::irls, A, checksum, path, error);
+        if (QR.empty()) { return std::make_unique<irls_state>(A); }
+
+        return std::unique_ptr<irls_state>(new irls_state(std::move(QR), checksum));
+    }
+
+    bool irls_state::save(const std::string& path, std::string* error) const
+    {
+        if (auto* qr = xtl::any_cast<qr_decomposition<float>>(&QR)) {
+            return detail::save_qr(io::state_kind::irls, *qr, checksum, path, error);
+        }
+        return detail::save_qr(io::state_kind::irls,
+            xtl::any_cast<const qr_decomposition<double>&>(QR), checksum, path, error);
+    }
+
+    kernelpp::maybe<irls_report> irls_policy::run(const irls_state& state,
+        const ndspan<float> y, float tol, uint32_t maxiter, ndspan<float> x)
+    {
+        auto& F = xtl::any_cast<const irls_factors<float>&>(state.factors);
+        if (fixed::irls_eligible(y.size(), x.size())) {
+            return kernelpp::run<solve_irls_fixed>(F, y, tol, maxiter, x);
+        }
+        return kernelpp::run<solve_irls>(F, y, tol, maxiter, x);
+    }
+
+    kernelpp::maybe<irls_report> irls_policy::run(const irls_state& state,
+        const ndspan<double> y, double tol, uint32_t maxiter, ndspan<double> x)
+    {
+        auto& F = xtl::any_cast<const irls_factors<double>&>(state.factors);
+        if (fixed::irls_eligible(y.size(), x.size())) {
+            return kernelpp::run<solve_irls_fixed>(F, y, tol, maxiter, x);
+        }
+        return kernelpp::run<solve_irls>(F, y, tol, maxiter, x);
+    }
+
+
+    /* Mixed precision IRLS solver ----------------------------------------- */
+
+    irls_mixed_state::irls_mixed_state(const ndspan<float, 2> A)
+        : irls_mixed_state(A, ss::qr_decomposition<float>(A))
+    {}
+
+    irls_mixed_state::irls_mixed_state(const ndspan<float, 2> A, xtl::any QR)
+        : A(A), QR(std::move(QR))
     {
-        auto& qr = xtl::any_cast<qr_decomposition<float>&>(state.QR);
-        return kernelpp::run<solve_irls>(qr, y, tol, maxiter, x);
+        Q = refine_q<double>(xtl::any_cast<const qr_decomposition<float>&>(this->QR), A);
     }
 
-    kernelpp::maybe<irls_report> irls_policy::run(
-        irls_state& state, const ndspan<double> y, double tol, uint32_t maxiter, ndspan<double> x)
+    irls_mixed_state::~irls_mixed_state() = default;
+
+    std::unique_ptr<irls_mixed_state> irls_mixed_state::load(
+        const ndspan<float, 2> A, const std::string& path, std::string* error)
     {
-        auto& qr = xtl::any_cast<qr_decomposition<double>&>(state.QR);
-        return kernelpp::run<solve_irls>(qr, y, tol, maxiter, x);
+        auto QR = detail::load_qr<float>(
+            io::state_kind::irls_mixed, A, io::checksum(A), path, error);
+        if (QR.empty()) { return std::make_unique<irls_mixed_state>(A); }
+
+        return std::unique_ptr<irls_mixed_state>(new irls_mixed_state(A, std::move(QR)));
+    }
+
+    bool irls_mixed_state::save(const std::string& path, std::string* error) const {
+        return detail::save_qr(io::state_kind::irls_mixed,
+            xtl::any_cast<const qr_decomposition<float>&>(QR), io::checksum(A), path, error);
+    }
+
+    kernelpp::maybe<irls_report> irls_mixed_policy::run(const irls_mixed_state& state,
+        const ndspan<double> y, double tol, uint32_t maxiter, ndspan<double> x)
+    {
+        return kernelpp::run<solve_irls_mixed>(
+            xtl::any_cast<const qr_decomposition<float>&>(state.QR),
+            xtl::any_cast<const xt::xtensor<double, 2>&>(state.Q),
+            state.A, y, tol, maxiter, x);
     }
       
 
@@ -84,12 +444,18 @@ namespace ss
             assert (dim<1>(A) == x.size()
                 &&  dim<0>(A) == y.size());
 
-            size_t m = dim<0>(A), n = dim<1>(A);
+            /* any layout of A, as well as strided x and y */
+            blas::xgemv<T>(CblasNoTrans, 1.0, A, x, 0.0, y);
+        }
 
-            blas::xgemv(CblasRowMajor, CblasNoTrans, m, n, 1.0,
-                A.storage_cbegin(), n,
-                x.storage_cbegin(), 1, 0.0,
-                y.storage_begin(), 1);
+        template <typename T>
+        void reconstruct_signal(
+            const csc_span<T> A, const ndspan<T> x, ndspan<T> y)
+        {
+            assert (dim<1>(A) == x.size()
+                &&  dim<0>(A) == y.size());
+
+            sparse::gemv<T>(CblasNoTrans, 1.0, A, x, 0.0, y);
         }
     }
 
@@ -110,4 +476,415 @@ namespace ss
     void norm_l1(ndspan<double, 2> A) {
         l1<double>(A);
     }
+
+    void reconstruct_signal(
+        const csc_span<float> A, const ndspan<float> x, ndspan<float> y) {
+        detail::reconstruct_signal(A, x, y);
+    }
+
+    void reconstruct_signal(
+        const csc_span<double> A, const ndspan<double> x, ndspan<double> y) {
+        detail::reconstruct_signal(A, x, y);
+    }
+
+    void norm_l1(csc_span<float> A) {
+        l1<float>(A);
+    }
+
+    void norm_l1(csc_span<double> A) {
+        l1<double>(A);
+    }
+
+    void class_residuals(const ndspan<float, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<float> y, const ndspan<float> x, ndspan<float> residuals) {
+        residuals_by_class<float>(A, labels, y, x, residuals);
+    }
+
+    void class_residuals(const ndspan<double, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<double> y, const ndspan<double> x, ndspan<double> residuals) {
+        residuals_by_class<double>(A, labels, y, x, residuals);
+    }
+
+    void class_residuals(const ndspan<float, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<float, 2> Y, const ndspan<float, 2> X, ndspan<float, 2> residuals) {
+        residuals_by_class<float>(A, labels, Y, X, residuals);
+    }
+
+    void class_residuals(const ndspan<double, 2> A, const ndspan<uint32_t> labels,
+        const ndspan<double, 2> Y, const ndspan<double, 2> X, ndspan<double, 2> residuals) {
+        residuals_by_class<double>(A, labels, Y, X, residuals);
+    }
+
+
+    /* Pool ---------------------------------------------------------------- */
+
+    bool detail::pin_thread(int cpu)
+    {
+#if defined(__linux__)
+        if (cpu < 0 || cpu >= CPU_SETSIZE) { return false; }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    bool detail::pin_thread(const std::vector<int>& cpus)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) { CPU_SET(cpu, &set); }
+        }
+        if (CPU_COUNT(&set) == 0) { return false; }
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    namespace
+    {
+        /* parses a sysfs cpu list, e.g. "0-7,16-23" */
+        std::vector<int> parse_cpu_list(const std::string& list)
+        {
+            std::vector<int> cpus;
+            size_t pos = 0;
+
+            while (pos < list.size()) {
+                size_t end = list.find(',', pos);
+                if (end == std::string::npos) { end = list.size(); }
+
+                const std::string range = list.substr(pos, end - pos);
+                const size_t dash = range.find('-');
+                try {
+                    const int lo = std::stoi(range.substr(0, dash));
+                    const int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+
+                    for (int cpu = lo; cpu <= hi; cpu++) { cpus.push_back(cpu); }
+                }
+                catch (const std::exception&) {
+                    return {};
+                }
+                pos = end + 1;
+            }
+            return cpus;
+        }
+
+        /* the libnuma routines used, resolved when the library can be loaded */
+        struct libnuma
+        {
+            void* (*alloc_onnode)(size_t, int) = nullptr;
+            void (*free)(void*, size_t) = nullptr;
+
+            libnuma()
+            {
+#if defined(__linux__)
+                void* handle = ::dlopen("libnuma.so.1", RTLD_NOW | RTLD_LOCAL);
+                if (!handle) { handle = ::dlopen("libnuma.so", RTLD_NOW | RTLD_LOCAL); }
+                if (!handle) { return; }
+
+                auto available = reinterpret_cast<int(*)()>(::dlsym(handle, "numa_available"));
+                alloc_onnode = reinterpret_cast<void*(*)(size_t, int)>(::dlsym(handle, "numa_alloc_onnode"));
+                free = reinterpret_cast<void(*)(void*, size_t)>(::dlsym(handle, "numa_free"));
+
+                /* the library stays loaded, as memory it allocated may outlive us */
+                if (!available || available() < 0 || !alloc_onnode || !free) {
+                    alloc_onnode = nullptr;
+                    free = nullptr;
+                }
+#endif
+            }
+
+            bool loaded() const { return alloc_onnode != nullptr; }
+
+            static const libnuma& get() {
+                static const libnuma instance;
+                return instance;
+            }
+        };
+    }
+
+    std::vector<detail::numa_node> detail::numa_nodes()
+    {
+        std::vector<numa_node> nodes;
+#if defined(__linux__)
+        const std::string root = "/sys/devices/system/node/";
+
+        DIR* dir = ::opendir(root.c_str());
+        if (!dir) { return nodes; }
+
+        while (const dirent* entry = ::readdir(dir))
+        {
+            const std::string name = entry->d_name;
+            if (name.size() < 5 || name.compare(0, 4, "node") != 0
+                    || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+
+            std::ifstream file(root + name + "/cpulist");
+            std::string list;
+            if (!std::getline(file, list)) { continue; }
+
+            auto cpus = parse_cpu_list(list);
+            if (!cpus.empty()) { nodes.push_back({ std::stoi(name.substr(4)), std::move(cpus) }); }
+        }
+        ::closedir(dir);
+
+        std::sort(nodes.begin(), nodes.end(),
+            [](const numa_node& a, const numa_node& b) { return a.id < b.id; });
+#endif
+        return nodes;
+    }
+
+    void* detail::numa_allocate(size_t bytes, int node)
+    {
+        const libnuma& numa = libnuma::get();
+        if (!numa.loaded()) {
+            return aligned_allocate(bytes, cache_line);
+        }
+
+        void* p = numa.alloc_onnode(bytes, node);
+        if (!p) { throw std::bad_alloc(); }
+        return p;
+    }
+
+    void detail::numa_deallocate(void* p, size_t bytes) noexcept
+    {
+        const libnuma& numa = libnuma::get();
+        if (!numa.loaded()) {
+            aligned_deallocate(p);
+        }
+        else if (p) {
+            numa.free(p, bytes);
+        }
+    }
+
+
+    /* Streaming ----------------------------------------------------------- */
+
+    template <typename T>
+    struct homotopy_stream<T>::impl
+    {
+        impl(const ndspan<T, 2> A, T tolerance, std::uint32_t max_iterations, size_t capacity)
+            : window(A)
+            , tolerance{ tolerance }
+            , max_iterations{ max_iterations }
+            , slots{ capacity + 1 }
+            , solutions(xt::zeros<T>({ capacity + 1, dim<1>(A) }))
+            , reports(capacity + 1)
+        {}
+
+        homotopy_window<T> window;
+        const T tolerance;
+        const std::uint32_t max_iterations;
+        size_t head{ 0 };
+
+        /*  The ring of solutions, written by the thread solving and read by
+            one other; the slot at write is never read, so each solve is
+            written there, and published only if the ring isn't full */
+        const size_t slots;
+        xt::xtensor<T, 2> solutions;
+        std::vector<homotopy_report> reports;
+
+        std::atomic<size_t> write{ 0 }, read{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+
+        solve_result solve(size_t first, const ndspan<T> values)
+        {
+            const size_t n = dim<1>(window.A);
+            const size_t w = write.load(std::memory_order_relaxed);
+
+            auto result = kernelpp::run<solve_homotopy_window>(window, first, values,
+                tolerance, max_iterations, as_span(solutions.raw_data() + w * n, n));
+
+            if (result.template is<homotopy_report>()) {
+                reports[w] = result.template get<homotopy_report>();
+
+                const size_t next = (w + 1) % slots;
+                if (next == read.load(std::memory_order_acquire)) {
+                    dropped++;
+                }
+                else {
+                    write.store(next, std::memory_order_release);
+                }
+            }
+            return result;
+        }
+    };
+
+    template <typename T>
+    homotopy_stream<T>::homotopy_stream(const ndspan<T, 2> A,
+        T tolerance, std::uint32_t max_iterations, size_t capacity)
+        : m{ new impl(A, tolerance, max_iterations, std::max(capacity, size_t(1))) }
+    {}
+
+    template <typename T>
+    homotopy_stream<T>::~homotopy_stream() = default;
+
+    template <typename T>
+    typename homotopy_stream<T>::solve_result
+    homotopy_stream<T>::push(const ndspan<T> samples)
+    {
+        auto result = m->solve(m->head, samples);
+        m->head = (m->head + samples.size()) % dim<0>(m->window.A);
+
+        return result;
+    }
+
+    template <typename T>
+    typename homotopy_stream<T>::solve_result
+    homotopy_stream<T>::push(const ndspan<T> samples, const solve_control& control)
+    {
+        detail::control_scope scope(control);
+        return push(samples);
+    }
+
+    template <typename T>
+    typename homotopy_stream<T>::solve_result
+    homotopy_stream<T>::update(size_t first, const ndspan<T> values)
+    {
+        return m->solve(first, values);
+    }
+
+    template <typename T>
+    bool homotopy_stream<T>::pop(ndspan<T> x, homotopy_report* report)
+    {
+        const size_t r = m->read.load(std::memory_order_relaxed);
+        if (r == m->write.load(std::memory_order_acquire)) { return false; }
+
+        const size_t n = dim<1>(m->window.A);
+        const T* s = m->solutions.raw_data() + r * n;
+
+        std::copy(s, s + n, x.begin());
+        if (report) { *report = m->reports[r]; }
+
+        m->read.store((r + 1) % m->slots, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    size_t homotopy_stream<T>::head() const { return m->head; }
+
+    template <typename T>
+    std::uint64_t homotopy_stream<T>::dropped() const { return m->dropped.load(); }
+
+    template class homotopy_stream<float>;
+    template class homotopy_stream<double>;
+
+
+    /* BLAS ---------------------------------------------------------------- */
+
+    bool set_blas_backend(blas_backend backend, const std::string& path) {
+        return blas::cblas::select(backend, path);
+    }
+
+    blas_info get_blas_info() {
+        return blas::cblas::get()->info();
+    }
+
+    bool blas_profiling_enabled() {
+#if defined(SS_BLAS_PROFILING)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::vector<blas_op_profile> get_blas_profile() {
+        return blas::profile::snapshot();
+    }
+
+    void reset_blas_profile() {
+        blas::profile::reset();
+    }
+
+    namespace
+    {
+        /*  the scopes limiting every thread, and the count the last of
+            them restores: the count in use before the first, or the one
+            last set by set_blas_threads while they were open */
+        std::mutex global_scopes_lock;
+        size_t global_scopes = 0;
+        int global_previous = 0;
+    }
+
+    void set_blas_threads(int threads) {
+        std::lock_guard<std::mutex> lock(global_scopes_lock);
+        if (global_scopes > 0) {
+            global_previous = threads;
+            return;
+        }
+        blas::cblas::get()->set_threads(threads);
+    }
+
+    int get_blas_threads() {
+        return blas::cblas::get()->threads();
+    }
+
+    blas_thread_scope::blas_thread_scope(int threads)
+        : _previous{ blas::cblas::get()->set_local_threads(threads) }
+        , _local{ _previous >= 0 }
+        , _global{ false }
+    {
+        if (_local) { return; }
+
+        /* no thread-local setting, so limit every thread */
+        std::lock_guard<std::mutex> lock(global_scopes_lock);
+        if (global_scopes == 0) {
+            /* a count which can't be read can't be restored, so is left alone */
+            const int previous = blas::cblas::get()->threads();
+            if (previous <= 0) { return; }
+
+            global_previous = previous;
+        }
+        blas::cblas::get()->set_threads(threads);
+
+        global_scopes++;
+        _global = true;
+    }
+
+    blas_thread_scope::~blas_thread_scope()
+    {
+        if (_local) {
+            blas::cblas::get()->set_local_threads(_previous);
+        }
+        else if (_global) {
+            std::lock_guard<std::mutex> lock(global_scopes_lock);
+            if (--global_scopes == 0) {
+                blas::cblas::get()->set_threads(global_previous);
+            }
+        }
+    }
+
+    namespace detail
+    {
+        namespace
+        {
+            thread_local const solve_control* current = nullptr;
+        }
+
+        control_scope::control_scope(const solve_control& control)
+            : _previous{ current }
+        {
+            current = &control;
+        }
+
+        control_scope::~control_scope() {
+            current = _previous;
+        }
+
+        const solve_control* current_control() {
+            return current;
+        }
+    }
 }
\ No newline at end of file
@@ -1,12 +1,19 @@
 #include <ss/ndspan.h>
+#include <ss/blas.h>
+#include <linalg/blas_wrapper.h>
 
+#include <xtensor/xtensor.hpp>
 #include <xtensor/xbuilder.hpp>
 #include <xtensor/xeval.hpp>
 #include <xtensor/xnoalias.hpp>
 #include <xtensor/xio.hpp>
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <array>
+#include <future>
+#include <string>
+#include <thread>
 #include <vector>
 
 TEST(ndspan, 2d_constructors)
@@ -115,4 +122,181 @@ TEST(ndspan, xview_compatibility)
         EXPECT_EQ(4, span(1));
         EXPECT_EQ(6, span(2));
     }
-}
\ No newline at end of file
+}
+
+TEST(blas, thread_scope)
+{
+    int threads = ss::get_blas_threads();
+    {
+        ss::blas_thread_scope scope;
+        EXPECT_LE(ss::get_blas_threads(), std::max(1, threads));
+    }
+    /* the previous count is restored */
+    EXPECT_EQ(threads, ss::get_blas_threads());
+
+    /* by scopes on two threads which end in the order they began */
+    std::promise<void> first_started, second_started, first_ended;
+
+    std::thread first([&] {
+        ss::blas_thread_scope scope;
+        first_started.set_value();
+        second_started.get_future().wait();
+    });
+    std::thread second([&] {
+        first_started.get_future().wait();
+        ss::blas_thread_scope scope;
+        second_started.set_value();
+        first_ended.get_future().wait();
+    });
+
+    first.join();
+    first_ended.set_value();
+    second.join();
+
+    EXPECT_EQ(threads, ss::get_blas_threads());
+
+    /* a count set during a scope is the one in use after it */
+    ss::set_blas_threads(2);
+    const bool settable = ss::get_blas_threads() == 2;
+    ss::set_blas_threads(threads);
+
+    if (settable) {
+        {
+            ss::blas_thread_scope scope;
+            EXPECT_TRUE(scope.limited());
+
+            ss::set_blas_threads(2);
+        }
+        EXPECT_EQ(2, ss::get_blas_threads());
+        ss::set_blas_threads(threads);
+    }
+}
+
+TEST(blas, concurrent_first_use)
+{
+    /*  every thread starts at once, and each sees the same table; ctest
+     *  also runs this test alone, so the library is loaded by these threads
+     */
+    const size_t n = std::max(4u, std::thread::hardware_concurrency());
+
+    std::promise<void> go;
+    std::shared_future<void> start = go.get_future().share();
+
+    std::vector<const ss::blas::routines*> tables(n);
+    std::vector<decltype(ss::blas::routines::ddot)> ddots(n);
+    std::vector<double> dots(n);
+    std::vector<std::thread> threads;
+
+    const std::vector<double> ones(64, 1.0);
+
+    for (size_t t = 0; t < n; t++) {
+        threads.emplace_back([&, t] {
+            start.wait();
+            tables[t] = &ss::blas::table();
+            ddots[t]  = tables[t]->ddot;
+            dots[t]   = ss::blas::xdot(64, ones.data(), 1, ones.data(), 1);
+        });
+    }
+    go.set_value();
+    for (auto& t : threads) { t.join(); }
+
+    for (size_t t = 0; t < n; t++) {
+        EXPECT_EQ(tables[0], tables[t]);
+        EXPECT_EQ(tables[0]->ddot, ddots[t]);
+        EXPECT_NE(nullptr, ddots[t]);
+        EXPECT_EQ(64.0, dots[t]);
+    }
+}
+
+TEST(blas, parse_backend)
+{
+    ss::blas_backend backend = ss::blas_backend::linked;
+
+    EXPECT_TRUE(ss::blas::parse_backend("haswell", backend));
+    EXPECT_EQ(ss::blas_backend::openblas_haswell, backend);
+    EXPECT_TRUE(ss::blas::parse_backend("openblas", backend));
+    EXPECT_EQ(ss::blas_backend::system_openblas, backend);
+    EXPECT_TRUE(ss::blas::parse_backend("auto", backend));
+    EXPECT_EQ(ss::blas_backend::automatic, backend);
+
+    /* names are matched exactly, and an unknown name leaves the backend */
+    backend = ss::blas_backend::mkl;
+    EXPECT_FALSE(ss::blas::parse_backend("MKL", backend));
+    EXPECT_FALSE(ss::blas::parse_backend("atlas", backend));
+    EXPECT_FALSE(ss::blas::parse_backend("", backend));
+    EXPECT_EQ(ss::blas_backend::mkl, backend);
+}
+
+TEST(blas, environment_request)
+{
+    auto none = ss::blas::environment_request(nullptr, nullptr);
+    EXPECT_FALSE(none.requested);
+    EXPECT_TRUE(none.error.empty());
+
+    auto named = ss::blas::environment_request("blis", nullptr);
+    EXPECT_TRUE(named.requested);
+    EXPECT_EQ(ss::blas_backend::blis, named.backend);
+    EXPECT_TRUE(named.path.empty());
+    EXPECT_TRUE(named.error.empty());
+
+    auto path = ss::blas::environment_request(nullptr, "/opt/lib/libblas.so");
+    EXPECT_TRUE(path.requested);
+    EXPECT_EQ(ss::blas_backend::automatic, path.backend);
+    EXPECT_EQ("/opt/lib/libblas.so", path.path);
+
+    /* an unknown name falls back to the automatic backend, with the reason */
+    auto unknown = ss::blas::environment_request("atlas", nullptr);
+    EXPECT_EQ(ss::blas_backend::automatic, unknown.backend);
+    EXPECT_NE(std::string::npos, unknown.error.find("atlas"));
+}
+
+TEST(blas, selection)
+{
+    /* once loaded, the backend in use can't be changed */
+    const ss::blas_info info = ss::get_blas_info();
+
+    EXPECT_FALSE(ss::set_blas_backend(ss::blas_backend::mkl));
+    EXPECT_EQ(info.backend, ss::get_blas_info().backend);
+    EXPECT_EQ(info.library, ss::get_blas_info().library);
+}
+
+TEST(blas, profile)
+{
+    ss::reset_blas_profile();
+
+    /* large enough to be passed to blas */
+    xt::xtensor<double, 2> A = xt::ones<double>({ 64, 64 });
+    xt::xtensor<double, 1> x = xt::ones<double>({ 64 });
+    xt::xtensor<double, 1> y = xt::zeros<double>({ 64 });
+
+    ss::blas::xgemv(CblasTrans, 1.0, A, x, 0.0, y);
+    ss::blas::xgemv(CblasTrans, 1.0, A, x, 0.0, y);
+
+    auto profile = ss::get_blas_profile();
+
+    if (!ss::blas_profiling_enabled()) {
+        EXPECT_TRUE(profile.empty());
+        return;
+    }
+
+    ASSERT_EQ(1, profile.size());
+    EXPECT_EQ("dgemv_t", profile[0].op);
+    EXPECT_EQ(2, profile[0].calls);
+    EXPECT_EQ(2 * 2 * 64 * 64, profile[0].flops);
+
+    /* a call taken by the built-in kernels isn't counted as blas */
+    ss::reset_blas_profile();
+
+    xt::xtensor<double, 2> B = xt::ones<double>({ 4, 4 });
+    xt::xtensor<double, 1> u = xt::ones<double>({ 4 });
+    xt::xtensor<double, 1> v = xt::zeros<double>({ 4 });
+
+    ss::blas::xgemv(CblasTrans, 1.0, B, u, 0.0, v);
+
+    profile = ss::get_blas_profile();
+    ASSERT_EQ(1, profile.size());
+    EXPECT_EQ(ss::blas::small::eligible(4, 4) ? "dgemv_t_small" : "dgemv_t", profile[0].op);
+
+    ss::reset_blas_profile();
+    EXPECT_TRUE(ss::get_blas_profile().empty());
+}
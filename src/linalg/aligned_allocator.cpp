@@ -0,0 +1,67 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "linalg/aligned_allocator.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__unix__)
+# include <sys/mman.h>
+#endif
+
+namespace ss {
+namespace detail
+{
+    namespace
+    {
+        /* the transparent huge page size of x86-64 and aarch64 (4k pages) */
+        constexpr size_t huge_page = size_t(2) << 20;
+    }
+
+    bool huge_pages_enabled()
+    {
+        static const bool enabled = [] {
+            const char* value = std::getenv("SS_HUGE_PAGES");
+            return value && std::strcmp(value, "0") != 0 && *value != '\0';
+        }();
+
+        return enabled;
+    }
+
+    void* aligned_allocate(size_t bytes, size_t alignment)
+    {
+        const bool huge = bytes >= huge_page && huge_pages_enabled();
+        if (huge) {
+            /* whole huge pages, so no other allocation shares them */
+            alignment = huge_page;
+            bytes = (bytes + huge_page - 1) / huge_page * huge_page;
+        }
+
+        void* p = nullptr;
+        if (posix_memalign(&p, alignment, bytes == 0 ? alignment : bytes) != 0) {
+            throw std::bad_alloc();
+        }
+
+#if defined(MADV_HUGEPAGE)
+        /* only a hint; the allocation is valid whether or not it is taken */
+        if (huge) { ::madvise(p, bytes, MADV_HUGEPAGE); }
+#endif
+        return p;
+    }
+
+    void aligned_deallocate(void* p) noexcept {
+        std::free(p);
+    }
+}}
@@ -0,0 +1,103 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace ss
+{
+    /* the alignment of every aligned allocation, and the unit of padding */
+    constexpr size_t cache_line = 64;
+
+    /*  the smallest count of elements of T, not less than n, which occupies
+     *  a whole number of cache lines
+     */
+    template <typename T>
+    constexpr size_t padded(size_t n)
+    {
+        static_assert(cache_line % sizeof(T) == 0, "T must divide a cache line");
+        return (n + cache_line / sizeof(T) - 1) / (cache_line / sizeof(T)) * (cache_line / sizeof(T));
+    }
+
+    namespace detail
+    {
+        /*  allocates `bytes` aligned to `alignment`. When enabled with
+         *  SS_HUGE_PAGES=1, allocations of at least one huge page are
+         *  instead aligned to, and advised to be backed by, huge pages.
+         *
+         *  throws std::bad_alloc on failure, as any allocator
+         */
+        void* aligned_allocate(size_t bytes, size_t alignment);
+
+        void aligned_deallocate(void* p) noexcept;
+
+        /* whether SS_HUGE_PAGES is set */
+        bool huge_pages_enabled();
+    }
+
+    /*  A standard allocator of memory aligned to Alignment bytes, a cache
+     *  line by default, for std::vector and xtensor containers.
+     */
+    template <typename T, size_t Alignment = cache_line>
+    struct aligned_allocator
+    {
+        static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+            "Alignment must be a power of two, and at least that of T");
+
+        using value_type      = T;
+        using pointer         = T*;
+        using const_pointer   = const T*;
+        using reference       = T&;
+        using const_reference = const T&;
+        using size_type       = size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <typename U>
+        struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+        aligned_allocator() noexcept = default;
+
+        template <typename U>
+        aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+        T* allocate(size_t n)
+        {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T)) { throw std::bad_alloc(); }
+            return static_cast<T*>(detail::aligned_allocate(n * sizeof(T), Alignment));
+        }
+
+        void deallocate(T* p, size_t) noexcept {
+            detail::aligned_deallocate(p);
+        }
+
+        size_t max_size() const noexcept {
+            return std::numeric_limits<size_t>::max() / sizeof(T);
+        }
+
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) { ::new ((void*)p) U(std::forward<Args>(args)...); }
+
+        template <typename U>
+        void destroy(U* p) { p->~U(); }
+    };
+
+    template <typename T, typename U, size_t A>
+    bool operator==(const aligned_allocator<T, A>&, const aligned_allocator<U, A>&) { return true; }
+
+    template <typename T, typename U, size_t A>
+    bool operator!=(const aligned_allocator<T, A>&, const aligned_allocator<U, A>&) { return false; }
+}
@@ -0,0 +1,50 @@
+#include <linalg/common.h>
+
+#include <xtensor/xtensor.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    bool aligned(const void* p, size_t alignment = ss::cache_line) {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    }
+}
+
+TEST(aligned_allocator, containers)
+{
+    for (size_t n : { 1, 3, 17, 1000 })
+    {
+        ss::aligned_vector<float> v(n);
+        ss::aligned_vector<char> c(n);
+        ss::vec<double> x = xt::zeros<double>({ n });
+        ss::mat<float> A = xt::zeros<float>({ n, size_t(3) });
+
+        EXPECT_TRUE(aligned(v.data()));
+        EXPECT_TRUE(aligned(c.data()));
+        EXPECT_TRUE(aligned(x.raw_data()));
+        EXPECT_TRUE(aligned(A.raw_data()));
+    }
+
+    /* a huge page or more, whether or not SS_HUGE_PAGES is set */
+    ss::aligned_vector<double> large(size_t(3) << 20, 1.0);
+    EXPECT_TRUE(aligned(large.data()));
+    EXPECT_EQ(1.0, large.back());
+
+    /* over-aligned */
+    std::vector<int, ss::aligned_allocator<int, 4096>> page(10);
+    EXPECT_TRUE(aligned(page.data(), 4096));
+}
+
+TEST(aligned_allocator, padded)
+{
+    EXPECT_EQ(0u,  ss::padded<float>(0));
+    EXPECT_EQ(16u, ss::padded<float>(1));
+    EXPECT_EQ(16u, ss::padded<float>(16));
+    EXPECT_EQ(32u, ss::padded<float>(17));
+    EXPECT_EQ(8u,  ss::padded<double>(5));
+    EXPECT_EQ(64u, ss::padded<char>(64));
+}
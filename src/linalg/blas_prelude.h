@@ -18,6 +18,27 @@ limitations under the License.  */
 #if defined(BLAS_OpenBLAS)
 # include <openblas_config.h>
 # include <cblas.h>
+#elif defined(BLAS_STATIC)
+/* a reference (or other) cblas, without OpenBLAS' integer type */
+# include <cblas.h>
+typedef int blasint;
 #else
 static_assert(false, "Couldn't determine which BLAS to use!");
-#endif
\ No newline at end of file
+#endif
+
+#if defined(BLAS_STATIC) && defined(BLAS_LAPACKE)
+/* the LAPACKE routines used, when linked statically */
+extern "C"
+{
+    blasint LAPACKE_spotrf(int, char, blasint, float*, blasint);
+    blasint LAPACKE_dpotrf(int, char, blasint, double*, blasint);
+    blasint LAPACKE_spotrs(int, char, blasint, blasint, const float*, blasint, float*, blasint);
+    blasint LAPACKE_dpotrs(int, char, blasint, blasint, const double*, blasint, double*, blasint);
+    blasint LAPACKE_sgeqrf(int, blasint, blasint, float*, blasint, float*);
+    blasint LAPACKE_dgeqrf(int, blasint, blasint, double*, blasint, double*);
+    blasint LAPACKE_sormqr(int, char, char, blasint, blasint, blasint, const float*, blasint, const float*, float*, blasint);
+    blasint LAPACKE_dormqr(int, char, char, blasint, blasint, blasint, const double*, blasint, const double*, double*, blasint);
+    blasint LAPACKE_strtrs(int, char, char, char, blasint, blasint, const float*, blasint, float*, blasint);
+    blasint LAPACKE_dtrtrs(int, char, char, char, blasint, blasint, const double*, blasint, double*, blasint);
+}
+#endif
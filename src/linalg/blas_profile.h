@@ -0,0 +1,102 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include "ss/ss_config.h"
+#include "ss/blas.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace ss {
+namespace blas {
+namespace profile
+{
+    /* operations recorded by the profiler, for each precision */
+    enum class op : size_t
+    {
+        nrm2, gemv_n, gemv_t, gemm, ger, dot, scal, iamax,
+        trsm, trsv, syrk, potrf, potrs, geqrf, ormqr, trtrs,
+
+        /* the built-in kernels for small operands, see small_kernels.h */
+        gemv_n_small, gemv_t_small, ger_small, dot_small, scal_small,
+
+        /* products with the 16-bit, int8 and CSC storage of a matrix */
+        gemv_n_half, gemv_t_half, gemv_t_int8, gemv_n_csc, gemv_t_csc,
+
+        count
+    };
+
+    struct counters
+    {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> nanoseconds;
+        std::atomic<uint64_t> flops;
+        std::atomic<uint64_t> bytes;
+    };
+
+    /* the counters of an operation in single (or double) precision */
+    counters& counter(op o, bool is_double);
+
+    /* copies the counters of all operations which have been called */
+    std::vector<blas_op_profile> snapshot();
+
+    /* zeroes all counters */
+    void reset();
+
+    /*  Records a call for the lifetime of the scope; the FLOP and byte
+     *  counts are estimates computed from the operand dimensions.
+     */
+    template <typename T>
+    class scope
+    {
+      public:
+        scope(op o, double flops, double bytes)
+            : _c(counter(o, sizeof(T) == sizeof(double)))
+            , _start(std::chrono::steady_clock::now())
+        {
+            _c.calls.fetch_add(1, std::memory_order_relaxed);
+            _c.flops.fetch_add(uint64_t(flops), std::memory_order_relaxed);
+            _c.bytes.fetch_add(uint64_t(bytes * sizeof(T)), std::memory_order_relaxed);
+        }
+
+        ~scope()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - _start;
+            _c.nanoseconds.fetch_add(uint64_t(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                std::memory_order_relaxed);
+        }
+
+      private:
+        counters& _c;
+        std::chrono::steady_clock::time_point _start;
+    };
+}}}
+
+/*  Records the enclosing wrapper call as the profile::op `o` on elements of
+ *  type `T`. None of the arguments are evaluated unless profiling was
+ *  enabled with ${ss}_WITH_BLAS_PROFILING; `elems` is the number of elements
+ *  read and written.
+ */
+#if defined(SS_BLAS_PROFILING)
+# define SS_BLAS_PROFILE(T, o, flops, elems)                      \
+    ::ss::blas::profile::scope<T> _ss_blas_profile_scope{          \
+        (o), double(flops), double(elems) }
+#else
+# define SS_BLAS_PROFILE(T, o, flops, elems) ((void)0)
+#endif
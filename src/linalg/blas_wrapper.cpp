@@ -14,11 +14,186 @@ limitations under the License.  */
 #include "linalg/blas_wrapper.h"
 #include "linalg/blas_prelude.h"
 
-#include <kernelpp/kernel_invoke.h>
+#if !defined(BLAS_STATIC)
+# include <kernelpp/kernel_invoke.h>
+# include <dlfcn.h>
+#endif
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace ss {
 namespace blas
 {
+    /* profile ------------------------------------------------------------- */
+
+    namespace profile
+    {
+        namespace
+        {
+            constexpr size_t num_ops = static_cast<size_t>(op::count);
+
+            const char* const op_names[num_ops] = {
+                "nrm2", "gemv_n", "gemv_t", "gemm", "ger", "dot", "scal", "iamax",
+                "trsm", "trsv", "syrk", "potrf", "potrs", "geqrf", "ormqr", "trtrs",
+                "gemv_n_small", "gemv_t_small", "ger_small", "dot_small", "scal_small",
+                "gemv_n_half", "gemv_t_half", "gemv_t_int8", "gemv_n_csc", "gemv_t_csc"
+            };
+
+            /* single precision counters, followed by double */
+            counters all_counters[2 * num_ops];
+        }
+
+        counters& counter(op o, bool is_double) {
+            return all_counters[static_cast<size_t>(o) + (is_double ? num_ops : 0)];
+        }
+
+        std::vector<blas_op_profile> snapshot()
+        {
+            std::vector<blas_op_profile> ops;
+
+            for (size_t i = 0; i < 2 * num_ops; i++)
+            {
+                const counters& c = all_counters[i];
+                const uint64_t calls = c.calls.load(std::memory_order_relaxed);
+
+                if (calls == 0) { continue; }
+
+                ops.push_back({
+                    std::string(i < num_ops ? "s" : "d") + op_names[i % num_ops],
+                    calls,
+                    c.nanoseconds.load(std::memory_order_relaxed) * 1e-9,
+                    c.flops.load(std::memory_order_relaxed),
+                    c.bytes.load(std::memory_order_relaxed)
+                });
+            }
+            return ops;
+        }
+
+        void reset()
+        {
+            for (counters& c : all_counters) {
+                c.calls.store(0, std::memory_order_relaxed);
+                c.nanoseconds.store(0, std::memory_order_relaxed);
+                c.flops.store(0, std::memory_order_relaxed);
+                c.bytes.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /* backend requests ---------------------------------------------------- */
+
+    bool parse_backend(const char* name, blas_backend& backend)
+    {
+        const std::pair<const char*, blas_backend> names[] = {
+            { "auto",     blas_backend::automatic },
+            { "nehalem",  blas_backend::openblas_nehalem },
+            { "haswell",  blas_backend::openblas_haswell },
+            { "skylakex", blas_backend::openblas_skylakex },
+            { "openblas", blas_backend::system_openblas },
+            { "blis",     blas_backend::blis },
+            { "mkl",      blas_backend::mkl }
+        };
+
+        for (auto& n : names) {
+            if (std::strcmp(n.first, name) == 0) {
+                backend = n.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    blas_request environment_request(const char* backend, const char* path)
+    {
+        blas_request req{ backend || path, blas_backend::automatic, path ? path : "", "" };
+
+        if (backend && !parse_backend(backend, req.backend)) {
+            req.error = std::string("unknown SS_BLAS_BACKEND '") + backend + "'";
+        }
+        return req;
+    }
+
+#if defined(BLAS_STATIC)
+
+    /* cblas (linked) ------------------------------------------------------ */
+
+    cblas::cblas()
+        : _fn(linked_routines)
+#if defined(BLAS_OpenBLAS)
+        , _set_threads{ &::openblas_set_num_threads }
+        , _get_threads{ &::openblas_get_num_threads }
+        , _set_local_threads{ nullptr }
+        , _get_parallel{ &::openblas_get_parallel }
+#else
+        , _set_threads{ nullptr }
+        , _get_threads{ nullptr }
+        , _set_local_threads{ nullptr }
+        , _get_parallel{ nullptr }
+#endif
+        , _bli_set_threads{ nullptr }
+        , _bli_get_threads{ nullptr }
+        , _backend{ blas_backend::linked }
+    {
+#if defined(BLAS_OpenBLAS)
+        _variant = ::openblas_get_corename();
+#endif
+    }
+
+    cblas::~cblas() = default;
+
+    cblas* cblas::get()
+    {
+        static cblas instance;
+        return &instance;
+    }
+
+    bool cblas::select(blas_backend, const std::string&) {
+        return false;
+    }
+
+#else
+
+    namespace
+    {
+        /* the backend selected through cblas::select */
+        blas_request& selected()
+        {
+            static blas_request s{ false, blas_backend::automatic, "", "" };
+            return s;
+        }
+
+        /* the backend selected through the api, or else the environment */
+        blas_request requested()
+        {
+            if (selected().requested) {
+                return selected();
+            }
+            return environment_request(std::getenv("SS_BLAS_BACKEND"), std::getenv("SS_BLAS_LIBRARY"));
+        }
+
+        /* file names to attempt to load for each backend */
+        std::vector<std::string> library_names(blas_backend backend)
+        {
+            switch (backend) {
+                case blas_backend::openblas_nehalem:  return { BLAS_RUNTIME_FILE };
+                case blas_backend::openblas_haswell:  return { BLAS_AVX_RUNTIME_FILE };
+#if defined(BLAS_AVX512_RUNTIME_FILE)
+                case blas_backend::openblas_skylakex: return { BLAS_AVX512_RUNTIME_FILE };
+#endif
+                case blas_backend::system_openblas:   return { "libopenblas.so.0", "libopenblas.so" };
+                case blas_backend::blis:              return { "libblis.so.4", "libblis.so" };
+                case blas_backend::mkl:               return { "libmkl_rt.so.2", "libmkl_rt.so" };
+                default:                              return {};
+            }
+        }
+    }
+
     /* cblas --------------------------------------------------------------- */
 
     using namespace kernelpp;
@@ -30,14 +205,168 @@ namespace blas
         template<compute_mode> static error_code op();
     };
 
+    cblas::cblas(const std::string& path, blas_backend backend)
+        : dlibxx::handle_fascade{ path.c_str() }
+        , _native{ nullptr }
+        , _set_threads{ nullptr }
+        , _get_threads{ nullptr }
+        , _set_local_threads{ nullptr }
+        , _get_parallel{ nullptr }
+        , _bli_set_threads{ nullptr }
+        , _bli_get_threads{ nullptr }
+        , _backend{ backend }
+        , _path{ path }
+    {
+        /* a second (non-loading) reference to the library, used to
+           resolve the symbols which the library may not export */
+        if (!error()) {
+            _native = ::dlopen(path.c_str(), RTLD_LAZY | RTLD_NOLOAD);
+        }
+
+        _fn.dnrm2  = symbol<decltype(::cblas_dnrm2)>("cblas_dnrm2");
+        _fn.snrm2  = symbol<decltype(::cblas_snrm2)>("cblas_snrm2");
+        _fn.dgemv  = symbol<decltype(::cblas_dgemv)>("cblas_dgemv");
+        _fn.sgemv  = symbol<decltype(::cblas_sgemv)>("cblas_sgemv");
+        _fn.sgemm  = symbol<decltype(::cblas_sgemm)>("cblas_sgemm");
+        _fn.dgemm  = symbol<decltype(::cblas_dgemm)>("cblas_dgemm");
+        _fn.dger   = symbol<decltype(::cblas_dger)>("cblas_dger");
+        _fn.sger   = symbol<decltype(::cblas_sger)>("cblas_sger");
+        _fn.ddot   = symbol<decltype(::cblas_ddot)>("cblas_ddot");
+        _fn.sdot   = symbol<decltype(::cblas_sdot)>("cblas_sdot");
+        _fn.dscal  = symbol<decltype(::cblas_dscal)>("cblas_dscal");
+        _fn.sscal  = symbol<decltype(::cblas_sscal)>("cblas_sscal");
+        _fn.idamax = symbol<decltype(::cblas_idamax)>("cblas_idamax");
+        _fn.isamax = symbol<decltype(::cblas_isamax)>("cblas_isamax");
+        _fn.strsm  = symbol<decltype(::cblas_strsm)>("cblas_strsm");
+        _fn.dtrsm  = symbol<decltype(::cblas_dtrsm)>("cblas_dtrsm");
+        _fn.strsv  = symbol<decltype(::cblas_strsv)>("cblas_strsv");
+        _fn.dtrsv  = symbol<decltype(::cblas_dtrsv)>("cblas_dtrsv");
+        _fn.ssyrk  = symbol<decltype(::cblas_ssyrk)>("cblas_ssyrk");
+        _fn.dsyrk  = symbol<decltype(::cblas_dsyrk)>("cblas_dsyrk");
+
+        _fn.spotrf = symbol<lapacke::potrf<float>>("LAPACKE_spotrf");
+        _fn.dpotrf = symbol<lapacke::potrf<double>>("LAPACKE_dpotrf");
+        _fn.spotrs = symbol<lapacke::potrs<float>>("LAPACKE_spotrs");
+        _fn.dpotrs = symbol<lapacke::potrs<double>>("LAPACKE_dpotrs");
+        _fn.sgeqrf = symbol<lapacke::geqrf<float>>("LAPACKE_sgeqrf");
+        _fn.dgeqrf = symbol<lapacke::geqrf<double>>("LAPACKE_dgeqrf");
+        _fn.sormqr = symbol<lapacke::ormqr<float>>("LAPACKE_sormqr");
+        _fn.dormqr = symbol<lapacke::ormqr<double>>("LAPACKE_dormqr");
+        _fn.strtrs = symbol<lapacke::trtrs<float>>("LAPACKE_strtrs");
+        _fn.dtrtrs = symbol<lapacke::trtrs<double>>("LAPACKE_dtrtrs");
+
+        _fn.lapack = _fn.spotrf && _fn.dpotrf && _fn.spotrs && _fn.dpotrs
+            && _fn.sgeqrf && _fn.dgeqrf && _fn.sormqr && _fn.dormqr
+            && _fn.strtrs && _fn.dtrtrs;
+
+        /* query the instruction set variant, where supported */
+        if (auto corename = symbol<char*()>("openblas_get_corename")) {
+            _variant = corename();
+        }
+        else if (auto arch = symbol<int()>("bli_arch_query_id")) {
+            if (auto arch_string = symbol<const char*(int)>("bli_arch_string")) {
+                _variant = arch_string(arch());
+            }
+        }
+        else if (auto version = symbol<void(char*, int)>("MKL_Get_Version_String")) {
+            char buf[256] = { 0 };
+            version(buf, sizeof(buf) - 1);
+            _variant = buf;
+        }
+
+        /* thread control: OpenBLAS, then MKL, then BLIS */
+        if ((_set_threads = symbol<void(int)>("openblas_set_num_threads"))) {
+            _get_threads = symbol<int()>("openblas_get_num_threads");
+            _set_local_threads = symbol<int(int)>("openblas_set_num_threads_local");
+            _get_parallel = symbol<int()>("openblas_get_parallel");
+        }
+        else if ((_set_threads = symbol<void(int)>("MKL_Set_Num_Threads"))) {
+            _get_threads = symbol<int()>("MKL_Get_Max_Threads");
+            _set_local_threads = symbol<int(int)>("MKL_Set_Num_Threads_Local");
+        }
+        else {
+            _bli_set_threads = symbol<void(int64_t)>("bli_thread_set_num_threads");
+            _bli_get_threads = symbol<int64_t()>("bli_thread_get_num_threads");
+        }
+    }
+
+    cblas::~cblas()
+    {
+        if (_native) { ::dlclose(_native); }
+    }
+
+    template <typename F>
+    F* cblas::symbol(const char* name) const
+    {
+        return _native ? reinterpret_cast<F*>(::dlsym(_native, name)) : nullptr;
+    }
+
+    bool cblas::loaded() const
+    {
+        return !error() && _fn.dnrm2 && _fn.snrm2 && _fn.dgemv && _fn.sgemv
+            && _fn.sgemm && _fn.dgemm && _fn.dger && _fn.sger
+            && _fn.ddot && _fn.sdot && _fn.dscal && _fn.sscal
+            && _fn.idamax && _fn.isamax && _fn.strsm && _fn.dtrsm
+            && _fn.strsv && _fn.dtrsv && _fn.ssyrk && _fn.dsyrk;
+    }
+
+    namespace
+    {
+        std::once_flag configured;
+        std::atomic<bool> is_loaded{ false };
+
+        /* guards selected(), between select() and configure() */
+        std::mutex selection_lock;
+    }
+
     cblas* cblas::get()
     {
-        if (!m) { configure(); }
+        std::call_once(configured, [] {
+            std::lock_guard<std::mutex> lock(selection_lock);
+
+            configure();
+            is_loaded.store(true, std::memory_order_release);
+        });
         return m.get();
     }
 
+    bool cblas::select(blas_backend backend, const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(selection_lock);
+        if (is_loaded.load(std::memory_order_acquire)) { return false; }
+
+        selected() = { true, backend, path, "" };
+        return true;
+    }
+
+    bool cblas::load(blas_backend backend, const std::string& path)
+    {
+        std::vector<std::string> files = path.empty() ?
+            library_names(backend) : std::vector<std::string>{ path };
+
+        for (const std::string& file : files) {
+            m.reset(new cblas(file, backend));
+            if (m->loaded()) { return true; }
+        }
+        return false;
+    }
+
     void cblas::configure()
     {
+        blas_request req = requested();
+        std::string error = req.error;
+
+        if (req.requested && (req.backend != blas_backend::automatic || !req.path.empty())) {
+            if (load(req.backend, req.path)) {
+                m->_error = error;
+                return;
+            }
+
+            error = std::string("failed to load the requested cblas (") + (m && m->error() ?
+                m->error().value() : std::string("no library for this backend"))
+                + "), using the bundled OpenBLAS";
+        }
+
         /* if an error occured when loading blas, abort */
         if (kernelpp::run<loader>()) {
             const char* msg = m && m->error() ?
@@ -46,6 +375,7 @@ namespace blas
             fprintf(stderr, "%s\n", msg);
             abort();
         }
+        m->_error = error;
     }
 
     /* static cblas instance */
@@ -54,15 +384,63 @@ namespace blas
     /* avx cpu blas */
     template <> error_code cblas::loader::op<compute_mode::AVX>()
     {
-        cblas::m.reset(new cblas(BLAS_AVX_RUNTIME_FILE));
-        return cblas::m->error() ? error_code::KERNEL_FAILED : error_code::NONE;
+#if defined(BLAS_AVX512_RUNTIME_FILE) && defined(__GNUC__)
+        /* prefer the avx-512 build where the cpu supports it */
+        if (__builtin_cpu_supports("avx512f")
+            && load(blas_backend::openblas_skylakex, "")) {
+            return error_code::NONE;
+        }
+#endif
+        return load(blas_backend::openblas_haswell, "") ?
+            error_code::NONE : error_code::KERNEL_FAILED;
     }
 
     /* standard cpu blas */
     template <> error_code cblas::loader::op<compute_mode::CPU>()
     {
-        cblas::m.reset(new cblas(BLAS_RUNTIME_FILE));
-        return cblas::m->error() ? error_code::KERNEL_FAILED : error_code::NONE;
+        return load(blas_backend::openblas_nehalem, "") ?
+            error_code::NONE : error_code::KERNEL_FAILED;
+    }
+
+#endif
+
+    blas_info cblas::info() const
+    {
+        return { _backend, _path, _variant, threading(), threads(), _error };
+    }
+
+    blas_threading cblas::threading() const
+    {
+        if (_get_parallel) {
+            switch (_get_parallel()) {
+                case 0:  return blas_threading::sequential;
+                case 1:  return blas_threading::pthreads;
+                case 2:  return blas_threading::openmp;
+                default: return blas_threading::unknown;
+            }
+        }
+
+        /* mkl_rt defaults to the openmp threading layer */
+        return _backend == blas_backend::mkl ?
+            blas_threading::openmp : blas_threading::unknown;
+    }
+
+    int cblas::threads() const
+    {
+        if (_get_threads) { return _get_threads(); }
+        if (_bli_get_threads) { return static_cast<int>(_bli_get_threads()); }
+        return 0;
+    }
+
+    void cblas::set_threads(int n)
+    {
+        if (_set_threads) { _set_threads(n); }
+        else if (_bli_set_threads) { _bli_set_threads(n); }
+    }
+
+    int cblas::set_local_threads(int n)
+    {
+        return _set_local_threads ? _set_local_threads(n) : -1;
     }
 }
 }
\ No newline at end of file
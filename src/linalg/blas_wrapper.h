@@ -15,15 +15,123 @@ limitations under the License.  */
 #pragma once
 #include "linalg/common.h"
 #include "linalg/blas_prelude.h"
+#include "linalg/small_kernels.h"
+#include "linalg/blas_profile.h"
+#include "ss/blas.h"
 
-#include <dlibxx.hxx>
+#if !defined(BLAS_STATIC)
+# include <dlibxx.hxx>
+#endif
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 namespace ss {
 namespace blas
 {
+    /* signatures of the (optional) LAPACKE routines */
+    namespace lapacke
+    {
+        template <typename T> using potrf = blasint(int, char, blasint, T*, blasint);
+        template <typename T> using potrs = blasint(int, char, blasint, blasint, const T*, blasint, T*, blasint);
+        template <typename T> using geqrf = blasint(int, blasint, blasint, T*, blasint, T*);
+        template <typename T> using ormqr = blasint(int, char, char, blasint, blasint, blasint, const T*, blasint, const T*, T*, blasint);
+        template <typename T> using trtrs = blasint(int, char, char, char, blasint, blasint, const T*, blasint, T*, blasint);
+    }
+
+    /*  The BLAS (and LAPACK) routines resolved from the loaded library.
+     *  The table is filled once, when the library is loaded, and never
+     *  modified afterwards, so it may be read from any thread.
+     */
+    struct routines
+    {
+        decltype(::cblas_dnrm2)*  dnrm2;
+        decltype(::cblas_snrm2)*  snrm2;
+        decltype(::cblas_dgemv)*  dgemv;
+        decltype(::cblas_sgemv)*  sgemv;
+        decltype(::cblas_sgemm)*  sgemm;
+        decltype(::cblas_dgemm)*  dgemm;
+        decltype(::cblas_dger)*   dger;
+        decltype(::cblas_sger)*   sger;
+        decltype(::cblas_ddot)*   ddot;
+        decltype(::cblas_sdot)*   sdot;
+        decltype(::cblas_dscal)*  dscal;
+        decltype(::cblas_sscal)*  sscal;
+        decltype(::cblas_idamax)* idamax;
+        decltype(::cblas_isamax)* isamax;
+        decltype(::cblas_strsm)*  strsm;
+        decltype(::cblas_dtrsm)*  dtrsm;
+        decltype(::cblas_strsv)*  strsv;
+        decltype(::cblas_dtrsv)*  dtrsv;
+        decltype(::cblas_ssyrk)*  ssyrk;
+        decltype(::cblas_dsyrk)*  dsyrk;
+
+        /* LAPACK routines, null when not exported by the loaded library */
+        lapacke::potrf<float>*  spotrf;
+        lapacke::potrf<double>* dpotrf;
+        lapacke::potrs<float>*  spotrs;
+        lapacke::potrs<double>* dpotrs;
+        lapacke::geqrf<float>*  sgeqrf;
+        lapacke::geqrf<double>* dgeqrf;
+        lapacke::ormqr<float>*  sormqr;
+        lapacke::ormqr<double>* dormqr;
+        lapacke::trtrs<float>*  strtrs;
+        lapacke::trtrs<double>* dtrtrs;
+
+        /* true when all of the LAPACK routines above were resolved */
+        bool lapack;
+    };
+
+    /* a backend requested through set_blas_backend, or the environment */
+    struct blas_request
+    {
+        bool requested;
+        blas_backend backend;
+        std::string path;
+
+        /* why the request can't be followed as given, or empty */
+        std::string error;
+    };
+
+    /*  The backend named by `name`, one of the values of SS_BLAS_BACKEND;
+     *  false, leaving backend, for any other name.
+     */
+    bool parse_backend(const char* name, blas_backend& backend);
+
+    /*  The request made by the values of SS_BLAS_BACKEND and
+     *  SS_BLAS_LIBRARY, either of which may be null. An unknown backend
+     *  name requests the automatic backend, with an error.
+     */
+    blas_request environment_request(const char* backend, const char* path);
+
+#if defined(BLAS_STATIC)
+    /*  Linked statically, so the table is a compile-time constant and the
+     *  wrappers compile to direct calls in to the library, which the
+     *  compiler (or the linker, with LTO) is free to inline.
+     */
+    constexpr routines linked_routines {
+        &::cblas_dnrm2, &::cblas_snrm2, &::cblas_dgemv, &::cblas_sgemv,
+        &::cblas_sgemm, &::cblas_dgemm, &::cblas_dger,  &::cblas_sger,
+        &::cblas_ddot,  &::cblas_sdot,  &::cblas_dscal, &::cblas_sscal,
+        &::cblas_idamax, &::cblas_isamax, &::cblas_strsm, &::cblas_dtrsm,
+        &::cblas_strsv, &::cblas_dtrsv, &::cblas_ssyrk, &::cblas_dsyrk,
+# if defined(BLAS_LAPACKE)
+        &::LAPACKE_spotrf, &::LAPACKE_dpotrf, &::LAPACKE_spotrs, &::LAPACKE_dpotrs,
+        &::LAPACKE_sgeqrf, &::LAPACKE_dgeqrf, &::LAPACKE_sormqr, &::LAPACKE_dormqr,
+        &::LAPACKE_strtrs, &::LAPACKE_dtrtrs,
+        true
+# else
+        nullptr, nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr, nullptr, nullptr,
+        false
+# endif
+    };
+
+    class cblas final
+    {
+        cblas();
+#else
     class cblas final : dlibxx::handle_fascade
     {
         struct loader;
@@ -31,33 +139,86 @@ namespace blas
         static std::unique_ptr<cblas> m;
         static void configure();
 
-        inline cblas(const std::string& path)
-            : dlibxx::handle_fascade{ path.c_str() }
-        {}
+        /* loads a backend (from path, if given), returning false on failure */
+        static bool load(blas_backend backend, const std::string& path);
+
+        cblas(const std::string& path, blas_backend backend);
+
+        /* resolves an optional symbol, or null if it isn't exported */
+        template <typename F> F* symbol(const char* name) const;
+
+        /* true when the library and all of the cblas routines were loaded */
+        bool loaded() const;
+
+        /* native handle to the loaded library */
+        void* _native;
+#endif
+        routines _fn;
+
+        /* thread control, null when not exported by the library */
+        void (*_set_threads)(int);
+        int (*_get_threads)();
+        int (*_set_local_threads)(int);
+        int (*_get_parallel)();
+        void (*_bli_set_threads)(int64_t);
+        int64_t (*_bli_get_threads)();
+
+        blas_backend _backend;
+        std::string _path;
+        std::string _variant;
+
+        /* why the requested backend wasn't loaded, or empty */
+        std::string _error;
 
       public:
-        op<decltype(::cblas_dnrm2)>  dnrm2 { this, "cblas_dnrm2" };
-        op<decltype(::cblas_snrm2)>  snrm2 { this, "cblas_snrm2" };
-        op<decltype(::cblas_dgemv)>  dgemv { this, "cblas_dgemv" };
-        op<decltype(::cblas_sgemv)>  sgemv { this, "cblas_sgemv" };
-        op<decltype(::cblas_sgemm)>  sgemm { this, "cblas_sgemm" };
-        op<decltype(::cblas_dgemm)>  dgemm { this, "cblas_dgemm" };
-        op<decltype(::cblas_dger)>   dger  { this, "cblas_dger" };
-        op<decltype(::cblas_sger)>   sger  { this, "cblas_sger" };
-        op<decltype(::cblas_ddot)>   ddot  { this, "cblas_ddot" };
-        op<decltype(::cblas_sdot)>   sdot  { this, "cblas_sdot" };
-        op<decltype(::cblas_dscal)>  dscal { this, "cblas_dscal" };
-        op<decltype(::cblas_sscal)>  sscal { this, "cblas_sscal" };
-        op<decltype(::cblas_idamax)> idamax{ this, "cblas_idamax" };
-        op<decltype(::cblas_isamax)> isamax{ this, "cblas_isamax" };
-        op<decltype(::cblas_strsm)>  strsm { this, "cblas_strsm" };
-        op<decltype(::cblas_dtrsm)>  dtrsm { this, "cblas_dtrsm" };
-        op<decltype(::cblas_strsv)>  strsv { this, "cblas_strsv" };
-        op<decltype(::cblas_dtrsv)>  dtrsv { this, "cblas_dtrsv" };
+        ~cblas();
+
+        /*  Selects the backend loaded on first use, returning false
+         *  if a library has already been loaded (or BLAS is linked
+         *  statically).
+         */
+        static bool select(blas_backend backend, const std::string& path);
+
+        /* describes the loaded library */
+        blas_info info() const;
+
+        /* the threading model the library was built with */
+        blas_threading threading() const;
+
+        /* the number of threads used in the calling thread, or 0 if unknown */
+        int threads() const;
 
+        /* sets the number of threads for all threads */
+        void set_threads(int n);
+
+        /*  Sets the number of threads for the calling thread, returning the
+         *  previous value, or -1 if the library has no thread-local setting.
+         */
+        int set_local_threads(int n);
+
+        /* the routines resolved from the library */
+        const routines& fn() const { return _fn; }
+
+        /* loads the library on first use; safe to call from any thread */
         static cblas* get();
     };
 
+#if defined(BLAS_STATIC)
+    inline const routines& table() {
+        return linked_routines;
+    }
+#else
+    /*  The routine table of the loaded library. The reference is cached
+     *  in a function-local static, so after the first call a BLAS call is
+     *  a guard check and an indirect call through a plain function pointer.
+     */
+    inline const routines& table()
+    {
+        static const routines& fn = cblas::get()->fn();
+        return fn;
+    }
+#endif
+
     namespace detail
     {
         template <typename T, size_t N>
@@ -70,9 +231,24 @@ namespace blas
             return view.raw_data() + view.raw_data_offset();
         }
 
+        /* true when the elements along dimension D are contiguous */
+        template <size_t D, typename T>
+        bool unit_stride(const ndspan<T, 2>& view) {
+            /* a dimension of extent 1 may have any stride */
+            return dim<D>(view) <= 1 || stride<D>(view) == 1;
+        }
+
+        /*  true when the view can be passed to cblas, i.e. either the rows
+            or the columns are contiguous */
+        template <typename T>
+        bool is_blas_layout(const ndspan<T, 2>& view) {
+            return unit_stride<0>(view) || unit_stride<1>(view);
+        }
+
         template <typename T>
         CBLAS_ORDER order(const ndspan<T, 2>& view) {
-            return (stride<0>(view) == 1) ? CblasColMajor : CblasRowMajor;
+            return (unit_stride<0>(view) && !unit_stride<1>(view)) ?
+                CblasColMajor : CblasRowMajor;
         }
 
         template <typename T>
@@ -97,13 +273,19 @@ namespace blas
     /* xnrm2 --------------------------------------------------------------- */
 
     inline double xnrm2(
-        const blasint N, const double *X, const blasint incX) {
-        return cblas::get()->dnrm2(N, X, incX);
+        const blasint N, const double *X, const blasint incX)
+    {
+        SS_BLAS_PROFILE(double, profile::op::nrm2,
+            2.0 * N, N);
+        return table().dnrm2(N, X, incX);
     }
 
     inline float xnrm2(
-        const blasint N, const float *X, const blasint incX) {
-        return cblas::get()->snrm2(N, X, incX);
+        const blasint N, const float *X, const blasint incX)
+    {
+        SS_BLAS_PROFILE(float, profile::op::nrm2,
+            2.0 * N, N);
+        return table().snrm2(N, X, incX);
     }
 
 
@@ -115,7 +297,17 @@ namespace blas
         const double alpha, const double *a, const blasint lda, const double *x,
         const blasint incx, const double beta, double *y, const blasint incy)
     {
-        cblas::get()->dgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+        const bool small_op = small::eligible(m, n) && incx > 0 && incy > 0;
+
+        SS_BLAS_PROFILE(double, small_op
+            ? (trans == CblasNoTrans ? profile::op::gemv_n_small : profile::op::gemv_t_small)
+            : (trans == CblasNoTrans ? profile::op::gemv_n : profile::op::gemv_t),
+            2.0 * m * n, 1.0 * m * n + m + n);
+        if (small_op) {
+            small::gemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+            return;
+        }
+        table().dgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
     }
 
     inline void xgemv(
@@ -124,7 +316,17 @@ namespace blas
         const float alpha, const float *a, const blasint lda, const float *x,
         const blasint incx, const float beta, float *y, const blasint incy)
     {
-        cblas::get()->sgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+        const bool small_op = small::eligible(m, n) && incx > 0 && incy > 0;
+
+        SS_BLAS_PROFILE(float, small_op
+            ? (trans == CblasNoTrans ? profile::op::gemv_n_small : profile::op::gemv_t_small)
+            : (trans == CblasNoTrans ? profile::op::gemv_n : profile::op::gemv_t),
+            2.0 * m * n, 1.0 * m * n + m + n);
+        if (small_op) {
+            small::gemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+            return;
+        }
+        table().sgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
     }
 
     template <typename T> void xgemv(
@@ -135,6 +337,15 @@ namespace blas
     {
         using namespace detail;
 
+        if (!is_blas_layout(a)) {
+            /* neither rows nor columns are contiguous */
+            small::gemv_strided(trans, dim<0>(a), dim<1>(a), alpha,
+                data(a), stride<0>(a), stride<1>(a),
+                data(x), leading_stride(x), beta,
+                data(y), leading_stride(y));
+            return;
+        }
+
         xgemv(order(a), trans, dim<0>(a), dim<1>(a), alpha,
             data(a), leading_stride(a),
             data(x), leading_stride(x), beta,
@@ -171,7 +382,9 @@ namespace blas
         const float *b, const blasint ldb, const float beta,
         float *c, const blasint ldc)
     {
-        cblas::get()->sgemm(order, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        SS_BLAS_PROFILE(float, profile::op::gemm,
+            2.0 * m * n * k, 1.0 * m * k + 1.0 * k * n + 2.0 * m * n);
+        table().sgemm(order, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
     }
 
     inline void xgemm(
@@ -182,7 +395,9 @@ namespace blas
         const double *b, const blasint ldb, const double beta,
         double *c, const blasint ldc)
     {
-        cblas::get()->dgemm(order, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        SS_BLAS_PROFILE(double, profile::op::gemm,
+            2.0 * m * n * k, 1.0 * m * k + 1.0 * k * n + 2.0 * m * n);
+        table().dgemm(order, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
     }
 
     template <typename T> void xgemm(
@@ -231,7 +446,15 @@ namespace blas
         const double alpha, const double *X, const blasint incX,
         const double *Y, const blasint incY, double *A, const blasint lda)
     {
-        cblas::get()->dger(order, M, N, alpha, X, incX, Y, incY, A, lda);
+        const bool small_op = small::eligible(M, N) && incX > 0 && incY > 0;
+
+        SS_BLAS_PROFILE(double, small_op ? profile::op::ger_small : profile::op::ger,
+            2.0 * M * N, 2.0 * M * N + M + N);
+        if (small_op) {
+            small::ger(order, M, N, alpha, X, incX, Y, incY, A, lda);
+            return;
+        }
+        table().dger(order, M, N, alpha, X, incX, Y, incY, A, lda);
     }
 
     inline void xger(
@@ -239,7 +462,15 @@ namespace blas
         const float alpha, const float *X, const blasint incX,
         const float *Y, const blasint incY, float *A, const blasint lda)
     {
-        cblas::get()->sger(order, M, N, alpha, X, incX, Y, incY, A, lda);
+        const bool small_op = small::eligible(M, N) && incX > 0 && incY > 0;
+
+        SS_BLAS_PROFILE(float, small_op ? profile::op::ger_small : profile::op::ger,
+            2.0 * M * N, 2.0 * M * N + M + N);
+        if (small_op) {
+            small::ger(order, M, N, alpha, X, incX, Y, incY, A, lda);
+            return;
+        }
+        table().sger(order, M, N, alpha, X, incX, Y, incY, A, lda);
     }
 
     template <typename T> void xger(
@@ -250,6 +481,14 @@ namespace blas
     {
         using namespace detail;
 
+        if (!is_blas_layout(A)) {
+            small::ger_strided(dim<0>(A), dim<1>(A), alpha,
+                data(x), leading_stride(x),
+                data(y), leading_stride(y),
+                data(A), stride<0>(A), stride<1>(A));
+            return;
+        }
+
         xger(order(A), dim<0>(A), dim<1>(A), alpha,
             data(x), leading_stride(x),
             data(y), leading_stride(y),
@@ -269,14 +508,24 @@ namespace blas
         const blasint n, const double *x, const blasint incx,
         const double *y, const blasint incy)
     {
-        return cblas::get()->ddot(n, x, incx, y, incy);
+        SS_BLAS_PROFILE(double, small::eligible(n) ? profile::op::dot_small : profile::op::dot,
+            2.0 * n, 2.0 * n);
+        if (small::eligible(n)) {
+            return small::dot(n, x, incx, y, incy);
+        }
+        return table().ddot(n, x, incx, y, incy);
     }
 
     inline float xdot(
         const blasint n, const float *x, const blasint incx,
         const float *y, const blasint incy)
     {
-        return cblas::get()->sdot(n, x, incx, y, incy);
+        SS_BLAS_PROFILE(float, small::eligible(n) ? profile::op::dot_small : profile::op::dot,
+            2.0 * n, 2.0 * n);
+        if (small::eligible(n)) {
+            return small::dot(n, x, incx, y, incy);
+        }
+        return table().sdot(n, x, incx, y, incy);
     }
 
     template <typename T> T xdot(
@@ -297,13 +546,27 @@ namespace blas
     /* xscal --------------------------------------------------------------- */
 
     inline void xscal(
-        const blasint N, const double alpha, double *X, const blasint incX) {
-        cblas::get()->dscal(N, alpha, X, incX);
+        const blasint N, const double alpha, double *X, const blasint incX)
+    {
+        SS_BLAS_PROFILE(double, small::eligible(N) ? profile::op::scal_small : profile::op::scal,
+            N, 2.0 * N);
+        if (small::eligible(N)) {
+            small::scal(N, alpha, X, incX);
+            return;
+        }
+        table().dscal(N, alpha, X, incX);
     }
 
     inline void xscal(
-        const blasint N, const float alpha, float *X, const blasint incX) {
-        cblas::get()->sscal(N, alpha, X, incX);
+        const blasint N, const float alpha, float *X, const blasint incX)
+    {
+        SS_BLAS_PROFILE(float, small::eligible(N) ? profile::op::scal_small : profile::op::scal,
+            N, 2.0 * N);
+        if (small::eligible(N)) {
+            small::scal(N, alpha, X, incX);
+            return;
+        }
+        table().sscal(N, alpha, X, incX);
     }
 
     template <typename T> void xscal(
@@ -320,13 +583,19 @@ namespace blas
     /* ixamax -------------------------------------------------------------- */
 
     inline size_t ixamax(
-        const blasint n, const double *x, const blasint incx) {
-        return cblas::get()->idamax(n, x, incx);
+        const blasint n, const double *x, const blasint incx)
+    {
+        SS_BLAS_PROFILE(double, profile::op::iamax,
+            n, n);
+        return table().idamax(n, x, incx);
     }
 
     inline size_t ixamax(
-        const blasint n, const float *x, const blasint incx) {
-        return cblas::get()->isamax(n, x, incx);
+        const blasint n, const float *x, const blasint incx)
+    {
+        SS_BLAS_PROFILE(float, profile::op::iamax,
+            n, n);
+        return table().isamax(n, x, incx);
     }
 
 
@@ -340,7 +609,9 @@ namespace blas
         const float alpha, const float *A, const blasint lda,
         float *B, const blasint ldb)
     {
-        cblas::get()->strsm(order, side, uplo, trans, diag, m, n, alpha, A, lda, B, ldb);
+        SS_BLAS_PROFILE(float, profile::op::trsm,
+            (side == CblasLeft ? 1.0 * m * m * n : 1.0 * m * n * n), (side == CblasLeft ? m * m : n * n) / 2.0 + 2.0 * m * n);
+        table().strsm(order, side, uplo, trans, diag, m, n, alpha, A, lda, B, ldb);
     }
 
     inline void xtrsm(
@@ -351,7 +622,9 @@ namespace blas
         const double alpha, const double *A, const blasint lda,
         double *B, const blasint ldb)
     {
-        cblas::get()->dtrsm(order, side, uplo, trans, diag, m, n, alpha, A, lda, B, ldb);
+        SS_BLAS_PROFILE(double, profile::op::trsm,
+            (side == CblasLeft ? 1.0 * m * m * n : 1.0 * m * n * n), (side == CblasLeft ? m * m : n * n) / 2.0 + 2.0 * m * n);
+        table().dtrsm(order, side, uplo, trans, diag, m, n, alpha, A, lda, B, ldb);
     }
 
     template <typename T> void xtrsm(
@@ -366,6 +639,23 @@ namespace blas
             data(b), leading_stride(b));
     }
 
+    template <typename T> void xtrsm(
+        const enum CBLAS_SIDE side, const enum CBLAS_UPLO uplo,
+        const enum CBLAS_TRANSPOSE trans, const enum CBLAS_DIAG diag,
+        const T alpha, const ndspan<T, 2> A, ndspan<T, 2> B)
+    {
+        using namespace detail;
+
+        /* A in the opposite order to B is seen by cblas as transpose(A) */
+        const bool flip = order(A) != order(B);
+
+        xtrsm(order(B), side,
+            flip ? (uplo == CblasLower ? CblasUpper : CblasLower) : uplo,
+            flip ? (trans == CblasNoTrans ? CblasTrans : CblasNoTrans) : trans,
+            diag, dim<0>(B), dim<1>(B), alpha, data(A), leading_stride(A),
+            data(B), leading_stride(B));
+    }
+
 
     /* xtrsv ---------------------------------------------------------------- */
 
@@ -375,7 +665,9 @@ namespace blas
         const blasint n, const float *A, const blasint lda,
         float *x, const blasint incx)
     {
-        cblas::get()->strsv(order, uplo, trans, diag, n, A, lda, x, incx);
+        SS_BLAS_PROFILE(float, profile::op::trsv,
+            1.0 * n * n, n * n / 2.0 + 2.0 * n);
+        table().strsv(order, uplo, trans, diag, n, A, lda, x, incx);
     }
 
     inline void xtrsv(
@@ -384,7 +676,9 @@ namespace blas
         const blasint n, const double *A, const blasint lda,
         double *x, const blasint incx)
     {
-        cblas::get()->dtrsv(order, uplo, trans, diag, n, A, lda, x, incx);
+        SS_BLAS_PROFILE(double, profile::op::trsv,
+            1.0 * n * n, n * n / 2.0 + 2.0 * n);
+        table().dtrsv(order, uplo, trans, diag, n, A, lda, x, incx);
     }
 
     template <typename T> void xtrsv(
@@ -398,5 +692,176 @@ namespace blas
             dim<1>(A), data(A), leading_stride(A),
             data(b), leading_stride(b));
     }
+
+    /* xsyrk ---------------------------------------------------------------- */
+
+    inline void xsyrk(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const enum CBLAS_TRANSPOSE trans, const blasint n, const blasint k,
+        const float alpha, const float *A, const blasint lda,
+        const float beta, float *C, const blasint ldc)
+    {
+        SS_BLAS_PROFILE(float, profile::op::syrk,
+            1.0 * n * (n + 1) * k, 1.0 * n * k + 1.0 * n * n);
+        table().ssyrk(order, uplo, trans, n, k, alpha, A, lda, beta, C, ldc);
+    }
+
+    inline void xsyrk(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const enum CBLAS_TRANSPOSE trans, const blasint n, const blasint k,
+        const double alpha, const double *A, const blasint lda,
+        const double beta, double *C, const blasint ldc)
+    {
+        SS_BLAS_PROFILE(double, profile::op::syrk,
+            1.0 * n * (n + 1) * k, 1.0 * n * k + 1.0 * n * n);
+        table().dsyrk(order, uplo, trans, n, k, alpha, A, lda, beta, C, ldc);
+    }
+
+    template <typename T> void xsyrk(
+        const enum CBLAS_UPLO uplo, const enum CBLAS_TRANSPOSE trans,
+        const T alpha, const ndspan<T, 2> A, const T beta, ndspan<T, 2> C)
+    {
+        using namespace detail;
+        auto k = trans == CblasNoTrans ? dim<1>(A) : dim<0>(A);
+
+        xsyrk(order(A), uplo, trans, dim<0>(C), k, alpha,
+            data(A), leading_stride(A), beta,
+            data(C), leading_stride(C));
+    }
+
+    /* LAPACK --------------------------------------------------------------- */
+
+    inline char uplo_char(const enum CBLAS_UPLO uplo) {
+        return uplo == CblasLower ? 'L' : 'U';
+    }
+
+    inline char trans_char(const enum CBLAS_TRANSPOSE trans) {
+        return trans == CblasNoTrans ? 'N' : 'T';
+    }
+
+    /*  Whether the decompositions should route to LAPACK. A backend
+     *  of `lapack` falls back to the portable implementation when the
+     *  loaded library doesn't export the routines.
+     */
+    inline bool use_lapack(const decomposition_backend backend) {
+        return backend != decomposition_backend::portable
+            && table().lapack;
+    }
+
+    /* xpotrf --------------------------------------------------------------- */
+
+    inline blasint xpotrf(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const blasint n, float *a, const blasint lda)
+    {
+        SS_BLAS_PROFILE(float, profile::op::potrf,
+            n * n * (n / 3.0), 1.0 * n * n);
+        return table().spotrf(order, uplo_char(uplo), n, a, lda);
+    }
+
+    inline blasint xpotrf(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const blasint n, double *a, const blasint lda)
+    {
+        SS_BLAS_PROFILE(double, profile::op::potrf,
+            n * n * (n / 3.0), 1.0 * n * n);
+        return table().dpotrf(order, uplo_char(uplo), n, a, lda);
+    }
+
+    /* xpotrs --------------------------------------------------------------- */
+
+    inline blasint xpotrs(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const blasint n, const blasint nrhs, const float *a, const blasint lda,
+        float *b, const blasint ldb)
+    {
+        SS_BLAS_PROFILE(float, profile::op::potrs,
+            2.0 * n * n * nrhs, 1.0 * n * n + 2.0 * n * nrhs);
+        return table().spotrs(order, uplo_char(uplo), n, nrhs, a, lda, b, ldb);
+    }
+
+    inline blasint xpotrs(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const blasint n, const blasint nrhs, const double *a, const blasint lda,
+        double *b, const blasint ldb)
+    {
+        SS_BLAS_PROFILE(double, profile::op::potrs,
+            2.0 * n * n * nrhs, 1.0 * n * n + 2.0 * n * nrhs);
+        return table().dpotrs(order, uplo_char(uplo), n, nrhs, a, lda, b, ldb);
+    }
+
+    /* xgeqrf --------------------------------------------------------------- */
+
+    inline blasint xgeqrf(
+        const enum CBLAS_ORDER order, const blasint m, const blasint n,
+        float *a, const blasint lda, float *tau)
+    {
+        SS_BLAS_PROFILE(float, profile::op::geqrf,
+            2.0 * m * n * n - 2.0 * n * n * (n / 3.0), 2.0 * m * n);
+        return table().sgeqrf(order, m, n, a, lda, tau);
+    }
+
+    inline blasint xgeqrf(
+        const enum CBLAS_ORDER order, const blasint m, const blasint n,
+        double *a, const blasint lda, double *tau)
+    {
+        SS_BLAS_PROFILE(double, profile::op::geqrf,
+            2.0 * m * n * n - 2.0 * n * n * (n / 3.0), 2.0 * m * n);
+        return table().dgeqrf(order, m, n, a, lda, tau);
+    }
+
+    /* xormqr --------------------------------------------------------------- */
+
+    inline blasint xormqr(
+        const enum CBLAS_ORDER order, const enum CBLAS_SIDE side,
+        const enum CBLAS_TRANSPOSE trans,
+        const blasint m, const blasint n, const blasint k,
+        const float *a, const blasint lda, const float *tau,
+        float *c, const blasint ldc)
+    {
+        SS_BLAS_PROFILE(float, profile::op::ormqr,
+            4.0 * m * n * k, 1.0 * k * (side == CblasLeft ? m : n) + 2.0 * m * n);
+        return table().sormqr(order, side == CblasLeft ? 'L' : 'R',
+            trans_char(trans), m, n, k, a, lda, tau, c, ldc);
+    }
+
+    inline blasint xormqr(
+        const enum CBLAS_ORDER order, const enum CBLAS_SIDE side,
+        const enum CBLAS_TRANSPOSE trans,
+        const blasint m, const blasint n, const blasint k,
+        const double *a, const blasint lda, const double *tau,
+        double *c, const blasint ldc)
+    {
+        SS_BLAS_PROFILE(double, profile::op::ormqr,
+            4.0 * m * n * k, 1.0 * k * (side == CblasLeft ? m : n) + 2.0 * m * n);
+        return table().dormqr(order, side == CblasLeft ? 'L' : 'R',
+            trans_char(trans), m, n, k, a, lda, tau, c, ldc);
+    }
+
+    /* xtrtrs --------------------------------------------------------------- */
+
+    inline blasint xtrtrs(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const enum CBLAS_TRANSPOSE trans, const enum CBLAS_DIAG diag,
+        const blasint n, const blasint nrhs, const float *a, const blasint lda,
+        float *b, const blasint ldb)
+    {
+        SS_BLAS_PROFILE(float, profile::op::trtrs,
+            1.0 * n * n * nrhs, n * n / 2.0 + 2.0 * n * nrhs);
+        return table().strtrs(order, uplo_char(uplo), trans_char(trans),
+            diag == CblasUnit ? 'U' : 'N', n, nrhs, a, lda, b, ldb);
+    }
+
+    inline blasint xtrtrs(
+        const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo,
+        const enum CBLAS_TRANSPOSE trans, const enum CBLAS_DIAG diag,
+        const blasint n, const blasint nrhs, const double *a, const blasint lda,
+        double *b, const blasint ldb)
+    {
+        SS_BLAS_PROFILE(double, profile::op::trtrs,
+            1.0 * n * n * nrhs, n * n / 2.0 + 2.0 * n * nrhs);
+        return table().dtrtrs(order, uplo_char(uplo), trans_char(trans),
+            diag == CblasUnit ? 'U' : 'N', n, nrhs, a, lda, b, ldb);
+    }
 }
 }
\ No newline at end of file
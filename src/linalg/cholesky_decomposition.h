@@ -18,18 +18,35 @@ limitations under the License.  */
 
 #include <ss/ndspan.h>
 #include <xtensor/xtensor.hpp>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
 
 namespace ss
 {
     /*  Forms the Cholesky factorization of a square
      *  matrix A if one exists.
+     *
+     *  The factorization is blocked (right-looking), such that the bulk
+     *  of the work is performed by level-3 updates of the trailing matrix,
+     *  or is computed by ?potrf with the lapack backend. Only the lower
+     *  triangle of A is referenced.
      */
     template <typename T>
     class cholesky_decomposition
     {
       public:
-        cholesky_decomposition(const ndspan<T, 2> A);
+        /* Factorizes a copy of A. */
+        cholesky_decomposition(const ndspan<T, 2> A,
+            decomposition_backend backend = decomposition_backend::automatic);
+
+        /*  Factorizes the row-major matrix A in-place, overwriting its lower
+         *  triangle with L and its strictly upper triangle with zeros. A must
+         *  outlive the decomposition.
+         */
+        cholesky_decomposition(ndspan<T, 2> A, inplace_t,
+            decomposition_backend backend = decomposition_backend::automatic);
 
         ndspan<T, 2> l() const;
 
@@ -39,67 +56,259 @@ namespace ss
         template <typename B, typename X>
         void solve(const B& b, X& x) const { solve(as_span(b), as_span(x)); }
 
+        /*  Solves A*X == B for matrix X, where each column of B
+         *  is a right-hand side.
+         */
+        void solve(const ndspan<T, 2> B, ndspan<T, 2> X) const;
+
         template <typename B>
         xt::xtensor<T, 1> solve(const B& b) const;
 
+        /*  Updates the factorization in O(n^2) such that it becomes the
+         *  factorization of A + v*transpose(v).
+         */
+        void update(const ndspan<T> v);
+
+        /*  Downdates the factorization in O(n^2) such that it becomes the
+         *  factorization of A - v*transpose(v). Returns false, leaving the
+         *  factorization unmodified, if the result would not be positive
+         *  definite.
+         */
+        bool downdate(const ndspan<T> v);
+
         bool isspd() { return _isspd; }
 
       private:
-        xt::xtensor<T, 2> _l;
+        T* data() const;
+        void factorize();
+
+        /* storage of L, unused when factorized in-place */
+        xt::xtensor<T, 2> _storage;
+        /* the caller's buffer when factorized in-place, otherwise null */
+        T* _inplace;
+        size_t _n;
+        size_t _ld;
         bool _isspd;
+        /* whether to route to LAPACK */
+        bool _lapack;
     };
 }
 
 /* Definions --------------------------------------------------------------- */
 
-namespace ss
+namespace ss { namespace detail
 {
+    /* order of the diagonal blocks of the blocked factorization */
+    constexpr int64_t cholesky_block_size = 64;
+
+    /*  Unblocked (left-looking) factorization of the n-by-n row-major
+     *  matrix a, referencing only its lower triangle. Returns false if
+     *  the matrix is not positive definite.
+     */
     template <typename T>
-    cholesky_decomposition<T>::cholesky_decomposition(const ndspan<T, 2> A)
-        : _l({ dim<1>(A), dim<1>(A) })
-        , _isspd{ true }
+    bool potf2(T* a, const int64_t n, const int64_t lda)
     {
-        using namespace xt;
-        const int64_t N = dim<1>(A);
-        assert(dim<0>(A) > 0 && dim<0>(A) == N);
-
-        _isspd = true;
         const T eps = std::numeric_limits<T>::epsilon();
 
-        view(_l) = xt::tril(A); 
-
-        for (int64_t j = 0; j < N; ++j) {
-            auto v = xt::view(_l, xt::range(j, N), j);
+        for (int64_t j = 0; j < n; ++j) {
+            /* a(j:n, j) */
+            T* v = &a[j * lda + j];
 
             if (j > 0) {
-                auto w = xt::view(_l, j, xt::range(0, j));
-                auto m = xt::view(_l, xt::range(j, N), xt::range(0, j));
-                blas::xgemv(CblasNoTrans, T{-1}, m, w, T{1}, v);
+                /* a(j:n, j) -= a(j:n, 0:j) * a(j, 0:j) */
+                blas::xgemv(CblasRowMajor, CblasNoTrans, n - j, j, T{-1},
+                    &a[j * lda], lda,
+                    &a[j * lda], 1, T{1},
+                    v, lda);
+            }
+
+            T ajj = std::sqrt(*v);
+            if (!(ajj > eps)) {
+                return false;
+            }
+            blas::xscal(n - j, T{1} / ajj, v, lda);
+        }
+        return true;
+    }
+
+    /*  Blocked (right-looking) factorization of the n-by-n row-major
+     *  matrix a, referencing only its lower triangle. Each diagonal block
+     *  is factorized with potf2, after which the panel below it is solved
+     *  with a triangular solve and the trailing matrix is updated with a
+     *  symmetric rank-k update.
+     */
+    template <typename T>
+    bool potrf(T* a, const int64_t n, const int64_t lda)
+    {
+        for (int64_t k = 0; k < n; k += cholesky_block_size) {
+            const int64_t kb = std::min(cholesky_block_size, n - k);
+            const int64_t r  = n - k - kb;
+
+            T* a11 = &a[k * lda + k];
+            if (!potf2(a11, kb, lda)) {
+                return false;
+            }
+
+            if (r > 0) {
+                T* a21 = &a[(k + kb) * lda + k];
+                T* a22 = &a[(k + kb) * lda + k + kb];
+
+                /* a21 := a21 * inv(transpose(l11)) */
+                blas::xtrsm(CblasRowMajor, CblasRight, CblasLower, CblasTrans,
+                    CblasNonUnit, r, kb, T{1}, a11, lda, a21, lda);
+
+                /* a22 := a22 - a21 * transpose(a21) */
+                blas::xsyrk(CblasRowMajor, CblasLower, CblasNoTrans, r, kb,
+                    T{-1}, a21, lda, T{1}, a22, lda);
             }
+        }
+        return true;
+    }
+
+    /*  Rank-1 modification of the n-by-n row-major lower triangular
+     *  factor l, such that l*transpose(l) + sign * w*transpose(w) is
+     *  factorized. w is overwritten.
+     */
+    template <typename T>
+    void cholesky_rank1(T* l, const int64_t n, const int64_t ld, T* w, const T sign)
+    {
+        for (int64_t k = 0; k < n; ++k) {
+            T& lkk = l[k * ld + k];
+
+            const T r = std::sqrt(lkk * lkk + sign * w[k] * w[k]);
+            const T c = r / lkk;
+            const T s = w[k] / lkk;
+            lkk = r;
+
+            for (int64_t i = k + 1; i < n; ++i) {
+                T& lik = l[i * ld + k];
 
-            T ajj = std::sqrt(_l(j, j));
-            if (ajj <= eps) {
-                _isspd = false;
+                lik  = (lik + sign * s * w[i]) / c;
+                w[i] = c * w[i] - s * lik;
             }
-            blas::xscal(T{1} / ajj, v);
         }
     }
+}}
+
+namespace ss
+{
+    template <typename T>
+    cholesky_decomposition<T>::cholesky_decomposition(
+        const ndspan<T, 2> A,
+        decomposition_backend backend)
+        : _storage(A)
+        , _inplace{ nullptr }
+        , _n{ dim<1>(A) }
+        , _ld{ dim<1>(A) }
+        , _isspd{ true }
+        , _lapack{ blas::use_lapack(backend) }
+    {
+        assert(dim<0>(A) > 0 && dim<0>(A) == _n);
+        factorize();
+    }
+
+    template <typename T>
+    cholesky_decomposition<T>::cholesky_decomposition(
+        ndspan<T, 2> A, inplace_t,
+        decomposition_backend backend)
+        : _storage()
+        , _inplace{ blas::detail::data(A) }
+        , _n{ dim<1>(A) }
+        , _ld{ std::max(dim<1>(A), stride<0>(A)) }
+        , _isspd{ true }
+        , _lapack{ blas::use_lapack(backend) }
+    {
+        assert(dim<0>(A) > 0 && dim<0>(A) == _n);
+        assert(_n == 1 || stride<1>(A) == 1);
+        factorize();
+    }
+
+    template <typename T>
+    void cholesky_decomposition<T>::factorize()
+    {
+        T* a = data();
+
+        if (_lapack) {
+            /* the lower triangle in row-major order is the
+               upper triangle in column-major order */
+            _isspd = 0 == blas::xpotrf(CblasColMajor, CblasUpper, _n, a, _ld);
+        }
+        else {
+            _isspd = detail::potrf(a, _n, _ld);
+        }
+
+        /* clear the strictly upper triangle */
+        for (size_t i = 0; i < _n; ++i) {
+            std::fill(&a[i * _ld + i + 1], &a[i * _ld + _n], T{0});
+        }
+    }
+
+    template <typename T>
+    T* cholesky_decomposition<T>::data() const {
+        return _inplace ? _inplace : const_cast<T*>(_storage.raw_data());
+    }
 
     template <typename T>
     ndspan<T, 2> cholesky_decomposition<T>::l() const {
-        return as_span(_l);
+        return as_span<2>(data(), { _n, _n }, { _ld, 1 });
     }
 
     template <typename T>
     void cholesky_decomposition<T>::solve(const ndspan<T> b, ndspan<T> x) const
     {
-        assert(dim<0>(b) == dim<0>(_l)
-            && dim<0>(x) == dim<0>(_l));
+        assert(dim<0>(b) == _n
+            && dim<0>(x) == _n);
 
         view(x) = b;
-        
-        blas::xtrsv(CblasLower, CblasNoTrans, CblasNonUnit, as_span(_l), x);
-        blas::xtrsv(CblasLower, CblasTrans, CblasNonUnit, as_span(_l), x);
+
+        if (_lapack && (_n == 1 || stride<0>(x) == 1)) {
+            blas::xpotrs(CblasColMajor, CblasUpper, _n, 1, data(), _ld,
+                blas::detail::data(x), _n);
+            return;
+        }
+
+        blas::xtrsv(CblasLower, CblasNoTrans, CblasNonUnit, l(), x);
+        blas::xtrsv(CblasLower, CblasTrans, CblasNonUnit, l(), x);
+    }
+
+    template <typename T>
+    void cholesky_decomposition<T>::solve(const ndspan<T, 2> B, ndspan<T, 2> X) const
+    {
+        assert(dim<0>(B) == _n
+            && dim<0>(X) == _n
+            && dim<1>(X) == dim<1>(B));
+
+        view(X) = B;
+
+        blas::xtrsm(CblasLeft, CblasLower, CblasNoTrans, CblasNonUnit, T{1}, l(), X);
+        blas::xtrsm(CblasLeft, CblasLower, CblasTrans, CblasNonUnit, T{1}, l(), X);
+    }
+
+    template <typename T>
+    void cholesky_decomposition<T>::update(const ndspan<T> v)
+    {
+        assert(_isspd && dim<0>(v) == _n);
+
+        xt::xtensor<T, 1> w = v;
+        detail::cholesky_rank1(data(), _n, _ld, w.raw_data(), T{1});
+    }
+
+    template <typename T>
+    bool cholesky_decomposition<T>::downdate(const ndspan<T> v)
+    {
+        assert(_isspd && dim<0>(v) == _n);
+
+        /* A - v*transpose(v) is positive definite iff || inv(L) v || < 1 */
+        xt::xtensor<T, 1> p = v;
+        blas::xtrsv(CblasLower, CblasNoTrans, CblasNonUnit, l(), as_span(p));
+
+        if (!(T{1} - blas::xdot(p, p) > std::numeric_limits<T>::epsilon())) {
+            return false;
+        }
+
+        xt::xtensor<T, 1> w = v;
+        detail::cholesky_rank1(data(), _n, _ld, w.raw_data(), T{-1});
+        return true;
     }
 
     template <typename T>
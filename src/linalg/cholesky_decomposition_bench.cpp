@@ -23,9 +23,33 @@ namespace
             benchmark::DoNotOptimize(ss::cholesky_decomposition<float>(as_span(A)));
         }
     }
+
+    inline void cholesky_decomposition_inplace_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const uint32_t M = state.range(0);
+
+        /* make some spd noise */
+        xtensor<float, 2> noise = xt::random::randn({ M, M }, 10.0f, 5.0f);
+        auto A = ss::blas::xgemm(CblasNoTrans, CblasTrans, float{1}, noise, noise);
+        auto buf = A;
+
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            buf = A;
+            state.ResumeTiming();
+
+            benchmark::DoNotOptimize(ss::cholesky_decomposition<float>(as_span(buf), ss::inplace));
+        }
+    }
 }
 
 BENCHMARK(cholesky_decomposition_bench)
     ->RangeMultiplier(2)
     ->Unit(benchmark::kMillisecond)
     ->Ranges({ { 32, 8 << 8 } /* M */ });
+
+BENCHMARK(cholesky_decomposition_inplace_bench)
+    ->RangeMultiplier(2)
+    ->Unit(benchmark::kMillisecond)
+    ->Ranges({ { 32, 8 << 8 } /* M */ });
@@ -93,4 +93,116 @@ TEST(cholesky_decomposition, random_inputs)
 
     test_random<double>(50);
     test_random<double>(100);
-}
\ No newline at end of file
+
+    /* spans multiple blocks */
+    test_random<double>(150);
+}
+
+TEST(cholesky_decomposition, inplace)
+{
+    xt::random::seed(0);
+
+    const int N = 150;
+    xtensor<double, 2> noise = xt::random::randn({ N, N }, 10.0f, 5.0f);
+    xtensor<double, 2> A = xgemm(CblasNoTrans, CblasTrans, double{1}, noise, noise);
+    xtensor<double, 2> buf = A;
+
+    ss::cholesky_decomposition<double> chol{ ss::as_span(buf), ss::inplace };
+    EXPECT_TRUE(chol.isspd());
+    {
+        SCOPED_TRACE("L overwrites A");
+        EXPECT_EQ(chol.l().raw_data(), buf.raw_data());
+    }
+    {
+        SCOPED_TRACE("A = LL*");
+
+        auto LLT = xgemm(CblasNoTrans, CblasTrans, double{1}, chol.l(), chol.l());
+        EXPECT_TRUE(xt::allclose(A, LLT, 0.0, 1e-3));
+    }
+}
+
+TEST(cholesky_decomposition, update_downdate)
+{
+    xt::random::seed(0);
+
+    const int N = 20;
+    xtensor<double, 2> noise = xt::random::randn({ N, N }, 10.0f, 5.0f);
+    xtensor<double, 2> A = xgemm(CblasNoTrans, CblasTrans, double{1}, noise, noise);
+    xtensor<double, 1> v = xt::random::randn({ N }, 0.0f, 5.0f);
+
+    xtensor<double, 2> vvT =
+        xt::view(v, xt::all(), xt::newaxis()) * xt::view(v, xt::newaxis(), xt::all());
+
+    ss::cholesky_decomposition<double> chol{ ss::as_span(A) };
+    {
+        SCOPED_TRACE("update: A + vv* = LL*");
+        chol.update(ss::as_span(v));
+
+        auto LLT = xgemm(CblasNoTrans, CblasTrans, double{1}, chol.l(), chol.l());
+        EXPECT_TRUE(xt::allclose(A + vvT, LLT, 0.0, 1e-6));
+    }
+    {
+        SCOPED_TRACE("downdate: A = LL*");
+        EXPECT_TRUE(chol.downdate(ss::as_span(v)));
+
+        auto LLT = xgemm(CblasNoTrans, CblasTrans, double{1}, chol.l(), chol.l());
+        EXPECT_TRUE(xt::allclose(A, LLT, 0.0, 1e-6));
+    }
+}
+
+TEST(cholesky_decomposition, downdate_not_spd)
+{
+    const xtensor<float, 2> A{
+        {1, 0},
+        {0, 1}
+    };
+    xtensor<float, 1> v{ 2, 0 };
+
+    ss::cholesky_decomposition<float> chol{ ss::as_span(A) };
+    EXPECT_FALSE(chol.downdate(ss::as_span(v)));
+
+    /* the factorization is unmodified */
+    EXPECT_TRUE(xt::allclose(chol.l(), A, 0.0f, 1e-6));
+}
+
+TEST(cholesky_decomposition, solve_matrix)
+{
+    xt::random::seed(0);
+
+    const int N = 100, K = 8;
+    xtensor<double, 2> noise = xt::random::randn({ N, N }, 10.0f, 5.0f);
+    xtensor<double, 2> A = xgemm(CblasNoTrans, CblasTrans, double{1}, noise, noise);
+    xtensor<double, 2> B = xt::random::randn({ N, K }, 0.0f, 1.0f);
+    xtensor<double, 2> X = xt::zeros<double>({ N, K });
+
+    ss::cholesky_decomposition<double> chol{ ss::as_span(A) };
+    chol.solve(B, X);
+
+    for (int k = 0; k < K; k++) {
+        SCOPED_TRACE("AX = B, column " + std::to_string(k));
+
+        xtensor<double, 1> b = xt::view(B, xt::all(), k);
+        auto x = chol.solve(b);
+
+        EXPECT_TRUE(xt::allclose(xt::view(X, xt::all(), k), x, 0.0, 1e-8));
+    }
+}
+
+TEST(cholesky_decomposition, backends_agree)
+{
+    xt::random::seed(0);
+
+    const int N = 100;
+    xtensor<double, 2> noise = xt::random::randn({ N, N }, 10.0f, 5.0f);
+    xtensor<double, 2> A = xgemm(CblasNoTrans, CblasTrans, double{1}, noise, noise);
+    xtensor<double, 1> b = xt::random::randn({ N }, 0.0f, 1.0f);
+
+    ss::cholesky_decomposition<double> portable{ ss::as_span(A), ss::decomposition_backend::portable };
+    ss::cholesky_decomposition<double> lapack{ ss::as_span(A), ss::decomposition_backend::lapack };
+
+    EXPECT_TRUE(portable.isspd());
+    EXPECT_TRUE(lapack.isspd());
+
+    EXPECT_TRUE(xt::allclose(portable.l(), lapack.l(), 0.0, 1e-8));
+    EXPECT_TRUE(xt::allclose(portable.solve(b), lapack.solve(b), 0.0, 1e-8));
+}
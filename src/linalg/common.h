@@ -14,16 +14,23 @@ limitations under the License.  */
 #pragma once
 
 #include "ss/ndspan.h"
+#include "linalg/aligned_allocator.h"
+
 #include <algorithm>
+#include <vector>
 
 namespace ss
 {
     template <typename T>
     using mat_view = ss::ndspan<T, 2>;
 
-    template <typename T, class A = std::allocator<T>>
+    template <typename T, class A = aligned_allocator<T>>
     using mat = xt::xtensor<T, 2, xt::layout_type::row_major, A>;
 
+    /* a cache line aligned vector, for workspaces */
+    template <typename T>
+    using vec = xt::xtensor<T, 1, xt::layout_type::row_major, aligned_allocator<T>>;
+
     template <size_t D, typename M>
     size_t dim(const M& mat) { return mat.shape()[D]; }
 
@@ -31,5 +38,20 @@ namespace ss
     size_t stride(const M& mat) { return mat.strides()[D]; }
 
     template <typename T>
-    using aligned_vector = std::vector<T>;
+    using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+    /* selects the implementation of the dense decompositions */
+    enum class decomposition_backend
+    {
+        /* LAPACK when available, otherwise portable */
+        automatic,
+        /* the implementations in this library */
+        portable,
+        /* the LAPACK routines exported by the loaded BLAS library */
+        lapack
+    };
+
+    /* tag selecting the in-place variant of a decomposition */
+    struct inplace_t {};
+    constexpr inplace_t inplace{};
 }
\ No newline at end of file
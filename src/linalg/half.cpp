@@ -0,0 +1,158 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "linalg/half.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+# define SS_HALF_AVX2 1
+# include <immintrin.h>
+#endif
+
+namespace ss {
+namespace half
+{
+    namespace
+    {
+        /* portable --------------------------------------------------------- */
+
+        template <format F>
+        float dot_portable(size_t n, const uint16_t* a, const float* x)
+        {
+            float s0{ 0 }, s1{ 0 }, s2{ 0 }, s3{ 0 };
+            size_t i = 0;
+
+            for (; i + 4 <= n; i += 4) {
+                s0 += decode(F, a[i])     * x[i];
+                s1 += decode(F, a[i + 1]) * x[i + 1];
+                s2 += decode(F, a[i + 2]) * x[i + 2];
+                s3 += decode(F, a[i + 3]) * x[i + 3];
+            }
+            for (; i < n; i++) {
+                s0 += decode(F, a[i]) * x[i];
+            }
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        template <format F>
+        void axpy_portable(size_t n, float alpha, const uint16_t* a, float* y)
+        {
+            for (size_t i = 0; i < n; i++) { y[i] += alpha * decode(F, a[i]); }
+        }
+
+#if defined(SS_HALF_AVX2)
+        /* avx2 ------------------------------------------------------------- */
+
+# define SS_TARGET_AVX2 __attribute__((target("avx2,fma,f16c")))
+
+        /* converts 8 elements to float */
+        template <format F>
+        SS_TARGET_AVX2 inline __m256 load8(const uint16_t* a)
+        {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+
+            if (F == format::fp16) {
+                return _mm256_cvtph_ps(h);
+            }
+            return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+        }
+
+        template <format F>
+        SS_TARGET_AVX2 float dot_avx2(size_t n, const uint16_t* a, const float* x)
+        {
+            __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+            size_t i = 0;
+
+            for (; i + 16 <= n; i += 16) {
+                s0 = _mm256_fmadd_ps(load8<F>(a + i),     _mm256_loadu_ps(x + i),     s0);
+                s1 = _mm256_fmadd_ps(load8<F>(a + i + 8), _mm256_loadu_ps(x + i + 8), s1);
+            }
+            for (; i + 8 <= n; i += 8) {
+                s0 = _mm256_fmadd_ps(load8<F>(a + i), _mm256_loadu_ps(x + i), s0);
+            }
+
+            /* horizontal sum */
+            const __m256 s  = _mm256_add_ps(s0, s1);
+            __m128 r = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+            r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+            r = _mm_add_ss(r, _mm_movehdup_ps(r));
+
+            float sum = _mm_cvtss_f32(r);
+            for (; i < n; i++) { sum += decode(F, a[i]) * x[i]; }
+            return sum;
+        }
+
+        template <format F>
+        SS_TARGET_AVX2 void axpy_avx2(size_t n, float alpha, const uint16_t* a, float* y)
+        {
+            const __m256 va = _mm256_set1_ps(alpha);
+            size_t i = 0;
+
+            for (; i + 8 <= n; i += 8) {
+                _mm256_storeu_ps(y + i,
+                    _mm256_fmadd_ps(va, load8<F>(a + i), _mm256_loadu_ps(y + i)));
+            }
+            for (; i < n; i++) { y[i] += alpha * decode(F, a[i]); }
+        }
+
+# undef SS_TARGET_AVX2
+#endif
+
+        /* dispatch --------------------------------------------------------- */
+
+        struct kernels
+        {
+            float (*dot[2])(size_t, const uint16_t*, const float*);
+            void  (*axpy[2])(size_t, float, const uint16_t*, float*);
+            bool  vectorized;
+        };
+
+        kernels select()
+        {
+#if defined(SS_HALF_AVX2)
+            __builtin_cpu_init();
+
+            /* every cpu with avx2 also has f16c, which not all compilers can query */
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            {
+                return {
+                    { dot_avx2<format::fp16>,  dot_avx2<format::bf16> },
+                    { axpy_avx2<format::fp16>, axpy_avx2<format::bf16> },
+                    true };
+            }
+#endif
+            return {
+                { dot_portable<format::fp16>,  dot_portable<format::bf16> },
+                { axpy_portable<format::fp16>, axpy_portable<format::bf16> },
+                false };
+        }
+
+        const kernels& table()
+        {
+            static const kernels k = select();
+            return k;
+        }
+    }
+
+    float dot(format fmt, size_t n, const uint16_t* a, const float* x) {
+        return table().dot[size_t(fmt)](n, a, x);
+    }
+
+    void axpy(format fmt, size_t n, float alpha, const uint16_t* a, float* y) {
+        table().axpy[size_t(fmt)](n, alpha, a, y);
+    }
+
+    bool vectorized() {
+        return table().vectorized;
+    }
+}}
@@ -0,0 +1,209 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include "linalg/common.h"
+#include "linalg/blas_prelude.h"
+#include "linalg/blas_profile.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <assert.h>
+
+namespace ss {
+namespace half
+{
+    /*  16-bit storage formats for matrices which are read far more often
+     *  than they are written. Elements are converted to float as they are
+     *  loaded and every product is accumulated in float.
+     *
+     *    fp16 : IEEE 754 binary16, 11 significant bits and a range of 6e-5..65504
+     *    bf16 : the upper half of a float, 8 significant bits and the range of float
+     */
+    enum class format : uint8_t { fp16, bf16 };
+
+    /* conversions --------------------------------------------------------- */
+
+    inline uint32_t bits(float f) {
+        uint32_t u; std::memcpy(&u, &f, sizeof(u)); return u;
+    }
+
+    inline float from_bits(uint32_t u) {
+        float f; std::memcpy(&f, &u, sizeof(f)); return f;
+    }
+
+    /* rounds to the nearest fp16, ties to even */
+    inline uint16_t to_fp16(float f)
+    {
+        const uint32_t x    = bits(f);
+        const uint32_t sign = (x >> 16) & 0x8000u;
+        const int32_t  exp  = int32_t((x >> 23) & 0xff) - 127 + 15;
+        uint32_t       mant = x & 0x7fffffu;
+
+        if ((x & 0x7fffffffu) > 0x7f800000u) { return uint16_t(sign | 0x7e00u); } /* nan */
+        if (exp >= 31)                       { return uint16_t(sign | 0x7c00u); } /* inf */
+
+        if (exp <= 0)
+        {   /* subnormal, or zero */
+            if (exp < -10) { return uint16_t(sign); }
+
+            mant |= 0x800000u;
+            const uint32_t shift = uint32_t(14 - exp);
+            const uint32_t half  = 1u << (shift - 1);
+            const uint32_t rem   = mant & ((1u << shift) - 1);
+
+            uint32_t h = mant >> shift;
+            if (rem > half || (rem == half && (h & 1))) { h++; }
+            return uint16_t(sign | h);
+        }
+
+        /* a carry out of the mantissa correctly increments the exponent */
+        uint32_t h = sign | (uint32_t(exp) << 10) | (mant >> 13);
+        const uint32_t rem = mant & 0x1fffu;
+        if (rem > 0x1000u || (rem == 0x1000u && (h & 1))) { h++; }
+        return uint16_t(h);
+    }
+
+    inline float from_fp16(uint16_t h)
+    {
+        const uint32_t sign = uint32_t(h & 0x8000u) << 16;
+        const uint32_t exp  = (h >> 10) & 0x1fu;
+        const uint32_t mant = h & 0x3ffu;
+
+        if (exp == 0) {
+            const float f = std::ldexp(float(mant), -24);
+            return sign ? -f : f;
+        }
+        if (exp == 31) {
+            return from_bits(sign | 0x7f800000u | (mant << 13));
+        }
+        return from_bits(sign | ((exp + 112) << 23) | (mant << 13));
+    }
+
+    /* rounds to the nearest bf16, ties to even */
+    inline uint16_t to_bf16(float f)
+    {
+        uint32_t x = bits(f);
+
+        if ((x & 0x7fffffffu) > 0x7f800000u) { return uint16_t((x >> 16) | 0x40u); }
+
+        x += 0x7fffu + ((x >> 16) & 1);
+        return uint16_t(x >> 16);
+    }
+
+    inline float from_bf16(uint16_t h) {
+        return from_bits(uint32_t(h) << 16);
+    }
+
+    inline uint16_t encode(format fmt, float f) {
+        return fmt == format::fp16 ? to_fp16(f) : to_bf16(f);
+    }
+
+    inline float decode(format fmt, uint16_t h) {
+        return fmt == format::fp16 ? from_fp16(h) : from_bf16(h);
+    }
+
+    /* kernels ------------------------------------------------------------- */
+
+    /*  Selected on first use: AVX2/F16C where the cpu supports them,
+     *  otherwise portable loops.
+     */
+
+    /* returns sum(a[i] * x[i]) for i in [0, n) */
+    float dot(format fmt, size_t n, const uint16_t* a, const float* x);
+
+    /* y[i] += alpha * a[i] for i in [0, n) */
+    void axpy(format fmt, size_t n, float alpha, const uint16_t* a, float* y);
+
+    /* whether the vectorized kernels are in use */
+    bool vectorized();
+
+    /* matrices ------------------------------------------------------------ */
+
+    /* a non-owning view of a column-major m x n matrix in 16-bit storage */
+    struct matrix
+    {
+        std::array<size_t, 2> dims;
+        const uint16_t*       data;
+        format                fmt;
+
+        const std::array<size_t, 2>& shape() const { return dims; }
+
+        const uint16_t* column(size_t j) const { return data + j * dims[0]; }
+    };
+
+    /* the column-major 16-bit copy of A */
+    template <typename T>
+    std::vector<uint16_t> column_major(format fmt, const ndspan<T, 2> A)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+        std::vector<uint16_t> copy(m * n);
+
+        for (size_t j = 0; j < n; j++) {
+            for (size_t i = 0; i < m; i++) { copy[j * m + i] = encode(fmt, float(A(i, j))); }
+        }
+        return copy;
+    }
+
+    /*  y := alpha * op(A) * x + beta * y, accumulated in float. A * x skips
+     *  the columns where x is zero, which suits the homotopy solver.
+     */
+    template <typename T>
+    void gemv(CBLAS_TRANSPOSE trans, T alpha,
+        const matrix& A, const ndspan<T> x, T beta, ndspan<T> y)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+
+        SS_BLAS_PROFILE(T, trans == CblasNoTrans ?
+            blas::profile::op::gemv_n_half : blas::profile::op::gemv_t_half,
+            2.0 * m * n, 0.5 * m * n + m + n);
+
+        if (trans != CblasNoTrans)
+        {
+            assert(x.size() == m && y.size() == n);
+
+            std::vector<float> xf(x.cbegin(), x.cend());
+
+            for (size_t j = 0; j < n; j++)
+            {
+                const T s = T(dot(A.fmt, m, A.column(j), xf.data()));
+                y[j] = (beta == T(0)) ? alpha * s : alpha * s + beta * y[j];
+            }
+            return;
+        }
+
+        assert(x.size() == n && y.size() == m);
+
+        std::vector<float> yf(m, 0.f);
+
+        for (size_t j = 0; j < n; j++) {
+            if (x[j] != T(0)) { axpy(A.fmt, m, float(alpha * x[j]), A.column(j), yf.data()); }
+        }
+        for (size_t i = 0; i < m; i++) {
+            y[i] = (beta == T(0)) ? T(yf[i]) : T(yf[i]) + beta * y[i];
+        }
+    }
+
+    /* writes column j of A to the dense vector `out` of length m */
+    template <typename T>
+    void column(const matrix& A, size_t j, T* out)
+    {
+        const uint16_t* col = A.column(j);
+
+        for (size_t i = 0; i < dim<0>(A); i++) { out[i] = T(decode(A.fmt, col[i])); }
+    }
+}}
@@ -0,0 +1,127 @@
+#include <linalg/half.h>
+#include <linalg/blas_wrapper.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using xt::xtensor;
+using namespace ss::half;
+
+TEST(half, fp16_conversion)
+{
+    /* exactly representable */
+    for (float f : { 0.f, 1.f, -2.f, .5f, 65504.f, 1.f / 1024, std::ldexp(1.f, -24) }) {
+        EXPECT_EQ(f, from_fp16(to_fp16(f)));
+    }
+
+    /* ties round to even */
+    EXPECT_EQ(1.f, from_fp16(to_fp16(1.f + std::ldexp(1.f, -11))));
+    EXPECT_EQ(1.f + std::ldexp(1.f, -9), from_fp16(to_fp16(1.f + 3 * std::ldexp(1.f, -11))));
+
+    /* overflow, underflow and nan */
+    EXPECT_EQ(std::numeric_limits<float>::infinity(), from_fp16(to_fp16(1e6f)));
+    EXPECT_EQ(0.f, from_fp16(to_fp16(1e-9f)));
+    EXPECT_TRUE(std::isnan(from_fp16(to_fp16(std::numeric_limits<float>::quiet_NaN()))));
+
+    /* relative error of a normal value is at most 2^-11 */
+    EXPECT_NEAR(3.14159f, from_fp16(to_fp16(3.14159f)), 3.14159f * std::ldexp(1.f, -11));
+}
+
+TEST(half, bf16_conversion)
+{
+    for (float f : { 0.f, 1.f, -2.f, .5f, 1e30f, std::ldexp(1.f, -120) }) {
+        EXPECT_EQ(from_bf16(to_bf16(f)), f);
+    }
+
+    /* ties round to even */
+    EXPECT_EQ(1.f, from_bf16(to_bf16(1.f + std::ldexp(1.f, -8))));
+    EXPECT_EQ(1.f + std::ldexp(1.f, -6), from_bf16(to_bf16(1.f + 3 * std::ldexp(1.f, -8))));
+
+    EXPECT_TRUE(std::isnan(from_bf16(to_bf16(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_NEAR(3.14159f, from_bf16(to_bf16(3.14159f)), 3.14159f * std::ldexp(1.f, -8));
+}
+
+namespace
+{
+    /* the kernels agree with decoding element-wise, for every tail length */
+    void test_kernels(format fmt)
+    {
+        xt::random::seed(0);
+
+        for (size_t n : { 0, 1, 7, 8, 15, 16, 17, 100 })
+        {
+            xtensor<float, 1> a = xt::random::randn<float>({ n });
+            xtensor<float, 1> x = xt::random::randn<float>({ n });
+            xtensor<float, 1> y = xt::random::randn<float>({ n });
+
+            std::vector<uint16_t> h(n);
+            for (size_t i = 0; i < n; i++) { h[i] = encode(fmt, a[i]); }
+
+            double expect = 0;
+            for (size_t i = 0; i < n; i++) { expect += double(decode(fmt, h[i])) * x[i]; }
+
+            EXPECT_NEAR(expect, dot(fmt, n, h.data(), x.raw_data()), 1e-4);
+
+            xtensor<float, 1> z = y;
+            axpy(fmt, n, .5f, h.data(), z.raw_data());
+
+            for (size_t i = 0; i < n; i++) {
+                EXPECT_NEAR(y[i] + .5f * decode(fmt, h[i]), z[i], 1e-5);
+            }
+        }
+    }
+
+    /* products with a 16-bit matrix agree with the dense products */
+    template <typename T>
+    void test_gemv(format fmt, size_t m, size_t n)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::randn<T>({ m, n });
+        auto storage = column_major<T>(fmt, ss::as_span(A));
+        const matrix H = { { m, n }, storage.data(), fmt };
+
+        /* the dense matrix of the rounded values */
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) { A(i, j) = T(decode(fmt, storage[j * m + i])); }
+        }
+
+        xtensor<T, 1> x = xt::random::randn<T>({ n });
+        xtensor<T, 1> r = xt::random::randn<T>({ m });
+        x[1] = T(0);
+
+        xtensor<T, 1> y  = xt::ones<T>({ m }), expect_y = y;
+        xtensor<T, 1> c  = xt::ones<T>({ n }), expect_c = c;
+
+        gemv<T>(CblasNoTrans, T(2), H, ss::as_span(x), T(.5), ss::as_span(y));
+        gemv<T>(CblasTrans,   T(2), H, ss::as_span(r), T(.5), ss::as_span(c));
+
+        ss::blas::xgemv<T>(CblasNoTrans, T(2), A, x, T(.5), expect_y);
+        ss::blas::xgemv<T>(CblasTrans,   T(2), A, r, T(.5), expect_c);
+
+        for (size_t i = 0; i < m; i++) { EXPECT_NEAR(expect_y[i], y[i], 1e-3); }
+        for (size_t j = 0; j < n; j++) { EXPECT_NEAR(expect_c[j], c[j], 1e-3); }
+
+        std::vector<T> col(m);
+        column(H, 2, col.data());
+        for (size_t i = 0; i < m; i++) { EXPECT_EQ(A(i, 2), col[i]); }
+    }
+}
+
+TEST(half, kernels)
+{
+    test_kernels(format::fp16);
+    test_kernels(format::bf16);
+}
+
+TEST(half, gemv)
+{
+    test_gemv<float>(format::fp16, 37, 5);
+    test_gemv<float>(format::bf16, 5, 37);
+    test_gemv<double>(format::fp16, 16, 16);
+    test_gemv<double>(format::bf16, 19, 3);
+}
@@ -0,0 +1,184 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include "linalg/common.h"
+#include "linalg/blas_wrapper.h"
+#include "linalg/cholesky_decomposition.h"
+#include "linalg/qr_decomposition.h"
+
+#include <ss/ndspan.h>
+#include <xtensor/xtensor.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace ss
+{
+    /*  Solves A*x == b (or the least squares problem, when A has more
+     *  rows than columns) to the precision of x, given a factorization F
+     *  of A computed in the lower precision S.
+     *
+     *  The residual b - A*x is accumulated in the precision of x, and each
+     *  correction to x is solved with F in precision S. F is any of the
+     *  decompositions which implement solve(ndspan<S>, ndspan<S>).
+     *
+     *    returns : the number of refinement steps performed
+     */
+    template <typename F, typename S, typename T>
+    uint32_t refine_solve(
+        const F&           factorization,
+        const ndspan<S, 2> A,
+        const ndspan<T>    b,
+        ndspan<T>          x,
+        uint32_t           max_iterations = 10);
+
+    /*  The orthogonal factor of A, of m rows and n columns, in the precision
+     *  T, given the factorization QR of A computed in the lower precision S.
+     *  Q is A inv(R), orthogonalized once more in precision T (by Cholesky
+     *  QR, which is stable here since A inv(R) is orthogonal to the
+     *  precision of S), so spans the range of A and has orthonormal columns
+     *  to the precision of T. Casting QR.q() to T is accurate only to S.
+     *
+     *  When A is too ill-conditioned for S, A inv(R) may not be of full
+     *  rank in T, and Q is instead the orthogonal factor of a QR
+     *  factorization of A computed in precision T.
+     */
+    template <typename T, typename S>
+    xt::xtensor<T, 2> refine_q(
+        const qr_decomposition<S>& QR,
+        const ndspan<S, 2>         A);
+}
+
+/* Definions --------------------------------------------------------------- */
+
+namespace ss { namespace detail
+{
+    /* r := b - A*x, accumulated in the precision of x */
+    template <typename S, typename T>
+    void mixed_residual(
+        const ndspan<S, 2> A, const ndspan<T> b, const ndspan<T> x, ndspan<T> r)
+    {
+        const size_t M = dim<0>(A), N = dim<1>(A);
+        const size_t s0 = stride<0>(A), s1 = stride<1>(A);
+
+        const S* a = A.raw_data() + A.raw_data_offset();
+
+        for (size_t m = 0; m < M; m++) {
+            const S* row = &a[m * s0];
+            T acc = b(m);
+
+            for (size_t n = 0; n < N; n++) {
+                acc -= T(row[n * s1]) * x(n);
+            }
+            r(m) = acc;
+        }
+    }
+
+    template <typename E>
+    auto max_abs(const E& e)
+    {
+        using T = typename E::value_type;
+
+        T max{ 0 };
+        for (const T& v : e) { max = std::max(max, std::abs(v)); }
+        return max;
+    }
+}}
+
+namespace ss
+{
+    template <typename F, typename S, typename T>
+    uint32_t refine_solve(
+        const F&           factorization,
+        const ndspan<S, 2> A,
+        const ndspan<T>    b,
+        ndspan<T>          x,
+        uint32_t           max_iterations)
+    {
+        const size_t M = dim<0>(A), N = dim<1>(A);
+        assert(dim<0>(b) == M && dim<0>(x) == N);
+
+        const T eps = std::numeric_limits<T>::epsilon() * T(N);
+
+        auto r  = xt::xtensor<T, 1>::from_shape({ M });
+        auto rs = xt::xtensor<S, 1>::from_shape({ M });
+        auto ds = xt::xtensor<S, 1>::from_shape({ N });
+
+        /* initial solution in precision S */
+        std::copy(b.cbegin(), b.cend(), rs.begin());
+        factorization.solve(as_span(rs), as_span(ds));
+        std::copy(ds.cbegin(), ds.cend(), x.begin());
+
+        T prev = std::numeric_limits<T>::max();
+        uint32_t iter{ 0u };
+
+        while (iter < max_iterations) {
+            iter++;
+
+            /* correction d = solve(b - A*x) */
+            detail::mixed_residual(A, b, x, as_span(r));
+            std::copy(r.cbegin(), r.cend(), rs.begin());
+            factorization.solve(as_span(rs), as_span(ds));
+
+            auto xi = x.begin();
+            for (const S& d : ds) { *xi++ += T(d); }
+
+            /* stop when the correction is negligible, or has stopped
+               decreasing (A is too ill-conditioned for S) */
+            const T dnorm = T(detail::max_abs(ds));
+            if (dnorm <= eps * detail::max_abs(x) || dnorm > prev / 2) {
+                break;
+            }
+            prev = dnorm;
+        }
+
+        return iter;
+    }
+
+    template <typename T, typename S>
+    xt::xtensor<T, 2> refine_q(
+        const qr_decomposition<S>& QR,
+        const ndspan<S, 2>         A)
+    {
+        const size_t M = dim<0>(A), N = dim<1>(A);
+
+        xt::xtensor<T, 2> A_T = xt::xtensor<T, 2>::from_shape({ M, N });
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) { A_T(m, n) = T(A(m, n)); }
+        }
+        xt::xtensor<T, 2> Q = A_T;
+        xt::xtensor<T, 2> R = QR.r();
+
+        /* Q = A inv(R) */
+        blas::xtrsm(CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit,
+            T{1}, as_span(R), as_span(Q));
+
+        /* Q = Q inv(transpose(L)), where L transpose(L) = transpose(Q) Q */
+        xt::xtensor<T, 2> G = blas::xgemm(CblasTrans, CblasNoTrans, T{1}, Q, Q);
+        cholesky_decomposition<T> chol(as_span(G));
+
+        if (!chol.isspd()) {
+            /* A inv(R) is rank deficient in T, so factorize A in T instead */
+            return qr_decomposition<T>(as_span(A_T)).q();
+        }
+
+        blas::xtrsm(CblasRight, CblasLower, CblasTrans, CblasNonUnit,
+            T{1}, chol.l(), as_span(Q));
+        return Q;
+    }
+}
@@ -0,0 +1,144 @@
+#include <linalg/iterative_refinement.h>
+#include <linalg/cholesky_decomposition.h>
+#include <linalg/qr_decomposition.h>
+
+#include <gtest/gtest.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+
+using xt::xtensor;
+using ss::as_span;
+using ss::dim;
+
+namespace
+{
+    template <typename Decomposition>
+    void test_refinement(
+        const xtensor<double, 2>& A, const xtensor<double, 1>& b)
+    {
+        using F = typename Decomposition::template type<float>;
+        using D = typename Decomposition::template type<double>;
+
+        /* single precision storage of A */
+        xtensor<float, 2> A_f = A;
+        xtensor<double, 2> A_d = A_f;
+
+        /* reference solution in double precision */
+        xtensor<double, 1> x_expect = xt::zeros<double>({ dim<1>(A) });
+        D reference{ as_span(A_d) };
+        reference.solve(b, x_expect);
+
+        /* single precision solution */
+        xtensor<float, 1> b_f = b;
+        xtensor<float, 1> x_f = xt::zeros<float>({ dim<1>(A) });
+        F factorization{ as_span(A_f) };
+        factorization.solve(b_f, x_f);
+
+        /* refined solution */
+        xtensor<double, 1> x = xt::zeros<double>({ dim<1>(A) });
+        uint32_t iter = ss::refine_solve(factorization, as_span(A_f), as_span(b), as_span(x));
+
+        EXPECT_GE(iter, 1);
+        EXPECT_FALSE(xt::allclose(x_f, x_expect, 0.0, 1e-10));
+        EXPECT_TRUE(xt::allclose(x, x_expect, 0.0, 1e-10));
+    }
+
+    struct cholesky {
+        template <typename T> using type = ss::cholesky_decomposition<T>;
+    };
+
+    struct qr {
+        template <typename T> using type = ss::qr_decomposition<T>;
+    };
+}
+
+TEST(iterative_refinement, cholesky)
+{
+    xt::random::seed(0);
+
+    const int N = 50;
+    xtensor<double, 2> noise = xt::random::randn({ N, N }, 0.0f, 1.0f);
+    xtensor<double, 2> A = ss::blas::xgemm(CblasNoTrans, CblasTrans, double{1}, noise, noise);
+    for (int n = 0; n < N; n++) { A(n, n) += N; }
+
+    xtensor<double, 1> b = xt::random::randn({ N }, 0.0f, 1.0f);
+
+    ::test_refinement<::cholesky>(A, b);
+}
+
+TEST(iterative_refinement, qr)
+{
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ 50, 50 }, 0.0f, 1.0f);
+    xtensor<double, 1> b = xt::random::randn({ 50 }, 0.0f, 1.0f);
+
+    ::test_refinement<::qr>(A, b);
+}
+
+namespace
+{
+    /* orthonormal columns, and A = Q transpose(Q) A, to double precision */
+    void check_orthogonal_factor(const xtensor<double, 2>& Q, const xtensor<double, 2>& A)
+    {
+        const size_t M = dim<0>(A), N = dim<1>(A);
+
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                double g{ 0 };
+                for (size_t m = 0; m < M; m++) { g += Q(m, i) * Q(m, j); }
+                EXPECT_NEAR(i == j ? 1.0 : 0.0, g, 1e-13);
+            }
+        }
+
+        xtensor<double, 2> QtA = xt::zeros<double>({ N, N });
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                for (size_t m = 0; m < M; m++) { QtA(i, j) += Q(m, i) * A(m, j); }
+            }
+        }
+        for (size_t m = 0; m < M; m++) {
+            for (size_t j = 0; j < N; j++) {
+                double a{ 0 };
+                for (size_t i = 0; i < N; i++) { a += Q(m, i) * QtA(i, j); }
+                EXPECT_NEAR(A(m, j), a, 1e-12);
+            }
+        }
+    }
+}
+
+TEST(iterative_refinement, orthogonal_factor)
+{
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ 40, 10 }, 0.0, 1.0);
+    xtensor<float, 2> A_f = A;
+    xtensor<double, 2> A_d = A_f;
+
+    ss::qr_decomposition<float> QR(as_span(A_f));
+    check_orthogonal_factor(ss::refine_q<double>(QR, as_span(A_f)), A_d);
+}
+
+TEST(iterative_refinement, orthogonal_factor_ill_conditioned)
+{
+    xt::random::seed(0);
+
+    /*  a column of zeros, the limit of ill-conditioning: R has a zero on
+     *  its diagonal, so A inv(R) isn't finite, and Q is factorized in
+     *  double precision instead
+     */
+    xtensor<double, 2> A = xt::random::randn({ 40, 10 }, 0.0, 1.0);
+    xt::view(A, xt::all(), 3) = 0.0;
+
+    xtensor<float, 2> A_f = A;
+    xtensor<double, 2> A_d = A_f;
+
+    ss::qr_decomposition<float> QR(as_span(A_f));
+    xtensor<double, 2> Q = ss::refine_q<double>(QR, as_span(A_f));
+
+    EXPECT_TRUE(xt::all(xt::isfinite(Q)));
+    check_orthogonal_factor(Q, A_d);
+}
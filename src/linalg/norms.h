@@ -14,9 +14,13 @@ limitations under the License.  */
 #pragma once
 
 #include "linalg/common.h"
+#include "ss/sparse.h"
 #include <xtensor/xview.hpp>
 #include <xtensor/xnorm.hpp>
 
+#include <cmath>
+#include <vector>
+
 namespace ss
 {
     template <typename T>
@@ -26,6 +30,30 @@ namespace ss
         view(A) /= sums;
     }
 
+    template <typename T>
+    void l1(csc_span<T> A)
+    {
+        std::vector<T> sums(dim<1>(A));
+
+        for (size_t j = 0; j < dim<1>(A); j++)
+        {
+            T s{ 0 };
+            for (int32_t k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++) { s += std::abs(A.values[k]); }
+            sums[j] = s;
+
+            for (int32_t k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++) { A.values[k] /= s; }
+        }
+
+        /* keep the CSR mirror consistent */
+        if (A.has_csr()) {
+            for (size_t i = 0; i < dim<0>(A); i++) {
+                for (int32_t k = A.row_ptr[i]; k < A.row_ptr[i + 1]; k++) {
+                    A.row_values[k] /= sums[A.col_indices[k]];
+                }
+            }
+        }
+    }
+
     template <typename T>
     void l1(ndspan<T, 1> x)
     {
@@ -52,12 +52,18 @@ namespace ss
         const size_t N() { return _n; }
 
       private:
-        /* A_gamma transposed */
+        /* grows the inverse such that it can hold n columns */
+        void reserve(size_t n);
+
+        /* A_gamma transposed, with rows padded to _ldt */
         aligned_vector<T> _At;
-        /* the inverse of A_gamma */
+        /* the inverse of A_gamma, with rows padded to _ld */
         aligned_vector<T> _inv;
         /* fixed size of columns in the inverse */
         const size_t _m;
+        /* leading dimensions of _At and _inv */
+        const size_t _ldt;
+        size_t _ld;
         /* number of colunms currently in the inverse */
         size_t _n;
     };
@@ -71,7 +77,8 @@ namespace ss { namespace detail
 
     /*  Permutes the given square matrix `A` such that the row and column `src`
      *  is moved to `dest`, with intermediate rows and columns shifted to
-     *  account for this movement.
+     *  account for this movement. Rows must be contiguous, but may be
+     *  padded.
      */
     KERNEL_DECL(square_permute, compute_mode::CPU)
     {
@@ -80,21 +87,25 @@ namespace ss { namespace detail
         {
             using rit = std::reverse_iterator<T*>;
             assert(dim<0>(A) == dim<1>(A));
+            assert(dim<1>(A) == 1 || stride<1>(A) == 1);
 
             T* ptr = &A(0, 0);
             const ptrdiff_t N = dim<1>(A), srci = src, desti = dest;
 
+            /* the leading dimension */
+            const ptrdiff_t LD = std::max(N, ptrdiff_t(stride<0>(A)));
+
             if (N == 1 || desti == srci) {
                 return;
             }
             else if (desti > srci) {
                 /* traverse forwards over all rows */
-                for (ptrdiff_t m = 0, i = 0; m < N; m++, i += N) {
+                for (ptrdiff_t m = 0, i = 0; m < N; m++, i += LD) {
                     T* row = &ptr[i];
 
                     if (m >= srci && m < desti) {
                         /* single row rotation */
-                        std::rotate(row, &row[N], &row[N + N]);
+                        std::rotate(row, &row[LD], &row[LD + LD]);
                     }
                     /* column rotation */
                     std::rotate(&row[srci], &row[srci + 1], &row[desti + 1]);
@@ -102,12 +113,12 @@ namespace ss { namespace detail
             }
             else {
                 /* traverse backwards over all rows */
-                for (ptrdiff_t m = N-1, i = (N * N); m >= 0; m--, i -= N) {
-                    T* row = &ptr[i - N];
+                for (ptrdiff_t m = N-1, i = (N * LD); m >= 0; m--, i -= LD) {
+                    T* row = &ptr[i - LD];
 
                     if (m <= srci && m > desti) {
                         /* single row rotation */
-                        std::rotate(&row[-N], row, &row[N]);
+                        std::rotate(&row[-LD], row, &row[LD]);
                     }
                     /* column rotation */
                     std::rotate(rit(&row[srci + 1]), rit(&row[srci]), rit(&row[desti]));
@@ -174,10 +185,29 @@ namespace ss
     template <typename T>
     online_column_inverse<T>::online_column_inverse(size_t m, size_t capacity)
         : _m{ m }
+        , _ldt{ padded<T>(m) }
+        , _ld{ 0u }
         , _n{ 0u }
     {
-        _inv.reserve(capacity * capacity);
-        _At.reserve(capacity * m);
+        reserve(std::max(capacity, size_t(1)));
+        _At.reserve(capacity * _ldt);
+    }
+
+    template <typename T>
+    void online_column_inverse<T>::reserve(size_t n)
+    {
+        if (n <= _ld) { return; }
+
+        /* at least double, such that growing by a column at a time is amortized */
+        const size_t ld = padded<T>(std::max(n, 2 * _ld));
+        aligned_vector<T> inv(ld * ld, T(0));
+
+        for (size_t i = 0; i < _n; i++) {
+            std::copy_n(&_inv[i * _ld], _n, &inv[i * ld]);
+        }
+
+        _inv.swap(inv);
+        _ld = ld;
     }
 
     template <typename T>
@@ -189,48 +219,50 @@ namespace ss
 
         const size_t m = _m;
         const size_t n = _n;
+        const size_t ldt = _ldt;
+
+        /* append a zero padded row to A_gamma transposed */
+        _At.resize((n + 1) * ldt, T(0));
+        T* row = &_At[n * ldt];
+        std::copy(begin, end, row);
 
         if (n == 0) {
             /* initialize */
-            _At.insert(_At.begin(), begin, end);
-
-            T A_gamma_norm{ blas::xnrm2(m, _At.data(), 1) };
+            T A_gamma_norm{ blas::xnrm2(m, row, 1) };
             T inv_at_A { T(1) / (A_gamma_norm * A_gamma_norm) };
 
-            _inv.push_back(inv_at_A);
+            _inv[0] = inv_at_A;
         }
         else {
             /* compute the inverse as if adding a column to the end */
-            xt::xtensor<T, 1> u1({ n }, xt::layout_type::row_major);
+            vec<T> u1({ n }, xt::layout_type::row_major);
 
             T dot = 0;
             {
-                /* append the input */
-                auto row = _At.insert(_At.end(), begin, end);
-
                 /* dot product of the new row */
-                auto row_span = as_span(std::addressof(*row), m);
+                auto row_span = as_span(row, m);
 
                 /* current view of A_sub_t */
-                auto At = as_span<2>(_At.data(), { n, m });
+                auto At = as_span<2>(_At.data(), { n, m }, { ldt, 1 });
 
                 dot = blas::xdot(row_span, row_span);
                 blas::xgemv<T>(CblasNoTrans, 1.0, At, row_span, 0.0, u1);
 
                 /* move the new row to the new row point */
-                std::rotate(_At.begin() + idx * m, row, _At.end());
+                std::rotate(_At.begin() + idx * ldt, _At.begin() + n * ldt, _At.end());
             }
 
-            xt::xtensor<T, 1> u2({ n }, xt::layout_type::row_major);
+            vec<T> u2({ n }, xt::layout_type::row_major);
             blas::xgemv<T>(CblasNoTrans, 1.0, inverse(), u1, 0.0, u2);
 
             /* update existing inverse */
             T d = T(1) / (dot - blas::xdot(u1, u2));
             blas::xger(d, u2, u2, inverse());
 
-            /* make space in the inverse */
-            kernelpp::run<detail::insert_last_rowcol>(_inv, n, n, T(0));
-            auto new_inv = as_span<2>(_inv.data(), { n + 1, n + 1 });
+            /* make space in the inverse; within the leading dimension
+               the new row and column need no shifting */
+            reserve(n + 1);
+            auto new_inv = as_span<2>(_inv.data(), { n + 1, n + 1 }, { _ld, 1 });
 
             /* assign the bottom row/right-most column with -d * u2 */
             for (size_t i{ 0 }; i < n; ++i)
@@ -255,39 +287,34 @@ namespace ss
     {
         assert(idx < N());
 
-        const size_t m = _m;
         const size_t n = _n;
+        const size_t ld = _ld;
 
-        if (n == 1) {
-            _inv.clear();
-            _At.clear();
+        {   /* erase row from the transposed subset */
+            auto it = _At.begin() + (idx * _ldt);
+            _At.erase(it, it + _ldt);
         }
-        else {
+
+        if (n > 1) {
             /* permute to bring the column at the end in X */
             auto inv = inverse();
 
-            {   /* erase row from the transposed subset */
-                auto it = _At.begin() + (idx * m);
-                _At.erase(it, it + m);
-            }
-
             /* shift to last column */
             kernelpp::run<detail::square_permute>(inv, idx, dim<1>(inv) - 1);
 
             /* update the inverse by removing the last column */
             T d = inv(n - 1, n - 1);
-            blas::xscal(n - 1, -(T(1) / d), &inv(0, n - 1), n);
+            blas::xscal(n - 1, -(T(1) / d), &inv(0, n - 1), ld);
 
             /* A := alpha*x*y**T + A
                 note: A - d * x == -d * x + A
              */
             blas::xger(CblasRowMajor, n - 1, n - 1, -d,
-                &inv(0, n - 1), n,
-                &inv(0, n - 1), n,
-                &inv(0, 0),     n);
+                &inv(0, n - 1), ld,
+                &inv(0, n - 1), ld,
+                &inv(0, 0),     ld);
 
-            /* remove the last row/col */
-            kernelpp::run<detail::erase_last_rowcol>(_inv, n, n);
+            /* the last row/col is left in place, beyond the new size */
         }
         _n--;
     }
@@ -295,7 +322,7 @@ namespace ss
     template <typename T>
     const mat_view<T> online_column_inverse<T>::inverse()
     {
-        assert(_inv.size() >= N() * N());
-        return as_span<2>(_inv.data(), { N(), N() });
+        assert(_inv.size() >= N() * _ld);
+        return as_span<2>(_inv.data(), { N(), N() }, { _ld, 1 });
     }
 }
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include <linalg/online_inverse.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+
+#include <benchmark/benchmark.h>
+
+using xt::xtensor;
+
+namespace
+{
+    /* grows and shrinks the inverse by one column at a time, which is
+       dominated by small k-sized gemv/ger/dot calls */
+    inline void online_inverse_insert_remove_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const uint32_t M = state.range(0);
+        const uint32_t K = state.range(1);
+
+        /* make some noise */
+        xtensor<float, 2> A = xt::random::randn({ K, M }, .5f, .1f);
+        ss::online_column_inverse<float> inv(M, K);
+
+        while (state.KeepRunning()) {
+            for (uint32_t k = 0; k < K; k++) {
+                auto col = xt::view(A, k, xt::all());
+                inv.insert(k, col.begin(), col.end());
+            }
+            for (uint32_t k = K; k > 0; k--) {
+                inv.remove(k - 1);
+            }
+            benchmark::ClobberMemory();
+        }
+    }
+}
+
+BENCHMARK(online_inverse_insert_remove_bench)
+    ->RangeMultiplier(2)
+    ->Unit(benchmark::kMicrosecond)
+    ->Ranges({ { 64, 256 } /* M */, { 4, 16 } /* K */ });
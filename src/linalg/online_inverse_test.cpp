@@ -6,6 +6,9 @@
 #include <xtensor/xrandom.hpp>
 #include <xtensor/xview.hpp>
 
+#include <cstdint>
+#include <vector>
+
 using xt::xtensor;
 using ss::mat;
 using kernelpp::run;
@@ -215,4 +218,68 @@ TEST(online_inverse, identity)
 
     inv.remove(0);
     EXPECT_EQ(0, inv.N());
-}
\ No newline at end of file
+}
+TEST(online_inverse, square_permute_padded)
+{
+    using op = ::ss::detail::square_permute;
+
+    /* a 3x3 matrix with rows padded to 5 */
+    ss::aligned_vector<float> buf{
+        1, 2, 3, -1, -1,
+        4, 5, 6, -1, -1,
+        7, 8, 9, -1, -1
+    };
+    auto A = ss::as_span<2>(buf.data(), { 3, 3 }, { 5, 1 });
+
+    const ss::mat<float> expect {
+        {5, 6, 4},
+        {8, 9, 7},
+        {2, 3, 1}
+    };
+
+    EXPECT_FALSE(run<op>(A, 0, 2));
+    EXPECT_EQ(A, expect);
+
+    EXPECT_FALSE(run<op>(A, 2, 0));
+    EXPECT_EQ(A, (ss::mat<float>{ {1, 2, 3}, {4, 5, 6}, {7, 8, 9} }));
+}
+
+TEST(online_inverse, growth)
+{
+    const size_t M = 100, K = 40;
+    xt::random::seed(0);
+
+    /* columns inserted at the front, middle and back, beyond the initial capacity */
+    xtensor<double, 2> A = xt::random::randn<double>({ M, K });
+    ss::online_column_inverse<double> inv(M, 2);
+    std::vector<size_t> order;
+
+    for (size_t k = 0; k < K; k++)
+    {
+        const size_t idx = (k * 7) % (order.size() + 1);
+        auto col = xt::view(A, xt::all(), k);
+
+        inv.insert(idx, col.cbegin(), col.cend());
+        order.insert(order.begin() + idx, k);
+    }
+
+    /* the inverse of transpose(A_gamma) * A_gamma, in insertion order */
+    const auto I = inv.inverse();
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(&I(0, 0)) % ss::cache_line);
+
+    for (size_t i = 0; i < K; i++) {
+        for (size_t j = 0; j < K; j++)
+        {
+            double s = 0;
+            for (size_t k = 0; k < K; k++) {
+                double g = 0;
+                for (size_t m = 0; m < M; m++) { g += A(m, order[k]) * A(m, order[j]); }
+                s += I(i, k) * g;
+            }
+            EXPECT_NEAR(i == j ? 1.0 : 0.0, s, 1e-8);
+        }
+    }
+
+    for (size_t k = K; k > 0; k--) { inv.remove((k * 3) % k); }
+    EXPECT_EQ(0u, inv.N());
+}
@@ -19,6 +19,20 @@ limitations under the License.  */
 #include <ss/ndspan.h>
 #include <xtensor/xtensor.hpp>
 #include <cassert>
+#include <utility>
+
+namespace ss{ namespace detail
+{
+    /* whether a diagonal of R has no exact zero, as ?trtrs checks */
+    template <typename T>
+    bool nonsingular(const xt::xtensor<T, 1>& rdiag)
+    {
+        for (const T& d : rdiag) {
+            if (d == T{0}) { return false; }
+        }
+        return true;
+    }
+}}
 
 namespace ss
 {
@@ -28,12 +42,29 @@ namespace ss
      *  The routine does not form the matrix Q explicitly. Instead, Q is
      *  represented as a product of min(m, n) elementary reflectors.
      *  Routines are provided to work with Q in this representation.
+     *
+     *  With the lapack backend (the default where the loaded BLAS library
+     *  exports ?geqrf) the factorization is computed by ?geqrf and stored
+     *  column-major, in the LAPACK representation.
      */
     template <typename T>
     class qr_decomposition
     {
       public:
-        qr_decomposition(const ndspan<T, 2> A);
+        qr_decomposition(const ndspan<T, 2> A,
+            decomposition_backend backend = decomposition_backend::automatic);
+
+        /*  Restores a factorization from the stored parts of another, as
+         *  returned by lapack(), factors(), rdiag() and tau().
+         */
+        qr_decomposition(bool lapack,
+            xt::xtensor<T, 2> qr, xt::xtensor<T, 1> rdiag, xt::xtensor<T, 1> tau)
+            : _lapack{ lapack }
+            , _qr(std::move(qr))
+            , _rdiag(std::move(rdiag))
+            , _tau(std::move(tau))
+            , _isfullrank{ detail::nonsingular(_rdiag) }
+        {}
 
         xt::xtensor<T, 2> q() const;
         xt::xtensor<T, 2> r() const;
@@ -44,15 +75,35 @@ namespace ss
          *  equation A*X = B and returns X.  X has the following properties:
          *    - X is the matrix that minimizes the two norm of A*X-B, i.e. it
          *      minimizes sum(squared(A*X - B)).
+         *
+         *  Returns false, leaving x unmodified, if A is not of full rank or
+         *  LAPACK reports a failure.
          */
-        void solve(const ndspan<T> b, ndspan<T> x) const;
+        bool solve(const ndspan<T> b, ndspan<T> x) const;
 
         template <typename B, typename X>
-        void solve(const B& b, X& x) const { solve(as_span(b), as_span(x)); }
+        bool solve(const B& b, X& x) const { return solve(as_span(b), as_span(x)); }
+
+        /*  Whether the factorization succeeded and R has no zero on its
+         *  diagonal, i.e. A is of full (numerical) rank.
+         */
+        bool isfullrank() const { return _isfullrank; }
+
+        /* the factorization as stored */
+        bool lapack() const { return _lapack; }
+        const xt::xtensor<T, 2>& factors() const { return _qr; }
+        const xt::xtensor<T, 1>& rdiag() const { return _rdiag; }
+        const xt::xtensor<T, 1>& tau() const { return _tau; }
 
       private:
+        /* whether the factorization was computed by LAPACK */
+        bool _lapack;
+        /* m-by-n, or the n-by-m transpose with the lapack backend */
         xt::xtensor<T, 2> _qr;
         xt::xtensor<T, 1> _rdiag;
+        /* scalar factors of the reflectors, with the lapack backend */
+        xt::xtensor<T, 1> _tau;
+        bool _isfullrank;
     };
 }
 
@@ -91,15 +142,33 @@ namespace ss{ namespace detail
 namespace ss
 {
     template <typename T>
-    qr_decomposition<T>::qr_decomposition(const ndspan<T, 2> A)
-        : _qr(A)
+    qr_decomposition<T>::qr_decomposition(
+        const ndspan<T, 2> A,
+        decomposition_backend backend)
+        : _lapack{ blas::use_lapack(backend) }
+        , _qr(_lapack ? xt::xtensor<T, 2>(xt::transpose(A)) : xt::xtensor<T, 2>(A))
         , _rdiag({ dim<1>(A) }, xt::layout_type::row_major)
+        , _isfullrank{ false }
     {
         const int64_t M = dim<0>(A);
         const int64_t N = dim<1>(A);
 
         assert(M > 0 && N > 0 && M >= N);
 
+        if (_lapack) {
+            /* the transpose of A is A in column-major order */
+            _tau = xt::xtensor<T, 1>::from_shape({ size_t(N) });
+            if (0 != blas::xgeqrf(CblasColMajor, M, N, _qr.raw_data(), M, _tau.raw_data())) {
+                return;
+            }
+
+            /* the diagonal of R, as the portable factorization keeps it */
+            for (int64_t k = 0; k < N; k++) { _rdiag(k) = _qr(k, k); }
+
+            _isfullrank = detail::nonsingular(_rdiag);
+            return;
+        }
+
         auto s    = xt::xtensor<T, 1>({ unsigned(N) }, T{0});
         auto hvec = xt::xtensor<T, 1>({ unsigned(M) }, T{0});
 
@@ -134,11 +203,30 @@ namespace ss
             _rdiag(k) = -nrm2;
         }
         detail::next_householder(_qr, N, hvec, nrm2);
+
+        _isfullrank = detail::nonsingular(_rdiag);
     }
 
     template <typename T>
     xt::xtensor<T, 2> qr_decomposition<T>::q() const
     {
+        if (_lapack) {
+            const int64_t M = dim<1>(_qr);
+            const int64_t N = dim<0>(_qr);
+
+            /* apply Q to the first n columns of the identity, where
+               qt is q in column-major order */
+            xt::xtensor<T, 2> qt = xt::eye<T>({ size_t(N), size_t(M) });
+            const blasint info = blas::xormqr(CblasColMajor, CblasLeft, CblasNoTrans, M, N, N,
+                _qr.raw_data(), M, _tau.raw_data(), qt.raw_data(), M);
+
+            /* ?ormqr fails only on an illegal argument, which these aren't */
+            assert(info == 0);
+            (void)info;
+
+            return xt::transpose(qt);
+        }
+
         auto q = xt::xtensor<T, 2>::from_shape(_qr.shape());
 
         const int64_t M = dim<0>(_qr);
@@ -175,6 +263,19 @@ namespace ss
     template <typename T>
     xt::xtensor<T, 2> qr_decomposition<T>::r() const
     {
+        if (_lapack) {
+            const auto N = dim<0>(_qr);
+            auto r = xt::xtensor<T, 2>({ N, N }, T{0});
+
+            /* the upper triangle in column-major order */
+            for (size_t m = 0; m < N; m++) {
+                for (size_t n = m; n < N; n++) {
+                    r(m, n) = _qr(n, m);
+                }
+            }
+            return r;
+        }
+
         const auto N = dim<1>(_qr);
         auto r = xt::xtensor<T, 2>({ N, N }, T{0});
 
@@ -190,15 +291,38 @@ namespace ss
     }
 
     template <typename T>
-    void qr_decomposition<T>::solve(const ndspan<T> b, ndspan<T> x) const
+    bool qr_decomposition<T>::solve(const ndspan<T> b, ndspan<T> x) const
     {
+        if (!_isfullrank) { return false; }
+
+        xt::xtensor<T, 1> s = b;
+
+        if (_lapack) {
+            const int64_t M = dim<1>(_qr);
+            const int64_t N = dim<0>(_qr);
+
+            assert(M == dim<0>(b) && N == dim<0>(x));
+
+            /* Compute Y = transpose(Q)*B, then solve R*X = Y */
+            if (0 != blas::xormqr(CblasColMajor, CblasLeft, CblasTrans, M, 1, N,
+                    _qr.raw_data(), M, _tau.raw_data(), s.raw_data(), M)) {
+                return false;
+            }
+            if (0 != blas::xtrtrs(CblasColMajor, CblasUpper, CblasNoTrans, CblasNonUnit,
+                    N, 1, _qr.raw_data(), M, s.raw_data(), M)) {
+                return false;
+            }
+
+            view(x) = xt::view(s, xt::range(0, N));
+            return true;
+        }
+
         const int64_t M = dim<0>(_qr);
         const int64_t N = dim<1>(_qr);
 
         assert(M == dim<0>(b) && N == dim<0>(x));
 
         /* Compute Y = transpose(Q)*B */
-        xt::xtensor<T, 1> s = b;
 
         for (int64_t n = 0; n < N; n++) {
             T w{0};
@@ -224,5 +348,6 @@ namespace ss
         }
         /* x becomes s[0..N] */
         view(x) = xt::view(s, xt::range(0, N));
+        return true;
     }
 }
\ No newline at end of file
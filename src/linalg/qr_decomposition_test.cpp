@@ -36,11 +36,11 @@ TEST(qr_decomposition, 2x2)
 namespace
 {
     template <typename T>
-    void test_decomposition(ss::ndspan<T, 2> A, T absolute_error)
+    void test_decomposition(ss::ndspan<T, 2> A, T absolute_error, ss::decomposition_backend backend)
     {
         using namespace ss::blas;
 
-        ss::qr_decomposition<T> QR{ A };
+        ss::qr_decomposition<T> QR{ A, backend };
 
         auto q = QR.q();
         auto r = QR.r();
@@ -67,7 +67,14 @@ namespace
     void test_random(int M, int N)
     {
         xtensor<T, 2> noise = xt::random::randn({ M, N }, 10.0f, 2.5f);
-        ::test_decomposition(ss::as_span(noise), T(1e-4f));
+        {
+            SCOPED_TRACE("portable");
+            ::test_decomposition(ss::as_span(noise), T(1e-4f), ss::decomposition_backend::portable);
+        }
+        {
+            SCOPED_TRACE("lapack");
+            ::test_decomposition(ss::as_span(noise), T(1e-4f), ss::decomposition_backend::lapack);
+        }
     }
 }
 
@@ -82,4 +89,53 @@ TEST(qr_decomposition, random_inputs)
 
     test_random<double>(50, 50);
     test_random<double>(100, 20);
-}
\ No newline at end of file
+}
+
+TEST(qr_decomposition, backends_agree)
+{
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ 20, 10 }, 10.0f, 2.5f);
+    xtensor<double, 1> b = xt::random::randn({ 20 }, 0.0f, 1.0f);
+
+    xtensor<double, 1> x_portable = xt::zeros<double>({ 10 });
+    xtensor<double, 1> x_lapack = xt::zeros<double>({ 10 });
+
+    ss::qr_decomposition<double>(ss::as_span(A), ss::decomposition_backend::portable)
+        .solve(b, x_portable);
+    ss::qr_decomposition<double>(ss::as_span(A), ss::decomposition_backend::lapack)
+        .solve(b, x_lapack);
+
+    EXPECT_TRUE(xt::allclose(x_portable, x_lapack, 0.0, 1e-8));
+
+    /* the diagonal of R is kept by either backend */
+    for (auto backend : { ss::decomposition_backend::portable, ss::decomposition_backend::lapack }) {
+        ss::qr_decomposition<double> qr(ss::as_span(A), backend);
+        xtensor<double, 2> r = qr.r();
+
+        for (size_t k = 0; k < 10; k++) { EXPECT_EQ(r(k, k), qr.rdiag()(k)); }
+    }
+}
+
+TEST(qr_decomposition, rank_deficient)
+{
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ 20, 10 }, 0.0, 1.0);
+    xt::view(A, xt::all(), 4) = 0.0;
+
+    const xtensor<double, 1> b = xt::random::randn({ 20 }, 0.0, 1.0);
+
+    for (auto backend : { ss::decomposition_backend::portable, ss::decomposition_backend::lapack }) {
+        ss::qr_decomposition<double> QR(ss::as_span(A), backend);
+        EXPECT_FALSE(QR.isfullrank());
+
+        /* the solve is refused, leaving x */
+        xtensor<double, 1> x = xt::ones<double>({ 10 });
+        EXPECT_FALSE(QR.solve(b, x));
+        EXPECT_EQ(xtensor<double, 1>(xt::ones<double>({ 10 })), x);
+    }
+
+    xt::view(A, xt::all(), 4) = 1.0;
+    EXPECT_TRUE(ss::qr_decomposition<double>(ss::as_span(A)).isfullrank());
+}
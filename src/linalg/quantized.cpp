@@ -0,0 +1,99 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "linalg/quantized.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+# define SS_QUANTIZED_AVX2 1
+# include <immintrin.h>
+#endif
+
+namespace ss {
+namespace quantized
+{
+    namespace
+    {
+        float dot_portable(size_t n, const int8_t* a, const float* x)
+        {
+            float s0{ 0 }, s1{ 0 }, s2{ 0 }, s3{ 0 };
+            size_t i = 0;
+
+            for (; i + 4 <= n; i += 4) {
+                s0 += float(a[i])     * x[i];
+                s1 += float(a[i + 1]) * x[i + 1];
+                s2 += float(a[i + 2]) * x[i + 2];
+                s3 += float(a[i + 3]) * x[i + 3];
+            }
+            for (; i < n; i++) {
+                s0 += float(a[i]) * x[i];
+            }
+            return (s0 + s1) + (s2 + s3);
+        }
+
+#if defined(SS_QUANTIZED_AVX2)
+        /* converts 8 elements to float */
+        __attribute__((target("avx2,fma")))
+        inline __m256 load8(const int8_t* a)
+        {
+            const __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a));
+            return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q));
+        }
+
+        __attribute__((target("avx2,fma")))
+        float dot_avx2(size_t n, const int8_t* a, const float* x)
+        {
+            __m256 s0 = _mm256_setzero_ps(), s1 = _mm256_setzero_ps();
+            size_t i = 0;
+
+            for (; i + 16 <= n; i += 16) {
+                s0 = _mm256_fmadd_ps(load8(a + i),     _mm256_loadu_ps(x + i),     s0);
+                s1 = _mm256_fmadd_ps(load8(a + i + 8), _mm256_loadu_ps(x + i + 8), s1);
+            }
+            for (; i + 8 <= n; i += 8) {
+                s0 = _mm256_fmadd_ps(load8(a + i), _mm256_loadu_ps(x + i), s0);
+            }
+
+            /* horizontal sum */
+            const __m256 s = _mm256_add_ps(s0, s1);
+            __m128 r = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+            r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+            r = _mm_add_ss(r, _mm_movehdup_ps(r));
+
+            float sum = _mm_cvtss_f32(r);
+            for (; i < n; i++) { sum += float(a[i]) * x[i]; }
+            return sum;
+        }
+#endif
+
+        using dot_fn = float (*)(size_t, const int8_t*, const float*);
+
+        dot_fn select()
+        {
+#if defined(SS_QUANTIZED_AVX2)
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return dot_avx2;
+            }
+#endif
+            return dot_portable;
+        }
+    }
+
+    float dot(size_t n, const int8_t* a, const float* x)
+    {
+        static const dot_fn fn = select();
+        return fn(n, a, x);
+    }
+}}
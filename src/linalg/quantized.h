@@ -0,0 +1,102 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include "linalg/common.h"
+#include "linalg/blas_profile.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <assert.h>
+
+namespace ss {
+namespace quantized
+{
+    /*  An int8 copy of a matrix with a scale per column, such that
+     *
+     *    A(i, j) = scales[j] * data[j * m + i] + e,  |e| <= scales[j] / 2
+     *
+     *  Products with it are only estimates, and are returned with a bound
+     *  on their error so that the exact products can be evaluated for the
+     *  few columns where the estimate is not conclusive.
+     */
+    struct matrix
+    {
+        std::array<size_t, 2> dims;
+        const int8_t*         data;
+        const float*          scales;
+
+        const std::array<size_t, 2>& shape() const { return dims; }
+
+        const int8_t* column(size_t j) const { return data + j * dims[0]; }
+    };
+
+    /* returns sum(a[i] * x[i]) for i in [0, n), vectorized where the cpu supports avx2 */
+    float dot(size_t n, const int8_t* a, const float* x);
+
+    /* the column-major int8 copy of A, and the scale of each column */
+    template <typename T>
+    void quantize(const ndspan<T, 2> A, std::vector<int8_t>& data, std::vector<float>& scales)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+
+        data.resize(m * n);
+        scales.resize(n);
+
+        for (size_t j = 0; j < n; j++)
+        {
+            T max{ 0 };
+            for (size_t i = 0; i < m; i++) { max = std::max(max, std::abs(A(i, j))); }
+
+            const float scale = max > T(0) ? float(max) / 127.f : 1.f;
+            scales[j] = scale;
+
+            for (size_t i = 0; i < m; i++) {
+                const float q = std::round(float(A(i, j)) / scale);
+                data[j * m + i] = int8_t(std::max(-127.f, std::min(127.f, q)));
+            }
+        }
+    }
+
+    /*  y := transpose(A) * x, with err[j] a bound on |y[j] - exact|, which
+     *  accounts for both the quantization and the float accumulation.
+     */
+    template <typename T>
+    void gemv_t(const matrix& A, const T* x, T* y, T* err)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+
+        SS_BLAS_PROFILE(T, blas::profile::op::gemv_t_int8, 2.0 * m * n, 0.25 * m * n + m + n);
+
+        std::vector<float> xf(x, x + m);
+
+        double x_l1{ 0 };
+        for (size_t i = 0; i < m; i++) { x_l1 += std::abs(double(x[i])); }
+
+        /*  |scale * q| <= 127 scale, so the rounding of x to float and of each
+         *  of the m sums is within (m + 2) eps of 127 scale |x|_1
+         */
+        const double bound = x_l1 * (1 + 1e-3)
+            * (0.5 + 127.0 * (m + 2) * std::numeric_limits<float>::epsilon());
+
+        for (size_t j = 0; j < n; j++)
+        {
+            y[j]   = T(A.scales[j] * dot(m, A.column(j), xf.data()));
+            err[j] = T(A.scales[j] * bound);
+        }
+    }
+}}
@@ -0,0 +1,55 @@
+#include <linalg/quantized.h>
+#include <linalg/blas_wrapper.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+
+#include <gtest/gtest.h>
+
+using xt::xtensor;
+
+namespace
+{
+    /* the estimates of transpose(A) * x are within their error bounds */
+    template <typename T>
+    void test_gemv_t(size_t m, size_t n)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::randn<T>({ m, n });
+        xtensor<T, 1> x = xt::random::randn<T>({ m });
+
+        /* an all-zero column, and one of a single large value */
+        xt::view(A, xt::all(), 0) = T(0);
+        xt::view(A, xt::all(), 1) = T(0);
+        A(m / 2, 1) = T(1e3);
+
+        std::vector<int8_t> data;
+        std::vector<float> scales;
+        ss::quantized::quantize(ss::as_span(A), data, scales);
+
+        const ss::quantized::matrix Q = { { m, n }, data.data(), scales.data() };
+
+        std::vector<T> y(n), err(n);
+        ss::quantized::gemv_t(Q, x.raw_data(), y.data(), err.data());
+
+        xtensor<T, 1> expect = ss::blas::xgemv<T>(CblasTrans, T(1), A, x);
+
+        for (size_t j = 0; j < n; j++) {
+            EXPECT_LE(std::abs(expect[j] - y[j]), err[j]);
+        }
+
+        /* a single value is represented exactly */
+        EXPECT_NEAR(expect[1], y[1], 1e-3);
+        EXPECT_EQ(T(0), y[0]);
+    }
+}
+
+TEST(quantized, gemv_t)
+{
+    test_gemv_t<float>(37, 5);
+    test_gemv_t<float>(1000, 20);
+    test_gemv_t<double>(16, 16);
+    test_gemv_t<double>(5, 37);
+}
@@ -0,0 +1,172 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include "linalg/common.h"
+#include "linalg/blas_wrapper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <assert.h>
+
+namespace ss
+{
+    namespace detail
+    {
+        /* orders columns of A by their class, keeping their order within a class */
+        inline void sort_by_class(std::vector<uint32_t>& cols, const ndspan<uint32_t> labels)
+        {
+            std::stable_sort(cols.begin(), cols.end(), [&](uint32_t i, uint32_t j) {
+                return labels[i] < labels[j];
+            });
+        }
+
+        template <typename T>
+        T norm_l2(const T* v, size_t n)
+        {
+            T s{ 0 };
+            for (size_t i = 0; i < n; i++) { s += v[i] * v[i]; }
+            return std::sqrt(s);
+        }
+    }
+
+    /*  residuals(i) = || y - A delta_i(x) ||_2, where delta_i(x) keeps the
+     *  elements of x whose column is labelled i. Each class is formed from
+     *  its nonzero elements of x alone, and every class without any has the
+     *  residual || y ||_2.
+     */
+    template <typename T>
+    void residuals_by_class(
+        const ndspan<T, 2>        A,
+        const ndspan<uint32_t>    labels,
+        const ndspan<T>           y,
+        const ndspan<T>           x,
+        ndspan<T>                 residuals)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+
+        assert(labels.size() == n
+            && y.size() == m
+            && x.size() == n);
+
+        const T* a = blas::detail::data(A);
+        const size_t s0 = stride<0>(A), s1 = stride<1>(A);
+
+        std::vector<uint32_t> nonzero;
+        for (uint32_t j = 0; j < n; j++) {
+            if (x[j] != T(0)) { nonzero.push_back(j); }
+        }
+        detail::sort_by_class(nonzero, labels);
+
+        aligned_vector<T> r(m);
+        std::copy(y.cbegin(), y.cend(), r.begin());
+
+        std::fill(residuals.begin(), residuals.end(), detail::norm_l2(r.data(), m));
+
+        for (size_t k = 0; k < nonzero.size();)
+        {
+            const uint32_t label = labels[nonzero[k]];
+            assert(label < residuals.size());
+
+            std::copy(y.cbegin(), y.cend(), r.begin());
+
+            for (; k < nonzero.size() && labels[nonzero[k]] == label; k++) {
+                const T* col = a + nonzero[k] * s1;
+                const T xj = x[nonzero[k]];
+
+                for (size_t i = 0; i < m; i++) { r[i] -= xj * col[i * s0]; }
+            }
+            residuals[label] = detail::norm_l2(r.data(), m);
+        }
+    }
+
+    /*  residuals_by_class of the rows of Y and X, in the rows of residuals.
+     *  Each class is a single gemm of the columns of the class which are
+     *  nonzero in any row of X, i.e.
+     *
+     *    R = Y - X(:, cols) transpose(A(:, cols))
+     *
+     *  and its residuals are the norms of the rows of R.
+     */
+    template <typename T>
+    void residuals_by_class(
+        const ndspan<T, 2>        A,
+        const ndspan<uint32_t>    labels,
+        const ndspan<T, 2>        Y,
+        const ndspan<T, 2>        X,
+        ndspan<T, 2>              residuals)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A), K = dim<0>(Y);
+
+        assert(labels.size() == n
+            && dim<1>(Y) == m
+            && dim<0>(X) == K && dim<1>(X) == n
+            && dim<0>(residuals) == K);
+
+        std::vector<uint32_t> nonzero;
+        for (uint32_t j = 0; j < n; j++) {
+            for (size_t k = 0; k < K; k++) {
+                if (X(k, j) != T(0)) { nonzero.push_back(j); break; }
+            }
+        }
+        detail::sort_by_class(nonzero, labels);
+
+        aligned_vector<T> R(K * m);
+        for (size_t k = 0; k < K; k++) {
+            for (size_t i = 0; i < m; i++) { R[k * m + i] = Y(k, i); }
+
+            const T norm = detail::norm_l2(&R[k * m], m);
+            for (size_t c = 0; c < dim<1>(residuals); c++) { residuals(k, c) = norm; }
+        }
+
+        aligned_vector<T> Xc, Ac;
+
+        for (size_t b = 0; b < nonzero.size();)
+        {
+            const uint32_t label = labels[nonzero[b]];
+            assert(label < dim<1>(residuals));
+
+            size_t e = b;
+            while (e < nonzero.size() && labels[nonzero[e]] == label) { e++; }
+
+            /* the columns of the class, of X and of transpose(A) */
+            const size_t p = e - b;
+            Xc.resize(K * p);
+            Ac.resize(p * m);
+
+            for (size_t q = 0; q < p; q++) {
+                const uint32_t j = nonzero[b + q];
+
+                for (size_t k = 0; k < K; k++) { Xc[k * p + q] = X(k, j); }
+                for (size_t i = 0; i < m; i++) { Ac[q * m + i] = A(i, j); }
+            }
+
+            for (size_t k = 0; k < K; k++) {
+                for (size_t i = 0; i < m; i++) { R[k * m + i] = Y(k, i); }
+            }
+
+            blas::xgemm<T>(CblasNoTrans, CblasNoTrans, T(-1),
+                as_span<2>(Xc, { K, p }),
+                as_span<2>(Ac, { p, m }), T(1),
+                as_span<2>(R, { K, m }));
+
+            for (size_t k = 0; k < K; k++) {
+                residuals(k, label) = detail::norm_l2(&R[k * m], m);
+            }
+            b = e;
+        }
+    }
+}
\ No newline at end of file
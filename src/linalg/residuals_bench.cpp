@@ -0,0 +1,108 @@
+#include <ss/ss.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using xt::xtensor;
+using ss::as_span;
+
+/*  Compares the residual of each class of a sparse representation, by
+ *  reconstructing the signal of each class in turn, with class_residuals.
+ *  The dictionary is of 38 classes of 64 columns, as the face recognition
+ *  problem of Yang et al., and each representation has 1 nonzero
+ *  element in 64.
+ */
+namespace
+{
+    const uint32_t classes = 38, per_class = 64;
+
+    struct problem
+    {
+        problem(uint32_t M, uint32_t K)
+            : A(xt::random::rand<float>({ M, classes * per_class }, 0.f, 1.f))
+            , Y(xt::random::rand<float>({ K, M }, 0.f, 1.f))
+            , X(xt::zeros<float>({ K, classes * per_class }))
+            , labels(classes * per_class)
+        {
+            for (uint32_t j = 0; j < labels.size(); j++) { labels[j] = j / per_class; }
+            for (uint32_t k = 0; k < K; k++) {
+                for (uint32_t j = k % 64; j < labels.size(); j += 64) { X(k, j) = 1.f; }
+            }
+        }
+
+        xtensor<float, 2> A, Y, X;
+        std::vector<uint32_t> labels;
+    };
+
+    inline void reconstruct_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const uint32_t M = state.range(0);
+
+        problem P(M, 1);
+        xtensor<float, 1> y = xt::view(P.Y, 0, xt::all());
+        xtensor<float, 1> x = xt::view(P.X, 0, xt::all());
+        xtensor<float, 1> xc = x, r = y;
+        xtensor<float, 1> residuals = xt::zeros<float>({ classes });
+
+        while (state.KeepRunning()) {
+            for (uint32_t c = 0; c < classes; c++) {
+                for (uint32_t j = 0; j < x.size(); j++) { xc[j] = P.labels[j] == c ? x[j] : 0.f; }
+                ss::reconstruct_signal(as_span(P.A), as_span(xc), as_span(r));
+
+                float s{ 0 };
+                for (uint32_t i = 0; i < M; i++) { s += (y[i] - r[i]) * (y[i] - r[i]); }
+                residuals[c] = std::sqrt(s);
+            }
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void class_residuals_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const uint32_t M = state.range(0);
+
+        problem P(M, 1);
+        xtensor<float, 1> y = xt::view(P.Y, 0, xt::all());
+        xtensor<float, 1> x = xt::view(P.X, 0, xt::all());
+        xtensor<float, 1> residuals = xt::zeros<float>({ classes });
+
+        while (state.KeepRunning()) {
+            ss::class_residuals(as_span(P.A), as_span(P.labels),
+                as_span(y), as_span(x), as_span(residuals));
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void class_residuals_batch_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const uint32_t M = state.range(0);
+        const uint32_t K = state.range(1);
+
+        problem P(M, K);
+        xtensor<float, 2> residuals = xt::zeros<float>({ K, classes });
+
+        while (state.KeepRunning()) {
+            ss::class_residuals(as_span(P.A), as_span(P.labels),
+                as_span(P.Y), as_span(P.X), as_span(residuals));
+            benchmark::ClobberMemory();
+        }
+        state.counters["Signals/s"] = benchmark::Counter(
+            double(K) * state.iterations(), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(reconstruct_bench)->RangeMultiplier(2)->Range(128, 512);
+BENCHMARK(class_residuals_bench)->RangeMultiplier(2)->Range(128, 512);
+BENCHMARK(class_residuals_batch_bench)
+    ->Args({ 128, 16 })->Args({ 128, 256 })
+    ->Args({ 512, 16 })->Args({ 512, 256 });
\ No newline at end of file
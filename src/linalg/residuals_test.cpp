@@ -0,0 +1,110 @@
+#include <ss/ss.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+#include <xtensor/xmath.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using xt::xtensor;
+using ss::as_span;
+
+namespace
+{
+    /* a residual for each class, by reconstructing each class in turn */
+    template <typename T>
+    xtensor<T, 1> expect_residuals(const xtensor<T, 2>& A,
+        const std::vector<uint32_t>& labels, uint32_t classes,
+        const xtensor<T, 1>& y, const xtensor<T, 1>& x)
+    {
+        xtensor<T, 1> expect = xt::zeros<T>({ classes });
+
+        for (uint32_t c = 0; c < classes; c++) {
+            xtensor<T, 1> xc = x;
+            for (size_t j = 0; j < labels.size(); j++) {
+                if (labels[j] != c) { xc[j] = T(0); }
+            }
+
+            xtensor<T, 1> r = xt::zeros<T>({ y.size() });
+            ss::reconstruct_signal(as_span(A), as_span(xc), as_span(r));
+
+            T s{ 0 };
+            for (size_t i = 0; i < y.size(); i++) { s += (y[i] - r[i]) * (y[i] - r[i]); }
+            expect[c] = std::sqrt(s);
+        }
+        return expect;
+    }
+
+    template <typename T>
+    void residuals_test(uint32_t M, uint32_t N, uint32_t classes)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::rand<T>({ M, N }, T(0), T(1));
+
+        /* classes interleaved, and a class no column has */
+        std::vector<uint32_t> labels(N);
+        for (uint32_t j = 0; j < N; j++) { labels[j] = j % (classes - 1); }
+
+        const uint32_t K = 5;
+        xtensor<T, 2> Y = xt::random::rand<T>({ K, M }, T(0), T(1));
+        xtensor<T, 2> X = xt::zeros<T>({ K, N });
+
+        /* a few nonzero elements in each row, and none in the last */
+        for (uint32_t k = 0; k + 1 < K; k++) {
+            for (uint32_t j = k; j < N; j += 7) { X(k, j) = T(j % 3) - T(1); }
+        }
+
+        /* column-major, and every other column of a larger matrix */
+        std::vector<T> col_major(M * N), strided(2 * M * N);
+        for (uint32_t i = 0; i < M; i++) {
+            for (uint32_t j = 0; j < N; j++) {
+                col_major[j * M + i] = A(i, j);
+                strided[i * 2 * N + 2 * j] = A(i, j);
+            }
+        }
+
+        const ss::ndspan<T, 2> views[] = {
+            as_span(A),
+            as_span<2>(col_major.data(), { M, N }, { 1, M }),
+            as_span<2>(strided.data(), { M, N }, { 2 * N, 2 })
+        };
+
+        xtensor<T, 2> expect = xt::zeros<T>({ K, classes });
+        for (uint32_t k = 0; k < K; k++) {
+            xtensor<T, 1> y = xt::view(Y, k, xt::all());
+            xtensor<T, 1> x = xt::view(X, k, xt::all());
+
+            xt::view(expect, k, xt::all()) = expect_residuals(A, labels, classes, y, x);
+        }
+
+        for (auto& view : views) {
+            for (uint32_t k = 0; k < K; k++) {
+                xtensor<T, 1> y = xt::view(Y, k, xt::all());
+                xtensor<T, 1> x = xt::view(X, k, xt::all());
+                xtensor<T, 1> residuals = xt::zeros<T>({ classes });
+
+                ss::class_residuals(view, as_span(labels), as_span(y), as_span(x), as_span(residuals));
+
+                xtensor<T, 1> e = xt::view(expect, k, xt::all());
+                EXPECT_TRUE(xt::allclose(e, residuals, 1e-4, 1e-5));
+            }
+
+            xtensor<T, 2> residuals = xt::zeros<T>({ K, classes });
+            ss::class_residuals(view, as_span(labels), as_span(Y), as_span(X), as_span(residuals));
+
+            EXPECT_TRUE(xt::allclose(expect, residuals, 1e-4, 1e-5));
+        }
+    }
+}
+
+TEST(residuals, class_residuals)
+{
+    residuals_test<float>(20, 40, 4);
+    residuals_test<double>(32, 100, 11);
+}
\ No newline at end of file
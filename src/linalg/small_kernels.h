@@ -0,0 +1,250 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include "linalg/blas_prelude.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace ss {
+namespace blas {
+namespace small
+{
+    /*  Level 1/2 kernels for operands too small to amortize the cost of a
+     *  call in to BLAS (argument checking, dispatch to the core-specific
+     *  kernel, and the threading decision). The loops are written so the
+     *  compiler can vectorize the unit-stride case; reductions use
+     *  independent partial sums for the same reason.
+     *
+     *  The blas wrappers select these automatically when every dimension
+     *  of the operation is at most `threshold`, which can be tuned with the
+     *  `small_kernels` benchmarks and set with ${ss}_SMALL_BLAS_THRESHOLD.
+     */
+#if defined(SS_SMALL_BLAS_THRESHOLD)
+    constexpr blasint threshold = SS_SMALL_BLAS_THRESHOLD;
+#else
+    constexpr blasint threshold = 32;
+#endif
+
+    inline bool eligible(blasint n) {
+        return n <= threshold;
+    }
+
+    inline bool eligible(blasint m, blasint n) {
+        return m <= threshold && n <= threshold;
+    }
+
+    /* dot ----------------------------------------------------------------- */
+
+    template <typename T>
+    T dot(blasint n,
+        const T* __restrict x, blasint incx,
+        const T* __restrict y, blasint incy)
+    {
+        if (incx == 1 && incy == 1)
+        {
+            T s0{ 0 }, s1{ 0 }, s2{ 0 }, s3{ 0 };
+            blasint i = 0;
+
+            for (; i + 4 <= n; i += 4) {
+                s0 += x[i]     * y[i];
+                s1 += x[i + 1] * y[i + 1];
+                s2 += x[i + 2] * y[i + 2];
+                s3 += x[i + 3] * y[i + 3];
+            }
+            for (; i < n; i++) {
+                s0 += x[i] * y[i];
+            }
+            return (s0 + s1) + (s2 + s3);
+        }
+
+        /* negative increments start from the end, as in BLAS */
+        if (incx < 0) { x -= (n - 1) * incx; }
+        if (incy < 0) { y -= (n - 1) * incy; }
+
+        T s{ 0 };
+        for (blasint i = 0; i < n; i++) {
+            s += x[i * incx] * y[i * incy];
+        }
+        return s;
+    }
+
+    /* scal ---------------------------------------------------------------- */
+
+    template <typename T>
+    void scal(blasint n, T alpha, T* x, blasint incx)
+    {
+        if (incx == 1) {
+            for (blasint i = 0; i < n; i++) { x[i] *= alpha; }
+        }
+        else if (incx > 0) {
+            for (blasint i = 0; i < n; i++) { x[i * incx] *= alpha; }
+        }
+    }
+
+    /* gemv ---------------------------------------------------------------- */
+
+    namespace detail
+    {
+        /* y := beta * y, without reading y when beta is zero */
+        template <typename T>
+        void scale_y(blasint n, T beta, T* y, blasint incy)
+        {
+            if (beta == T(0)) {
+                for (blasint i = 0; i < n; i++) { y[i * incy] = T(0); }
+            }
+            else if (beta != T(1)) {
+                for (blasint i = 0; i < n; i++) { y[i * incy] *= beta; }
+            }
+        }
+
+        /* y := alpha * A * x + beta * y, with A row-major m x n */
+        template <typename T>
+        void gemv_n(blasint m, blasint n, T alpha,
+            const T* __restrict a, blasint lda,
+            const T* __restrict x, blasint incx, T beta,
+            T* __restrict y, blasint incy)
+        {
+            for (blasint i = 0; i < m; i++)
+            {
+                T s = alpha * dot(n, a + i * lda, 1, x, incx);
+                T& yi = y[i * incy];
+
+                yi = (beta == T(0)) ? s : s + beta * yi;
+            }
+        }
+
+        /* y := alpha * transpose(A) * x + beta * y, with A row-major m x n */
+        template <typename T>
+        void gemv_t(blasint m, blasint n, T alpha,
+            const T* __restrict a, blasint lda,
+            const T* __restrict x, blasint incx, T beta,
+            T* __restrict y, blasint incy)
+        {
+            scale_y(n, beta, y, incy);
+
+            for (blasint i = 0; i < m; i++)
+            {
+                const T s = alpha * x[i * incx];
+                const T* __restrict row = a + i * lda;
+
+                if (incy == 1) {
+                    for (blasint j = 0; j < n; j++) { y[j] += s * row[j]; }
+                }
+                else {
+                    for (blasint j = 0; j < n; j++) { y[j * incy] += s * row[j]; }
+                }
+            }
+        }
+    }
+
+    /* Equivalent to cblas_?gemv, for positive increments. */
+    template <typename T>
+    void gemv(CBLAS_ORDER order, CBLAS_TRANSPOSE trans,
+        blasint m, blasint n, T alpha,
+        const T* a, blasint lda,
+        const T* x, blasint incx, T beta,
+        T* y, blasint incy)
+    {
+        /* a col-major matrix is its row-major transpose */
+        const bool transposed = (trans != CblasNoTrans) != (order == CblasColMajor);
+
+        if (order == CblasColMajor) { std::swap(m, n); }
+
+        if (transposed) {
+            detail::gemv_t(m, n, alpha, a, lda, x, incx, beta, y, incy);
+        }
+        else {
+            detail::gemv_n(m, n, alpha, a, lda, x, incx, beta, y, incy);
+        }
+    }
+
+    /*  y := alpha * op(A) * x + beta * y, where A(i, j) is a[i * s0 + j * s1]
+     *  for arbitrary strides. Used for views BLAS can't describe, so it is
+     *  not limited by the size threshold.
+     */
+    template <typename T>
+    void gemv_strided(CBLAS_TRANSPOSE trans,
+        size_t m, size_t n, T alpha,
+        const T* a, size_t s0, size_t s1,
+        const T* x, size_t incx, T beta,
+        T* y, size_t incy)
+    {
+        if (trans == CblasNoTrans) {
+            for (size_t i = 0; i < m; i++)
+            {
+                T s{ 0 };
+                for (size_t j = 0; j < n; j++) { s += a[i * s0 + j * s1] * x[j * incx]; }
+
+                T& yi = y[i * incy];
+                yi = (beta == T(0)) ? alpha * s : alpha * s + beta * yi;
+            }
+        }
+        else {
+            detail::scale_y(blasint(n), beta, y, blasint(incy));
+
+            for (size_t i = 0; i < m; i++)
+            {
+                const T s = alpha * x[i * incx];
+                for (size_t j = 0; j < n; j++) { y[j * incy] += s * a[i * s0 + j * s1]; }
+            }
+        }
+    }
+
+    /* ger ----------------------------------------------------------------- */
+
+    /* Equivalent to cblas_?ger, for positive increments. */
+    template <typename T>
+    void ger(CBLAS_ORDER order, blasint m, blasint n, T alpha,
+        const T* x, blasint incx,
+        const T* y, blasint incy,
+        T* a, blasint lda)
+    {
+        /* a col-major update is the row-major update of the transpose */
+        if (order == CblasColMajor) {
+            std::swap(m, n);
+            std::swap(x, y);
+            std::swap(incx, incy);
+        }
+
+        for (blasint i = 0; i < m; i++)
+        {
+            const T s = alpha * x[i * incx];
+            T* __restrict row = a + i * lda;
+
+            if (incy == 1) {
+                for (blasint j = 0; j < n; j++) { row[j] += s * y[j]; }
+            }
+            else {
+                for (blasint j = 0; j < n; j++) { row[j] += s * y[j * incy]; }
+            }
+        }
+    }
+
+    /* A := alpha * x * transpose(y) + A, where A(i, j) is a[i * s0 + j * s1] */
+    template <typename T>
+    void ger_strided(size_t m, size_t n, T alpha,
+        const T* x, size_t incx,
+        const T* y, size_t incy,
+        T* a, size_t s0, size_t s1)
+    {
+        for (size_t i = 0; i < m; i++)
+        {
+            const T s = alpha * x[i * incx];
+            for (size_t j = 0; j < n; j++) { a[i * s0 + j * s1] += s * y[j * incy]; }
+        }
+    }
+}}}
@@ -0,0 +1,111 @@
+#include <linalg/blas_wrapper.h>
+#include <linalg/small_kernels.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+
+#include <benchmark/benchmark.h>
+
+using xt::xtensor;
+
+/*  Compares the built-in kernels against BLAS for square operands of
+ *  increasing size. The cross-over point is a good choice for
+ *  ${ss}_SMALL_BLAS_THRESHOLD on the benchmarked machine.
+ */
+namespace
+{
+    inline void small_gemv_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const blasint N = state.range(0);
+
+        xtensor<float, 2> A = xt::random::randn({ N, N }, .5f, .1f);
+        xtensor<float, 1> x = xt::random::randn({ N }, .5f, .1f);
+        xtensor<float, 1> y = xt::zeros<float>({ N });
+
+        while (state.KeepRunning()) {
+            ss::blas::small::gemv(CblasRowMajor, CblasNoTrans, N, N, 1.f,
+                A.raw_data(), N, x.raw_data(), 1, 0.f, y.raw_data(), 1);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void blas_gemv_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const blasint N = state.range(0);
+
+        xtensor<float, 2> A = xt::random::randn({ N, N }, .5f, .1f);
+        xtensor<float, 1> x = xt::random::randn({ N }, .5f, .1f);
+        xtensor<float, 1> y = xt::zeros<float>({ N });
+
+        while (state.KeepRunning()) {
+            ss::blas::table().sgemv(CblasRowMajor, CblasNoTrans, N, N, 1.f,
+                A.raw_data(), N, x.raw_data(), 1, 0.f, y.raw_data(), 1);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void small_ger_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const blasint N = state.range(0);
+
+        xtensor<float, 2> A = xt::random::randn({ N, N }, .5f, .1f);
+        xtensor<float, 1> x = xt::random::randn({ N }, .5f, .1f);
+
+        while (state.KeepRunning()) {
+            ss::blas::small::ger(CblasRowMajor, N, N, 1e-6f,
+                x.raw_data(), 1, x.raw_data(), 1, A.raw_data(), N);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void blas_ger_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const blasint N = state.range(0);
+
+        xtensor<float, 2> A = xt::random::randn({ N, N }, .5f, .1f);
+        xtensor<float, 1> x = xt::random::randn({ N }, .5f, .1f);
+
+        while (state.KeepRunning()) {
+            ss::blas::table().sger(CblasRowMajor, N, N, 1e-6f,
+                x.raw_data(), 1, x.raw_data(), 1, A.raw_data(), N);
+            benchmark::ClobberMemory();
+        }
+    }
+
+    inline void small_dot_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const blasint N = state.range(0);
+
+        xtensor<float, 1> x = xt::random::randn({ N }, .5f, .1f);
+
+        while (state.KeepRunning()) {
+            benchmark::DoNotOptimize(
+                ss::blas::small::dot(N, x.raw_data(), 1, x.raw_data(), 1));
+        }
+    }
+
+    inline void blas_dot_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+        const blasint N = state.range(0);
+
+        xtensor<float, 1> x = xt::random::randn({ N }, .5f, .1f);
+
+        while (state.KeepRunning()) {
+            benchmark::DoNotOptimize(
+                ss::blas::table().sdot(N, x.raw_data(), 1, x.raw_data(), 1));
+        }
+    }
+}
+
+BENCHMARK(small_gemv_bench)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK(blas_gemv_bench)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK(small_ger_bench)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK(blas_ger_bench)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK(small_dot_bench)->RangeMultiplier(2)->Range(4, 256);
+BENCHMARK(blas_dot_bench)->RangeMultiplier(2)->Range(4, 256);
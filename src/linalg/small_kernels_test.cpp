@@ -0,0 +1,122 @@
+#include <linalg/blas_wrapper.h>
+#include <linalg/small_kernels.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+
+#include <gtest/gtest.h>
+
+using xt::xtensor;
+
+namespace
+{
+    void reference_gemv(CBLAS_ORDER order, CBLAS_TRANSPOSE trans,
+        blasint m, blasint n, float alpha, const float* a, blasint lda,
+        const float* x, blasint incx, float beta, float* y, blasint incy)
+    {
+        ss::blas::table().sgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+    }
+
+    void reference_gemv(CBLAS_ORDER order, CBLAS_TRANSPOSE trans,
+        blasint m, blasint n, double alpha, const double* a, blasint lda,
+        const double* x, blasint incx, double beta, double* y, blasint incy)
+    {
+        ss::blas::table().dgemv(order, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+    }
+
+    /* the small kernels agree with BLAS for both layouts and transposes */
+    template <typename T>
+    void test_gemv(blasint m, blasint n, CBLAS_ORDER order, CBLAS_TRANSPOSE trans)
+    {
+        xt::random::seed(0);
+
+        const blasint lda = order == CblasRowMajor ? n + 3 : m + 3;
+        const blasint rows = order == CblasRowMajor ? m : n;
+        const blasint xn = trans == CblasNoTrans ? n : m;
+        const blasint yn = trans == CblasNoTrans ? m : n;
+
+        xtensor<T, 1> a = xt::random::randn<T>({ size_t(rows * lda) });
+        xtensor<T, 1> x = xt::random::randn<T>({ size_t(xn * 2) });
+        xtensor<T, 1> y = xt::random::randn<T>({ size_t(yn) });
+        xtensor<T, 1> expect = y;
+
+        ss::blas::small::gemv<T>(order, trans, m, n, T(.5),
+            a.raw_data(), lda, x.raw_data(), 2, T(2), y.raw_data(), 1);
+
+        reference_gemv(order, trans, m, n, T(.5),
+            a.raw_data(), lda, x.raw_data(), 2, T(2), expect.raw_data(), 1);
+
+        for (blasint i = 0; i < yn; i++) {
+            EXPECT_NEAR(expect[i], y[i], 1e-4);
+        }
+    }
+
+    template <typename T>
+    void test_ger(blasint m, blasint n, CBLAS_ORDER order)
+    {
+        xt::random::seed(0);
+
+        const blasint lda = order == CblasRowMajor ? n : m;
+        xtensor<T, 1> a = xt::random::randn<T>({ size_t(m * n) });
+        xtensor<T, 1> x = xt::random::randn<T>({ size_t(m) });
+        xtensor<T, 1> y = xt::random::randn<T>({ size_t(n * 3) });
+        xtensor<T, 1> expect = a;
+
+        ss::blas::small::ger<T>(order, m, n, T(-1.5),
+            x.raw_data(), 1, y.raw_data(), 3, a.raw_data(), lda);
+
+        /* reference, in the row-major layout */
+        for (blasint i = 0; i < m; i++) {
+            for (blasint j = 0; j < n; j++) {
+                size_t k = order == CblasRowMajor ? i * lda + j : j * lda + i;
+                expect[k] += T(-1.5) * x[i] * y[j * 3];
+            }
+        }
+
+        for (size_t i = 0; i < a.size(); i++) {
+            EXPECT_NEAR(expect[i], a[i], 1e-4);
+        }
+    }
+}
+
+TEST(small_kernels, gemv)
+{
+    for (auto order : { CblasRowMajor, CblasColMajor }) {
+        for (auto trans : { CblasNoTrans, CblasTrans }) {
+            test_gemv<float>(7, 5, order, trans);
+            test_gemv<double>(5, 13, order, trans);
+            test_gemv<double>(1, 1, order, trans);
+        }
+    }
+}
+
+TEST(small_kernels, ger)
+{
+    for (auto order : { CblasRowMajor, CblasColMajor }) {
+        test_ger<float>(6, 9, order);
+        test_ger<double>(11, 3, order);
+    }
+}
+
+TEST(small_kernels, dot_scal)
+{
+    xt::random::seed(0);
+    xtensor<double, 1> x = xt::random::randn<double>({ 23 });
+    xtensor<double, 1> y = xt::random::randn<double>({ 23 });
+
+    EXPECT_NEAR(
+        ss::blas::table().ddot(23, x.raw_data(), 1, y.raw_data(), 1),
+        ss::blas::small::dot<double>(23, x.raw_data(), 1, y.raw_data(), 1), 1e-12);
+
+    /* strided, with a negative increment */
+    EXPECT_NEAR(
+        ss::blas::table().ddot(7, x.raw_data(), 3, y.raw_data(), -2),
+        ss::blas::small::dot<double>(7, x.raw_data(), 3, y.raw_data(), -2), 1e-12);
+
+    xtensor<double, 1> expect = x;
+    ss::blas::small::scal<double>(12, 3.0, x.raw_data(), 2);
+
+    for (size_t i = 0; i < x.size(); i++) {
+        EXPECT_EQ(i % 2 == 0 ? expect[i] * 3 : expect[i], x[i]);
+    }
+}
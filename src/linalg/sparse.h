@@ -0,0 +1,102 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+#pragma once
+
+#include "ss/sparse.h"
+#include "linalg/common.h"
+#include "linalg/blas_prelude.h"
+#include "linalg/blas_profile.h"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace ss {
+namespace sparse
+{
+    /*  y := alpha * op(A) * x + beta * y, for a CSC matrix A and strided x
+     *  and y. A * x scatters the columns of A for each nonzero of x, which
+     *  suits the homotopy solver, where x is itself sparse; when x is
+     *  dense (a quarter or more of it nonzero) and A has a CSR mirror,
+     *  the rows of the mirror are read instead.
+     */
+    template <typename T>
+    void gemv(CBLAS_TRANSPOSE trans, T alpha,
+        const csc_span<T>& A, const ndspan<T> x, T beta, ndspan<T> y)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+
+        SS_BLAS_PROFILE(T, trans == CblasNoTrans ?
+            blas::profile::op::gemv_n_csc : blas::profile::op::gemv_t_csc,
+            2.0 * A.nnz(), 2.0 * A.nnz() + m + n);
+
+        if (trans != CblasNoTrans)
+        {
+            assert(x.size() == m && y.size() == n);
+
+            for (size_t j = 0; j < n; j++)
+            {
+                T s{ 0 };
+                for (int32_t k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++) {
+                    s += A.values[k] * x[A.row_indices[k]];
+                }
+                y[j] = (beta == T(0)) ? alpha * s : alpha * s + beta * y[j];
+            }
+            return;
+        }
+
+        assert(x.size() == n && y.size() == m);
+
+        size_t nonzeros = 0;
+        for (size_t j = 0; j < n; j++) { nonzeros += x[j] != T(0); }
+
+        if (A.has_csr() && 4 * nonzeros >= n)
+        {
+            for (size_t i = 0; i < m; i++)
+            {
+                T s{ 0 };
+                for (int32_t k = A.row_ptr[i]; k < A.row_ptr[i + 1]; k++) {
+                    s += A.row_values[k] * x[A.col_indices[k]];
+                }
+                y[i] = (beta == T(0)) ? alpha * s : alpha * s + beta * y[i];
+            }
+            return;
+        }
+
+        if (beta == T(0))   { view(y) = T(0); }
+        else if (beta != 1) { view(y) *= beta; }
+
+        for (size_t j = 0; j < n; j++)
+        {
+            const T xj = alpha * x[j];
+            if (xj == T(0)) { continue; }
+
+            for (int32_t k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++) {
+                y[A.row_indices[k]] += xj * A.values[k];
+            }
+        }
+    }
+
+    /*  writes column j of A to the dense vector `out` of length m; the
+     *  values of duplicate entries are summed, as in every product
+     */
+    template <typename T>
+    void column(const csc_span<T>& A, size_t j, T* out)
+    {
+        std::fill(out, out + dim<0>(A), T(0));
+
+        for (int32_t k = A.col_ptr[j]; k < A.col_ptr[j + 1]; k++) {
+            out[A.row_indices[k]] += A.values[k];
+        }
+    }
+}}
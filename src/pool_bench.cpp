@@ -0,0 +1,211 @@
+#include <ss/ss.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using xt::xtensor;
+using ss::as_span;
+
+namespace
+{
+    /*  A batch of signals whose homotopy iteration counts are skewed: most
+     *  are a column of the matrix, as the smoke tests, and are solved in a
+     *  couple of iterations; every 16th is a noisy pattern, as the noisy
+     *  pattern tests, and takes hundreds. The slow signals are clustered
+     *  at the front, as they would be from a single noisy source.
+     */
+    template <typename T>
+    xtensor<T, 2> skewed_batch(const xtensor<T, 2>& A, uint32_t K)
+    {
+        const uint32_t M = A.shape()[0], N = A.shape()[1];
+        xtensor<T, 2> Y = xt::zeros<T>({ K, M });
+
+        for (uint32_t k = 0; k < K; k++) {
+            if (k < K / 16) {
+                xt::view(Y, k, xt::all()) = xt::random::randn({ M }, T(.5), T(.1));
+                xt::view(Y, k, xt::range(0, int(M), 2)) += T(1);
+            }
+            else {
+                xt::view(Y, k, xt::all()) = xt::view(A, xt::all(), k % N);
+            }
+        }
+        return Y;
+    }
+
+    /*  Threads which each solve a fixed share of the rows of a batch, once
+     *  per round; created once, so a round times only the solves
+     */
+    class static_split
+    {
+      public:
+        static_split(std::shared_ptr<const ss::homotopy_state<float>> state, unsigned threads)
+        {
+            for (unsigned t = 0; t < threads; t++) {
+                _workers.emplace_back([this, state, t, threads] { work(state, t, threads); });
+            }
+        }
+
+        ~static_split()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _start.notify_all();
+            for (auto& w : _workers) { w.join(); }
+        }
+
+        void solve_batch(const ss::ndspan<float, 2> Y, float tol, uint32_t max_iterations,
+            ss::ndspan<float, 2> X)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _Y = &Y; _X = &X;
+            _tol = tol; _max_iterations = max_iterations;
+            _remaining = _workers.size();
+            _round++;
+            _start.notify_all();
+            _done.wait(lock, [this] { return _remaining == 0; });
+        }
+
+      private:
+        void work(std::shared_ptr<const ss::homotopy_state<float>> state, unsigned t, unsigned threads)
+        {
+            ss::blas_thread_scope scope(1);
+            ss::homotopy<float> local(state);
+
+            uint64_t seen = 0;
+            for (;;)
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _start.wait(lock, [&] { return _round != seen || _stop; });
+                if (_stop) { return; }
+                seen = _round;
+                lock.unlock();
+
+                const size_t K = _Y->shape()[0], M = _Y->shape()[1], N = _X->shape()[1];
+                for (size_t k = K * t / threads; k < K * (t + 1) / threads; k++) {
+                    local.solve(as_span(&(*_Y)(k, 0), M), _tol, _max_iterations,
+                        as_span(&(*_X)(k, 0), N));
+                }
+
+                lock.lock();
+                if (--_remaining == 0) { _done.notify_one(); }
+            }
+        }
+
+        std::vector<std::thread> _workers;
+
+        std::mutex _mutex;
+        std::condition_variable _start, _done;
+        uint64_t _round = 0;
+        size_t _remaining = 0;
+        bool _stop = false;
+
+        const ss::ndspan<float, 2>* _Y = nullptr;
+        ss::ndspan<float, 2>* _X = nullptr;
+        float _tol = 0;
+        uint32_t _max_iterations = 0;
+    };
+
+    /*  Solves a skewed batch with each of range(2) threads solving a fixed
+     *  share of the signals (0), or with a pool's work stealing batch (1).
+     *  Both keep their threads across rounds, and solve spans of Y and X.
+     */
+    inline void batch_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+
+        const uint32_t M = state.range(0);
+        const uint32_t N = state.range(1);
+        const uint32_t K = 512;
+        const bool stealing = state.range(2) != 0;
+        const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+
+        xtensor<float, 2> A = xt::random::randn({ M, N }, .5f, .1f);
+        ss::norm_l1(as_span(A));
+
+        xtensor<float, 2> Y = skewed_batch(A, K);
+        xtensor<float, 2> X = xt::zeros<float>({ K, N });
+
+        ss::homotopy<float> solver(as_span(A));
+
+        if (stealing)
+        {
+            ss::pool_options options;
+            options.workers = threads;
+            ss::homotopy_pool<float> pool(solver.state(), options);
+
+            while (state.KeepRunning()) {
+                pool.solve_batch(as_span(Y), .001f, N, as_span(X));
+            }
+        }
+        else
+        {
+            static_split split(solver.state(), threads);
+
+            while (state.KeepRunning()) {
+                split.solve_batch(as_span(Y), .001f, N, as_span(X));
+            }
+        }
+
+        state.counters["Signals/s"] = benchmark::Counter(
+            double(K) * state.iterations(), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(batch_bench)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Args({ 64, 512, 0 })->Args({ 64, 512, 1 })
+    ->Args({ 128, 2048, 0 })->Args({ 128, 2048, 1 });
+
+namespace
+{
+    /*  Solves a batch against a dictionary large enough to be bound by
+     *  memory bandwidth, on every hardware thread, with one copy of the
+     *  dictionary (0), or a copy on each NUMA node (1). The two are the
+     *  same on a single node.
+     */
+    inline void numa_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+
+        const uint32_t M = state.range(0);
+        const uint32_t N = state.range(1);
+        const uint32_t K = 256;
+
+        xtensor<float, 2> A = xt::random::randn({ M, N }, .5f, .1f);
+        ss::norm_l1(as_span(A));
+
+        xtensor<float, 2> Y = skewed_batch(A, K);
+        xtensor<float, 2> X = xt::zeros<float>({ K, N });
+
+        ss::pool_options options;
+        options.numa_replicas = state.range(2) != 0;
+        ss::homotopy_pool<float> pool(as_span(A), options);
+
+        while (state.KeepRunning()) {
+            pool.solve_batch(as_span(Y), .001f, 50, as_span(X));
+        }
+
+        state.counters["Nodes"] = double(std::max<size_t>(1, ss::detail::numa_nodes().size()));
+        state.counters["Signals/s"] = benchmark::Counter(
+            double(K) * state.iterations(), benchmark::Counter::kIsRate);
+    }
+}
+
+BENCHMARK(numa_bench)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Args({ 256, 16384, 0 })->Args({ 256, 16384, 1 })
+    ->Args({ 512, 32768, 0 })->Args({ 512, 32768, 1 });
@@ -0,0 +1,356 @@
+#include <ss/ss.h>
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xio.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using xt::xtensor;
+using ss::as_span;
+
+TEST(mpmc_queue, concurrent)
+{
+    const int producers = 4, count = 10000;
+    ss::detail::mpmc_queue<int> queue(16);
+
+    std::atomic<long> sum{ 0 };
+    std::atomic<int> popped{ 0 };
+    std::vector<std::thread> threads;
+
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&] {
+            for (int i = 1; i <= count; i++) {
+                int v = i;
+                while (!queue.try_push(std::move(v))) { std::this_thread::yield(); }
+            }
+        });
+        threads.emplace_back([&] {
+            int v;
+            while (popped.load() < producers * count) {
+                if (queue.try_pop(v)) { sum += v; popped++; }
+            }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+
+    EXPECT_EQ(long(producers) * count * (count + 1) / 2, sum.load());
+
+    int v;
+    EXPECT_FALSE(queue.try_pop(v));
+}
+
+namespace
+{
+    /* the pool solves every signal as a single solver */
+    template <template <typename> class Pool, template <typename> class Solver, typename T>
+    void pool_test(uint32_t M, uint32_t N)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::randn({ M, N }, T(0), T(.01));
+        for (uint32_t n = 0; n < std::min(M, N); n++) { A(n, n) += T(1); }
+
+        std::vector<xtensor<T, 1>> signals, expect, x;
+        Solver<T> solver(as_span(A));
+
+        for (uint32_t n = 0; n < 4 * N; n++) {
+            signals.push_back(xt::view(A, xt::all(), n % N));
+            expect.push_back(xt::zeros<T>({ N }));
+            x.push_back(xt::zeros<T>({ N }));
+
+            solver.solve(as_span(signals[n]), T(.001), N, as_span(expect[n]));
+        }
+
+        ss::pool_options options;
+        options.workers = 3;
+        options.queue_capacity = 4;
+
+        std::atomic<uint32_t> callbacks{ 0 };
+        {
+            Pool<T> pool(as_span(A), options);
+            EXPECT_EQ(3, pool.workers());
+
+            std::vector<std::future<typename Pool<T>::solve_result>> results;
+
+            for (uint32_t n = 0; n < signals.size(); n++) {
+                if (n % 2) {
+                    pool.submit(as_span(signals[n]), T(.001), N, as_span(x[n]),
+                        [&](typename Pool<T>::solve_result) { callbacks++; });
+                }
+                else {
+                    results.push_back(
+                        pool.submit(as_span(signals[n]), T(.001), N, as_span(x[n])));
+                }
+            }
+            for (auto& r : results) {
+                EXPECT_TRUE(r.get().template is<typename Pool<T>::report_type>());
+            }
+        }
+
+        /* every solve completed before the pool was destroyed */
+        EXPECT_EQ(signals.size() / 2, callbacks.load());
+
+        for (uint32_t n = 0; n < signals.size(); n++) {
+            EXPECT_TRUE(xt::allclose(expect[n], x[n]));
+        }
+    }
+}
+
+TEST(solver_pool, homotopy)
+{
+    pool_test<ss::homotopy_pool, ss::homotopy, float>(20, 30);
+    pool_test<ss::homotopy_pool, ss::homotopy, double>(32, 64);
+}
+
+TEST(solver_pool, irls)
+{
+    pool_test<ss::irls_pool, ss::irls, float>(10, 5);
+    pool_test<ss::irls_pool, ss::irls, double>(12, 6);
+}
+
+TEST(work_ranges, concurrent)
+{
+    const uint32_t n = 100000;
+    const size_t owners = 4;
+    ss::detail::work_ranges ranges(n, owners);
+
+    std::vector<std::atomic<int>> taken(n);
+    std::vector<std::thread> threads;
+
+    for (size_t owner = 0; owner < owners; owner++) {
+        threads.emplace_back([&, owner] {
+            uint32_t index;
+            /* the first owner takes nothing itself until it steals */
+            if (owner == 0) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+            while (ranges.next(owner, index)) { taken[index]++; }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+
+    /* every index is taken exactly once */
+    EXPECT_TRUE(std::all_of(taken.begin(), taken.end(), [](const std::atomic<int>& t) {
+        return t.load() == 1;
+    }));
+}
+
+namespace
+{
+    /*  the batch of a pool solves each row as a single solver, where some
+     *  rows take many more iterations than the rest
+     */
+    template <typename T>
+    void batch_test(uint32_t M, uint32_t N, uint32_t K)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::rand<T>({ M, N }, T(0), T(1));
+        xtensor<T, 2> Y = xt::zeros<T>({ K, M });
+
+        for (uint32_t k = 0; k < K; k++) {
+            if (k % 7 == 0) {
+                xt::view(Y, k, xt::all()) = xt::random::rand<T>({ M }, T(0), T(1));
+            }
+            else {
+                xt::view(Y, k, xt::all()) = xt::view(A, xt::all(), k % N);
+            }
+        }
+
+        ss::homotopy<T> solver(as_span(A));
+        xtensor<T, 2> expect = xt::zeros<T>({ K, N });
+        for (uint32_t k = 0; k < K; k++) {
+            xtensor<T, 1> y = xt::view(Y, k, xt::all());
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+
+            solver.solve(as_span(y), T(.001), 100, as_span(x));
+            xt::view(expect, k, xt::all()) = x;
+        }
+
+        ss::pool_options options;
+        options.workers = 3;
+
+        ss::homotopy_pool<T> pool(solver.state(), options);
+        xtensor<T, 2> X = xt::ones<T>({ K, N });
+
+        auto results = pool.solve_batch(as_span(Y), T(.001), 100, as_span(X));
+
+        ASSERT_EQ(K, results.size());
+        for (auto& r : results) {
+            EXPECT_TRUE(r.template is<ss::homotopy_report>());
+        }
+        EXPECT_TRUE(xt::allclose(expect, X));
+    }
+}
+
+TEST(solver_pool, solve_batch)
+{
+    batch_test<float>(20, 40, 50);
+    batch_test<double>(32, 64, 2);
+}
+
+TEST(numa, nodes)
+{
+    /* none where the topology is unknown */
+    auto nodes = ss::detail::numa_nodes();
+
+    for (size_t k = 0; k < nodes.size(); k++) {
+        EXPECT_FALSE(nodes[k].cpus.empty());
+        if (k > 0) { EXPECT_LT(nodes[k - 1].id, nodes[k].id); }
+    }
+
+    const int node = nodes.empty() ? 0 : nodes[0].id;
+    auto* p = static_cast<double*>(ss::detail::numa_allocate(1 << 20, node));
+
+    ASSERT_NE(nullptr, p);
+    std::fill(p, p + (1 << 17), 1.);
+    ss::detail::numa_deallocate(p, 1 << 20);
+}
+
+TEST(solver_pool, numa_replicas)
+{
+    const uint32_t M = 12, N = 6;
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ M, N }, 0., .01);
+    for (uint32_t n = 0; n < N; n++) { A(n, n) += 1.; }
+
+    xtensor<double, 2> Y = xt::zeros<double>({ N, M });
+    xtensor<double, 2> expect = xt::zeros<double>({ N, N });
+    xtensor<double, 2> X = xt::zeros<double>({ N, N });
+
+    ss::irls<double> solver(as_span(A));
+    for (uint32_t n = 0; n < N; n++) {
+        xt::view(Y, n, xt::all()) = xt::view(A, xt::all(), n);
+
+        xtensor<double, 1> y = xt::view(Y, n, xt::all());
+        xtensor<double, 1> x = xt::zeros<double>({ N });
+
+        solver.solve(as_span(y), .001, N, as_span(x));
+        xt::view(expect, n, xt::all()) = x;
+    }
+
+    /* the same solutions from the copy on each node, whatever the topology */
+    ss::pool_options options;
+    options.workers = 4;
+    options.numa_replicas = true;
+
+    ss::irls_pool<double> pool(as_span(A), options);
+    pool.solve_batch(as_span(Y), .001, N, as_span(X));
+
+    EXPECT_TRUE(xt::allclose(expect, X));
+}
+
+TEST(numa, replicate)
+{
+    const uint32_t M = 12, N = 6;
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ M, N }, 0., .01);
+    for (uint32_t n = 0; n < N; n++) { A(n, n) += 1.; }
+
+    /* two nodes, both of the memory and a cpu of the first real one */
+    const auto real = ss::detail::numa_nodes();
+    const int id  = real.empty() ? 0 : real[0].id;
+    const int cpu = real.empty() ? 0 : real[0].cpus[0];
+
+    const std::vector<ss::detail::numa_node> nodes = { { id, { cpu } }, { id, { cpu } } };
+
+    auto make = [](const ss::ndspan<double, 2> local) {
+        return std::make_shared<ss::irls_state>(local);
+    };
+    auto replicas = ss::detail::replicate<ss::irls_state>(as_span(A), nodes, make);
+    ASSERT_EQ(2u, replicas.size());
+
+    xtensor<double, 1> y = xt::view(A, xt::all(), 2);
+    xtensor<double, 1> expect = xt::zeros<double>({ N });
+    ss::irls<double>(as_span(A)).solve(as_span(y), .001, N, as_span(expect));
+
+    /* each holds its own copy of A, and solves as A */
+    for (auto& r : replicas) {
+        EXPECT_EQ(nodes[0].cpus, r.cpus);
+        ASSERT_TRUE(bool(r.state));
+
+        const double* copy = static_cast<const double*>(r.matrix.get());
+        EXPECT_NE(A.raw_data(), copy);
+        EXPECT_EQ(A, as_span<2>(copy, { M, N }));
+
+        xtensor<double, 1> x = xt::zeros<double>({ N });
+        ss::irls<double>(r.state).solve(as_span(y), .001, N, as_span(x));
+        EXPECT_TRUE(xt::allclose(expect, x));
+    }
+    EXPECT_NE(replicas[0].matrix, replicas[1].matrix);
+
+    /* and none on a single node */
+    EXPECT_TRUE(ss::detail::replicate<ss::irls_state>(as_span(A), { nodes[0] }, make).empty());
+}
+
+TEST(solver_pool, affinity)
+{
+    xtensor<float, 2> A = xt::eye<float>(5);
+    xtensor<float, 1> y = xt::view(A, xt::all(), 2);
+    xtensor<float, 1> x = xt::zeros<float>({ 5 });
+
+    ss::pool_options options;
+    options.workers = 2;
+    options.cpus = { 0 };
+
+    ss::homotopy_pool<float> pool(as_span(A), options);
+    pool.submit(as_span(y), .001f, 5, as_span(x)).get();
+
+    EXPECT_EQ(y, x);
+}
+
+TEST(solver, shared_state)
+{
+    const uint32_t M = 12, N = 6;
+    xt::random::seed(0);
+
+    xtensor<double, 2> A = xt::random::randn({ M, N }, 0., .01);
+    for (uint32_t n = 0; n < N; n++) { A(n, n) += 1.; }
+
+    ss::irls<double> solver(as_span(A));
+    auto state = solver.state();
+
+    std::vector<xtensor<double, 1>> signals, expect, x;
+    for (uint32_t n = 0; n < N; n++) {
+        signals.push_back(xt::view(A, xt::all(), n));
+        expect.push_back(xt::zeros<double>({ N }));
+        x.push_back(xt::zeros<double>({ N }));
+
+        solver.solve(as_span(signals[n]), .001, N, as_span(expect[n]));
+    }
+
+    /* a solver per thread, sharing the factorization of the first */
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 2; t++) {
+        threads.emplace_back([&, t] {
+            ss::irls<double> local(state);
+            for (uint32_t n = t; n < N; n += 2) {
+                local.solve(as_span(signals[n]), .001, N, as_span(x[n]));
+            }
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+
+    for (uint32_t n = 0; n < N; n++) {
+        EXPECT_TRUE(xt::allclose(expect[n], x[n]));
+    }
+
+    /* and a pool */
+    ss::irls_pool<double> pool(state);
+    xtensor<double, 1> y = xt::zeros<double>({ N });
+    pool.submit(as_span(signals[1]), .001, N, as_span(y)).get();
+
+    EXPECT_TRUE(xt::allclose(expect[1], y));
+    EXPECT_EQ(state.get(), solver.state().get());
+}
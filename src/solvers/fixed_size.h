@@ -0,0 +1,62 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#pragma once
+
+#include <cstddef>
+
+namespace ss {
+namespace fixed
+{
+    /*  Solvers specialized on the signal length M as a compile-time
+     *  constant, for problems so small that the dynamic shapes, the
+     *  expression templates and the calls in to BLAS cost more than the
+     *  arithmetic. Their workspaces live on the stack, and every loop over
+     *  the signal has a constant trip count, so it is unrolled and
+     *  vectorized by the compiler.
+     *
+     *  The homotopy and IRLS policies select them automatically when the
+     *  sensing matrix has one of the signal lengths below, and no more than
+     *  max_columns columns.
+     */
+#define SS_FIXED_SIGNAL_LENGTHS(X) X(16) X(24) X(32) X(48) X(64)
+
+    /* the most columns of a sensing matrix solved with stack workspaces */
+    constexpr size_t max_columns = 512;
+
+    /* whether solvers are compiled for signals of length m */
+    inline bool compiled(size_t m)
+    {
+        switch (m) {
+#define SS_FIXED_CASE(M) case M:
+            SS_FIXED_SIGNAL_LENGTHS(SS_FIXED_CASE)
+#undef SS_FIXED_CASE
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /* whether the homotopy solver of an m-by-n sensing matrix is specialized */
+    inline bool homotopy_eligible(size_t m, size_t n) {
+        return compiled(m) && n <= max_columns;
+    }
+
+    /*  whether the IRLS solver of an m-by-n sensing matrix is specialized,
+     *  which requires an overdetermined system, as the solver itself
+     */
+    inline bool irls_eligible(size_t m, size_t n) {
+        return compiled(m) && n >= 2 && n <= m;
+    }
+}}
@@ -0,0 +1,162 @@
+#include <ss/ss.h>
+#include <kernelpp/kernel_invoke.h>
+
+#include "solvers/homotopy.h"
+#include "solvers/irls.h"
+#include "solvers/fixed_size.h"
+
+#include <xtensor/xtensor.hpp>
+#include <xtensor/xrandom.hpp>
+#include <xtensor/xview.hpp>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xio.hpp>
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using xt::xtensor;
+using ss::as_span;
+
+TEST(fixed_size, eligible)
+{
+    EXPECT_TRUE(ss::fixed::homotopy_eligible(16, 1));
+    EXPECT_TRUE(ss::fixed::homotopy_eligible(64, ss::fixed::max_columns));
+    EXPECT_FALSE(ss::fixed::homotopy_eligible(64, ss::fixed::max_columns + 1));
+    EXPECT_FALSE(ss::fixed::homotopy_eligible(20, 10));
+
+    EXPECT_TRUE(ss::fixed::irls_eligible(32, 10));
+    EXPECT_FALSE(ss::fixed::irls_eligible(32, 33));
+    EXPECT_FALSE(ss::fixed::irls_eligible(10, 5));
+}
+
+namespace
+{
+    /* the specialized homotopy solver follows the path of the general one */
+    template <typename T>
+    void homotopy_test(uint32_t M, uint32_t N)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::rand<T>({ M, N }, T(0), T(.1));
+        xt::view(A, xt::all(), N / 2) = T(1);
+        xt::view(A, xt::range(0, int(M), 2), N / 3) += T(.5);
+
+        xtensor<T, 1> signal = xt::random::rand<T>({ M }, T(1), T(1.1));
+        xt::view(signal, xt::range(1, int(M), 2)) += T(.3);
+
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+        auto general = kernelpp::run<ss::solve_homotopy>(
+            as_span(A), as_span(signal), T(.01), 50u, as_span(expect));
+
+        /* column-major, and every other row and column of a larger matrix */
+        std::vector<T> col_major(M * N);
+        std::vector<T> strided(4 * M * N, T(-1));
+
+        for (uint32_t i = 0; i < M; i++) {
+            for (uint32_t j = 0; j < N; j++) {
+                col_major[j * M + i] = A(i, j);
+                strided[(2 * i) * (2 * N) + 2 * j] = A(i, j);
+            }
+        }
+
+        const ss::ndspan<T, 2> views[] = {
+            as_span(A),
+            as_span<2>(col_major.data(), { M, N }, { 1, M }),
+            as_span<2>(strided.data(), { M, N }, { 4 * N, 2 })
+        };
+
+        for (auto& view : views) {
+            xtensor<T, 1> x = xt::ones<T>({ N });
+            auto fixed = kernelpp::run<ss::solve_homotopy_fixed>(
+                view, as_span(signal), T(.01), 50u, as_span(x));
+
+            ASSERT_TRUE(fixed.template is<ss::homotopy_report>());
+            EXPECT_EQ(general.template get<ss::homotopy_report>().iter,
+                      fixed.template get<ss::homotopy_report>().iter);
+            EXPECT_TRUE(xt::allclose(expect, x, 1e-4, 1e-5));
+        }
+    }
+
+    /* the specialized IRLS solver follows the iterations of the general one */
+    template <typename T>
+    void irls_test(uint32_t M, uint32_t N)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::randn({ M, N }, T(0), T(.01));
+        for (uint32_t n = 0; n < N; n++) { A(n, n) += T(1); }
+
+        ss::qr_decomposition<T> QR(as_span(A));
+        ss::irls_factors<T> F(QR);
+
+        for (uint32_t n = 0; n < N; n += 3)
+        {
+            xtensor<T, 1> signal = xt::view(A, xt::all(), n);
+            xt::view(signal, xt::all()) += T(.4) * xt::view(A, xt::all(), (n + 1) % N);
+
+            xtensor<T, 1> expect = xt::zeros<T>({ N });
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+
+            auto general = kernelpp::run<ss::solve_irls>(
+                F, as_span(signal), T(.001), 50u, as_span(expect));
+            auto fixed = kernelpp::run<ss::solve_irls_fixed>(
+                F, as_span(signal), T(.001), 50u, as_span(x));
+
+            ASSERT_TRUE(general.template is<ss::irls_report>());
+            ASSERT_TRUE(fixed.template is<ss::irls_report>());
+
+            const auto& g = general.template get<ss::irls_report>();
+            const auto& f = fixed.template get<ss::irls_report>();
+
+            EXPECT_EQ(g.iter, f.iter);
+            EXPECT_EQ(g.spd_failure, f.spd_failure);
+            EXPECT_TRUE(xt::allclose(expect, x, 1e-4, 1e-5));
+        }
+    }
+}
+
+TEST(fixed_size, homotopy)
+{
+    homotopy_test<float>(16, 40);
+    homotopy_test<double>(16, 40);
+    homotopy_test<float>(32, 100);
+    homotopy_test<double>(64, 512);
+}
+
+TEST(fixed_size, homotopy_not_compiled)
+{
+    xtensor<float, 2> A = xt::ones<float>({ 20, 10 });
+    xtensor<float, 1> signal = xt::ones<float>({ 20 });
+    xtensor<float, 1> x = xt::zeros<float>({ 10 });
+
+    auto result = kernelpp::run<ss::solve_homotopy_fixed>(
+        as_span(A), as_span(signal), .01f, 10u, as_span(x));
+
+    EXPECT_FALSE(result.is<ss::homotopy_report>());
+}
+
+TEST(fixed_size, irls)
+{
+    irls_test<float>(16, 5);
+    irls_test<double>(32, 10);
+    irls_test<double>(64, 40);
+}
+
+TEST(fixed_size, solver)
+{
+    /* selected by the solver for a compiled signal length */
+    const uint32_t M = 32, N = 64;
+    xt::random::seed(0);
+
+    xtensor<float, 2> A = xt::random::rand<float>({ M, N }, 0.f, .1f);
+    xt::view(A, xt::all(), 7) = 1.f;
+
+    xtensor<float, 1> signal = xt::view(A, xt::all(), 7);
+    xtensor<float, 1> x = xt::zeros<float>({ N });
+
+    auto result = ss::homotopy<float>(as_span(A)).solve(as_span(signal), .001f, N, as_span(x));
+
+    ASSERT_TRUE(result.is<ss::homotopy_report>());
+    EXPECT_EQ(xt::argmax(x)(), 7);
+    EXPECT_NEAR(x(7), 1.f, 1e-3f);
+}
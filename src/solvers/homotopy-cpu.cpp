@@ -18,6 +18,9 @@ limitations under the License.  */
 #include "linalg/blas_wrapper.h"
 #include "linalg/online_inverse.h"
 #include "linalg/rank_index.h"
+#include "linalg/sparse.h"
+#include "linalg/half.h"
+#include "linalg/quantized.h"
 
 #include <cstdint>
 #include <algorithm>
@@ -45,9 +48,9 @@ namespace ss
 
     template <typename T>
     void vec_subset(
-        const xt::xtensor<T, 1>& X,
+        const vec<T>& X,
         const rank_index<uint32_t>& indices,
-        xt::xtensor<T, 1>& X_subset)
+        vec<T>& X_subset)
     {
         size_t n = 0;
         for (const uint32_t i : indices) {
@@ -68,7 +71,7 @@ namespace ss
 
     template <typename T>
     void expand(
-        xt::xtensor<T, 1>& direction,
+        vec<T>& direction,
         const rank_index<uint32_t>& indices)
     {
         assert(indices.size() <= dim<0>(direction));
@@ -84,40 +87,225 @@ namespace ss
         while (i >= 0) { direction[i--] = T(0); }
     }
 
+    /* y := alpha * op(A) * x + beta * y, for a dense sensing matrix */
     template <typename T>
+    void gemv(CBLAS_TRANSPOSE trans, T alpha,
+        const mat_view<T>& A, const ndspan<T> x, T beta, ndspan<T> y)
+    {
+        blas::xgemv<T>(trans, alpha, A, x, beta, y);
+    }
+
+    /* y := alpha * op(A) * x + beta * y, for a sparse sensing matrix */
+    template <typename T>
+    void gemv(CBLAS_TRANSPOSE trans, T alpha,
+        const csc_span<T>& A, const ndspan<T> x, T beta, ndspan<T> y)
+    {
+        sparse::gemv(trans, alpha, A, x, beta, y);
+    }
+
+    /* y := alpha * op(A) * x + beta * y, for a 16-bit sensing matrix */
+    template <typename T>
+    void gemv(CBLAS_TRANSPOSE trans, T alpha,
+        const half::matrix& A, const ndspan<T> x, T beta, ndspan<T> y)
+    {
+        half::gemv(trans, alpha, A, x, beta, y);
+    }
+
+    namespace detail
+    {
+        /* bounds of a step n / d over intervals of n and d */
+        template <typename T>
+        struct step_bounds
+        {
+            /* whether the step may be positive, and is certainly so */
+            bool possible, certain;
+            T lo, hi;
+        };
+
+        template <typename T>
+        step_bounds<T> bound_step(T n_lo, T n_hi, T d_lo, T d_hi)
+        {
+            if (n_lo > 0 && d_lo > 0) { return { true, true, n_lo / d_hi, n_hi / d_lo }; }
+            if (n_hi < 0 && d_hi < 0) { return { true, true, n_hi / d_lo, n_lo / d_hi }; }
+
+            /* certainly zero or negative */
+            if ((n_hi <= 0 && d_lo > 0) || (n_lo >= 0 && d_hi < 0)) {
+                return { false, false, T(0), T(0) };
+            }
+            return { true, false, T(0), std::numeric_limits<T>::max() };
+        }
+    }
+
+    /*  A dense sensing matrix with an int8 copy, which screens the
+     *  correlations transpose(A) * r and transpose(A) * p. Only the columns
+     *  where the estimates can't decide the outcome are evaluated exactly.
+     */
+    template <typename T>
+    struct screened
+    {
+        const mat_view<T> A;
+        const quantized::matrix Q;
+
+        /*  scratch, written by residual_vector: the residual and the error
+         *  bound of each correlation (zero where it is exact)
+         */
+        mutable aligned_vector<T> r;
+        mutable aligned_vector<T> c_err;
+        mutable aligned_vector<T> estimate;
+
+        /* scratch of find_max_gamma, sized once per solve */
+        mutable aligned_vector<T> p, q, q_err, c_exact;
+        mutable std::vector<detail::step_bounds<T>> bounds;
+        mutable std::vector<uint8_t> candidates;
+
+        screened(const mat_view<T> A, const quantized::matrix Q)
+            : A(A), Q(Q)
+            , r(dim<0>(A)), c_err(dim<1>(A)), estimate(dim<1>(A))
+            , p(dim<0>(A)), q(dim<1>(A)), q_err(dim<1>(A)), c_exact(dim<1>(A))
+            , bounds(dim<1>(A)), candidates(dim<1>(A))
+        {}
+
+        const std::array<size_t, 2>& shape() const { return Q.shape(); }
+    };
+
+    /* the exact dot product of column j of A with v */
+    template <typename T>
+    T column_dot(const mat_view<T>& A, size_t j, const T* v)
+    {
+        const T* col = blas::detail::data(A) + j * stride<1>(A);
+        return blas::xdot(blasint(dim<0>(A)), col, blasint(std::max(size_t(1), stride<0>(A))), v, 1);
+    }
+
+    /*  y := sum of alpha * x[j] * column j of A, over the nonzero elements
+     *  of x only; these are the active set, so only K columns are read
+     */
+    template <typename T>
+    void active_gemv(const mat_view<T>& A, T alpha, const ndspan<T> x, T* y)
+    {
+        const size_t m = dim<0>(A), n = dim<1>(A);
+        const size_t inc = std::max(size_t(1), stride<0>(A));
+
+        std::fill(y, y + m, T(0));
+        for (size_t j = 0; j < n; j++)
+        {
+            if (x[j] == T(0)) { continue; }
+
+            const T a = alpha * x[j];
+            const T* col = blas::detail::data(A) + j * stride<1>(A);
+            for (size_t i = 0; i < m; i++) { y[i] += a * col[i * inc]; }
+        }
+    }
+
+    template <typename T>
+    void insert_column(
+        online_column_inverse<T>& inv, size_t rank, const mat_view<T>& A, size_t A_col)
+    {
+        if (blas::detail::unit_stride<0>(A)) {
+            /* contiguous column (e.g. column-major A), copied directly */
+            const T* col = blas::detail::data(A) + A_col * stride<1>(A);
+            inv.insert(rank, col, col + dim<0>(A));
+        }
+        else {
+            auto col = xt::view(A, xt::all(), A_col);
+            inv.insert(rank, col.cbegin(), col.cend());
+        }
+    }
+
+    template <typename T>
+    void insert_column(
+        online_column_inverse<T>& inv, size_t rank, const csc_span<T>& A, size_t A_col)
+    {
+        aligned_vector<T> col(dim<0>(A));
+
+        sparse::column(A, A_col, col.data());
+        inv.insert(rank, col.cbegin(), col.cend());
+    }
+
+    template <typename T>
+    void insert_column(
+        online_column_inverse<T>& inv, size_t rank, const half::matrix& A, size_t A_col)
+    {
+        aligned_vector<T> col(dim<0>(A));
+
+        half::column(A, A_col, col.data());
+        inv.insert(rank, col.cbegin(), col.cend());
+    }
+
+    template <typename T>
+    void insert_column(
+        online_column_inverse<T>& inv, size_t rank, const screened<T>& A, size_t A_col)
+    {
+        insert_column(inv, rank, A.A, A_col);
+    }
+
+    template <typename T, typename Matrix>
     void residual_vector(
-        const mat_view<T> A,
+        const Matrix& A,
         const ndspan<T> y,
         const ndspan<T> x_previous,
-        ndspan<T> c)
+        ndspan<T> c,
+        const rank_index<uint32_t>&)
     {
-        xt::xtensor<T, 1> A_x = y;
+        vec<T> A_x = y;
 
-        blas::xgemv<T>(CblasNoTrans, -1.0, A, x_previous, 1.0, A_x);
-        blas::xgemv<T>(CblasTrans,    1.0, A, A_x,        0.0, c);
+        gemv(CblasNoTrans, T(-1), A, x_previous, T(1), as_span(A_x));
+        gemv(CblasTrans,   T(1),  A, as_span(A_x), T(0), c);
     }
 
     template <typename T>
-    std::pair<T, size_t> find_max_gamma(
-        const mat_view<T> A,
-        const ndspan<T> c,
-        const ndspan<T> x,
-        const ndspan<T> direction,
-        const T c_inf,
+    void residual_vector(
+        const screened<T>& S,
+        const ndspan<T> y,
+        const ndspan<T> x_previous,
+        ndspan<T> c,
         const rank_index<uint32_t>& lambda_indices)
     {
-        assert(lambda_indices.size() <= dim<1>(A));
+        const size_t m = dim<0>(S), n = dim<1>(S);
+        aligned_vector<T>& r = S.r;
+        aligned_vector<T>& err = S.c_err;
 
-        /* evaluate the eligible elements of transpose(A) * A * dir_vec */
-        const size_t m = dim<0>(A), n = dim<1>(A);
+        /* r = y - A x, from the columns of the active set */
+        active_gemv(S.A, T(-1), x_previous, r.data());
+        for (size_t i = 0; i < m; i++) { r[i] += y[i]; }
 
-        /* p = Ad */
-        auto p = xt::xtensor<T, 1>::from_shape({ m });
-        blas::xgemv<T>(CblasNoTrans, 1.0, A, direction, 0.0, p);
+        quantized::gemv_t(S.Q, r.data(), S.estimate.data(), err.data());
 
-        /* q = transpose(A) p */
-        auto q = xt::xtensor<T, 1>::from_shape({ n });
-        blas::xgemv<T>(CblasTrans, 1.0, A, p, 0.0, q);
+        for (size_t j = 0; j < n; j++) { c[j] = S.estimate[j]; }
+
+        auto refine = [&](size_t j) {
+            c[j] = column_dot(S.A, j, r.data());
+            err[j] = T(0);
+        };
+
+        /* the active set is read exactly */
+        for (const uint32_t j : lambda_indices) { refine(j); }
+
+        /*  as is every column which may hold the largest magnitude, so that
+         *  the infinity norm and its index are exact
+         */
+        T lower{ 0 };
+        for (size_t j = 0; j < n; j++) { lower = std::max(lower, std::abs(c[j]) - err[j]); }
+
+        for (size_t j = 0; j < n; j++) {
+            if (err[j] > T(0) && std::abs(c[j]) + err[j] >= lower) { refine(j); }
+        }
+    }
+
+    /*  the smallest positive step along the direction at which an element
+     *  enters or leaves the active set, and the index of that element;
+     *  inactive elements which aren't candidates (when given) are skipped
+     */
+    template <typename T>
+    std::pair<T, size_t> min_gamma(
+        const ndspan<T> c,
+        const ndspan<T> q,
+        const ndspan<T> x,
+        const ndspan<T> direction,
+        const T c_inf,
+        const rank_index<uint32_t>& lambda_indices,
+        const std::vector<uint8_t>* candidates = nullptr)
+    {
+        const size_t n = dim<0>(c);
 
         /* evaluate the competing lists of terms */
         T min{ std::numeric_limits<T>::max() };
@@ -137,7 +325,7 @@ namespace ss
                 }
                 ldx++;
             }
-            else {
+            else if (!candidates || (*candidates)[i]) {
                 T di_left{ T(1) - q[i] }, di_right{ T(1) + q[i] };
 
                 if (di_left != 0.0) {
@@ -163,9 +351,113 @@ namespace ss
         return std::make_pair(min, idx);
     }
 
+    template <typename T, typename Matrix>
+    std::pair<T, size_t> find_max_gamma(
+        const Matrix& A,
+        const ndspan<T> c,
+        const ndspan<T> x,
+        const ndspan<T> direction,
+        const T c_inf,
+        const rank_index<uint32_t>& lambda_indices)
+    {
+        assert(lambda_indices.size() <= dim<1>(A));
+
+        /* evaluate the eligible elements of transpose(A) * A * dir_vec */
+        const size_t m = dim<0>(A), n = dim<1>(A);
+
+        /* p = Ad */
+        auto p = vec<T>::from_shape({ m });
+        gemv(CblasNoTrans, T(1), A, direction, T(0), as_span(p));
+
+        /* q = transpose(A) p */
+        auto q = vec<T>::from_shape({ n });
+        gemv(CblasTrans, T(1), A, as_span(p), T(0), as_span(q));
+
+        return min_gamma<T>(c, as_span(q), x, direction, c_inf, lambda_indices);
+    }
+
     template <typename T>
+    std::pair<T, size_t> find_max_gamma(
+        const screened<T>& S,
+        const ndspan<T> c,
+        const ndspan<T> x,
+        const ndspan<T> direction,
+        const T c_inf,
+        const rank_index<uint32_t>& lambda_indices)
+    {
+        const size_t n = dim<1>(S);
+        const aligned_vector<T>& c_err = S.c_err;
+        aligned_vector<T>& p = S.p;
+        aligned_vector<T>& q = S.q;
+        aligned_vector<T>& q_err = S.q_err;
+        auto& bounds = S.bounds;
+
+        /* p = Ad, from the columns of the active set */
+        active_gemv(S.A, T(1), direction, p.data());
+
+        /* estimates of q = transpose(A) p */
+        quantized::gemv_t(S.Q, p.data(), q.data(), q_err.data());
+
+        /*  bound every step, and find the smallest step which certainly
+         *  exists; only the elements whose step may be below it compete
+         */
+        T upper{ std::numeric_limits<T>::max() };
+
+        for (const uint32_t i : lambda_indices) {
+            const T step = -x[i] / direction[i];
+            if (step > 0) { upper = std::min(upper, step); }
+        }
+
+        auto ldx = std::begin(lambda_indices);
+        auto end = std::end(lambda_indices);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (ldx != end && *ldx == i) { ldx++; continue; }
+
+            const T c_lo = c[i] - c_err[i], c_hi = c[i] + c_err[i];
+            const T q_lo = q[i] - q_err[i], q_hi = q[i] + q_err[i];
+
+            auto left  = detail::bound_step(c_inf - c_hi, c_inf - c_lo, T(1) - q_hi, T(1) - q_lo);
+            auto right = detail::bound_step(c_inf + c_lo, c_inf + c_hi, T(1) + q_lo, T(1) + q_hi);
+
+            if (left.certain)  { upper = std::min(upper, left.hi); }
+            if (right.certain) { upper = std::min(upper, right.hi); }
+
+            /* merged, as either may be the minimum */
+            bounds[i] = {
+                left.possible || right.possible, false,
+                std::min(left.possible  ? left.lo  : std::numeric_limits<T>::max(),
+                         right.possible ? right.lo : std::numeric_limits<T>::max()),
+                T(0) };
+        }
+
+        /* evaluate the candidates exactly */
+        aligned_vector<T>& c_exact = S.c_exact;
+        std::vector<uint8_t>& candidates = S.candidates;
+
+        std::copy(c.cbegin(), c.cend(), c_exact.begin());
+        std::fill(candidates.begin(), candidates.end(), uint8_t(0));
+
+        ldx = std::begin(lambda_indices);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (ldx != end && *ldx == i) { ldx++; continue; }
+            if (!bounds[i].possible || bounds[i].lo > upper) { continue; }
+
+            candidates[i] = 1;
+            q[i] = column_dot(S.A, i, p.data());
+
+            if (c_err[i] > T(0)) { c_exact[i] = column_dot(S.A, i, S.r.data()); }
+        }
+
+        return min_gamma<T>(as_span(c_exact.data(), n), as_span(q.data(), n), x, direction, c_inf,
+            lambda_indices, &candidates);
+    }
+
+    template <typename T, typename Matrix>
     void inverse_add_or_remove(
-        const mat_view<T>&        A,
+        const Matrix&             A,
         size_t                    A_col,
         rank_index<uint32_t>&     lambda_indices,
         online_column_inverse<T>& inv)
@@ -177,14 +469,13 @@ namespace ss
         }
         else {
             rank = lambda_indices.insert(A_col);
-            auto col = xt::view(A, xt::all(), A_col);
-            inv.insert(rank, col.cbegin(), col.cend());
+            insert_column(inv, rank, A, A_col);
         }
     }
 
-    template <typename T>
+    template <typename T, typename Matrix>
     homotopy_report run_solver(
-        const ndspan<T, 2> A,
+        const Matrix& A,
         const std::uint32_t max_iter,
         const T tolerance,
         const ndspan<T> y,
@@ -203,22 +494,22 @@ namespace ss
         /* initialise x */
         view(x) = T(0);
 
-        auto direction = xt::xtensor<T, 1>::from_shape({ N });
-        auto c         = xt::xtensor<T, 1>::from_shape({ N });
-        auto c_gamma   = xt::xtensor<T, 1>::from_shape({ N });
+        auto direction = vec<T>::from_shape({ N });
+        auto c         = vec<T>::from_shape({ N });
+        auto c_gamma   = vec<T>::from_shape({ N });
         T    c_inf     = T(0);
 
         rank_index<uint32_t> lambda_indices;
         online_column_inverse<T> inv(dim<0>(A), size_t(log(N)));
 
         /* initialise residual vector */
-        residual_vector(A, y, x, as_span(c));
+        residual_vector<T>(A, y, x, as_span(c), lambda_indices);
 
         {   /* initialise lambda = || c_vec || _inf */
             size_t idx;
             c_inf = inf_norm(as_span(c), &idx);
 
-            inverse_add_or_remove(A, idx, lambda_indices, inv);
+            inverse_add_or_remove<T>(A, idx, lambda_indices, inv);
 
             T c_gamma{ c_inf };
             sign(as_span(&c_gamma, { 1 }), tolerance);
@@ -232,18 +523,21 @@ namespace ss
              - the infinity norm of residual vector is within tolerance
              - the residual vector length reaches zero 
          */
+        const solve_control* control = detail::current_control();
+        bool truncated{ false };
+
         std::uint32_t iter{ 0u };
         do {
             iter++;
 
             T min; size_t idx;
 
-            std::tie(min, idx) = find_max_gamma(A, as_span(c), x,
+            std::tie(min, idx) = find_max_gamma<T>(A, as_span(c), x,
                 as_span(direction), c_inf, lambda_indices);
 
             /* update inverse by inserting/removing the
                respective index from the inverse */
-            inverse_add_or_remove(A, idx, lambda_indices, inv);
+            inverse_add_or_remove<T>(A, idx, lambda_indices, inv);
 
             auto K = lambda_indices.size();
             if (K == 0) { break; }
@@ -252,7 +546,7 @@ namespace ss
             ss::view(x) += min * direction;
 
             /* update residual vector */
-            residual_vector(A, y, x, as_span(c));
+            residual_vector<T>(A, y, x, as_span(c), lambda_indices);
 
             {   /* update direction vector */
                 /* produce a subset of c and map to -1,0,+1 */
@@ -269,9 +563,10 @@ namespace ss
             /* find lambda (i.e., infinity norm of residual vector) */
             c_inf = inf_norm(as_span(c));
         }
-        while (iter < max_iter && c_inf > tolerance);
+        while (iter < max_iter && c_inf > tolerance
+            && !(truncated = detail::expired(control)));
         
-        return{ iter, c_inf };
+        return{ iter, c_inf, truncated };
     }
 
     template <> kernelpp::variant<homotopy_report, error_code>
@@ -295,4 +590,300 @@ namespace ss
     {
         return run_solver<double>(A, max_iterations, tolerance, y, x);
     }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_sparse::op<compute_mode::CPU, float>(
+        const csc_span<float> A,
+        const ndspan<float> y,
+        float tolerance,
+        std::uint32_t max_iterations,
+        ndspan<float> x)
+    {
+        return run_solver<float>(A, max_iterations, tolerance, y, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_sparse::op<compute_mode::CPU, double>(
+        const csc_span<double> A,
+        const ndspan<double> y,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return run_solver<double>(A, max_iterations, tolerance, y, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_reduced::op<compute_mode::CPU, float>(
+        const half::matrix A,
+        const ndspan<float> y,
+        float tolerance,
+        std::uint32_t max_iterations,
+        ndspan<float> x)
+    {
+        return run_solver<float>(A, max_iterations, tolerance, y, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_reduced::op<compute_mode::CPU, double>(
+        const half::matrix A,
+        const ndspan<double> y,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return run_solver<double>(A, max_iterations, tolerance, y, x);
+    }
+
+    template <typename T>
+    homotopy_report run_screened(
+        const mat_view<T> A,
+        const quantized::matrix Q,
+        const std::uint32_t max_iter,
+        const T tolerance,
+        const ndspan<T> y,
+        ndspan<T> x)
+    {
+        const screened<T> S(A, Q);
+        return run_solver<T>(S, max_iter, tolerance, y, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_screened::op<compute_mode::CPU, float>(
+        const ndspan<float, 2> A,
+        const quantized::matrix Q,
+        const ndspan<float> y,
+        float tolerance,
+        std::uint32_t max_iterations,
+        ndspan<float> x)
+    {
+        return run_screened<float>(A, Q, max_iterations, tolerance, y, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_screened::op<compute_mode::CPU, double>(
+        const ndspan<double, 2> A,
+        const quantized::matrix Q,
+        const ndspan<double> y,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return run_screened<double>(A, Q, max_iterations, tolerance, y, x);
+    }
+    /*  Rebuilds the active set of a window from the nonzero elements of
+        its solution, and its correlations */
+    template <typename T>
+    void reset_window(homotopy_window<T>& W)
+    {
+        W.active = rank_index<uint32_t>();
+        W.inv.reset(new online_column_inverse<T>(dim<0>(W.A)));
+
+        for (size_t j = 0; j < dim<1>(W.A); j++) {
+            if (W.x[j] != T(0)) { inverse_add_or_remove<T>(W.A, j, W.active, *W.inv); }
+        }
+        residual_vector<T>(W.A, as_span(W.y), as_span(W.x), as_span(W.c), W.active);
+        W.unverified = 0;
+    }
+
+    template <typename T>
+    homotopy_report solve_window(
+        homotopy_window<T>& W,
+        const std::uint32_t max_iter,
+        const T tolerance)
+    {
+        auto report = run_solver<T>(W.A, max_iter, tolerance, as_span(W.y), as_span(W.x));
+        reset_window(W);
+
+        W.lambda = T(report.solution_error);
+        W.warm = !report.truncated && report.solution_error <= tolerance && W.active.size() > 0;
+
+        return report;
+    }
+
+    /*  Follows the solution of the window as its signal moves from y to y
+     *  + dy, with the correlation of the active set held at lambda, i.e.
+     *  from y + e dy for e = 0 to 1. Along each segment x moves by e dx on
+     *  the active set, where dx = inv(A_G^T A_G) A_G^T dy, and c by e q,
+     *  where q = transpose(A) (dy - A dx); a segment ends where an element
+     *  of x reaches zero, or a correlation off the active set reaches
+     *  lambda. Returns false if the path can't be followed.
+     */
+    template <typename T>
+    bool follow_window(
+        homotopy_window<T>& W,
+        const vec<T>& u,
+        const std::uint32_t max_iter,
+        std::uint32_t& iter,
+        bool& truncated)
+    {
+        const size_t m = dim<0>(W.A), n = dim<1>(W.A);
+        const solve_control* control = detail::current_control();
+
+        auto dx      = vec<T>::from_shape({ n });
+        auto u_gamma = vec<T>::from_shape({ n });
+        auto p       = vec<T>::from_shape({ m });
+        vec<T> q;
+
+        /* the element which changed last, which can't change again at once */
+        size_t last = n;
+        T e{ 0 };
+
+        while (e < T(1))
+        {
+            const size_t K = W.active.size();
+            if (K == 0 || iter == max_iter) { return false; }
+            iter++;
+
+            /* dx = inv(A_G^T A_G) transpose(A_G) dy */
+            vec_subset(u, W.active, u_gamma);
+            blas::xgemv<T>(CblasNoTrans, 1.0, W.inv->inverse(), u_gamma, 0.0, dx);
+            expand(dx, W.active);
+
+            /* q = transpose(A) (dy - A dx), zero on the active set */
+            active_gemv(W.A, T(1), as_span(dx), p.raw_data());
+            q = u;
+            gemv(CblasTrans, T(-1), W.A, as_span(p), T(1), as_span(q));
+
+            T step{ T(1) - e };
+            size_t idx{ n };
+
+            auto ldx = std::begin(W.active);
+            auto end = std::end(W.active);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                T t{ -1 };
+                if (ldx != end && *ldx == i) {
+                    if (dx[i] != T(0)) { t = -W.x[i] / dx[i]; }
+                    ldx++;
+                }
+                else if (q[i] > T(0)) { t = ( W.lambda - W.c[i]) / q[i]; }
+                else if (q[i] < T(0)) { t = (-W.lambda - W.c[i]) / q[i]; }
+
+                if (i != last && t > T(0) && t < step) { step = t; idx = i; }
+            }
+
+            ss::view(W.x) += step * dx;
+            ss::view(W.c) += step * q;
+            e += step;
+
+            if (idx == n) { break; }
+
+            /* an element leaves, or enters */
+            if (W.active.rank_of(uint32_t(idx)) >= 0) {
+                W.x[idx] = T(0);
+            }
+            else if (K == m) {
+                return false;
+            }
+            inverse_add_or_remove<T>(W.A, idx, W.active, *W.inv);
+            last = idx;
+
+            if (detail::expired(control)) {
+                truncated = true;
+                return true;
+            }
+        }
+        return true;
+    }
+
+    /*  the warm follows between exact recomputations of the correlations;
+        in between, c as updated along each path is used, which differs
+        from the exact correlations by rounding alone */
+    constexpr uint32_t window_verify_interval = 16;
+
+    template <typename T>
+    homotopy_report run_window(
+        homotopy_window<T>& W,
+        size_t first,
+        const ndspan<T> values,
+        const std::uint32_t max_iter,
+        const T tolerance,
+        ndspan<T> x)
+    {
+        const size_t m = dim<0>(W.A), n = dim<1>(W.A);
+
+        assert(max_iter > 0 && x.size() == n);
+
+        /* u = transpose(A) dy, over the rows which change */
+        vec<T> u = xt::zeros<T>({ n });
+        const T* a = blas::detail::data(W.A);
+        const size_t s0 = stride<0>(W.A), s1 = stride<1>(W.A);
+
+        for (size_t k = 0; k < values.size(); k++)
+        {
+            const size_t row = (first + k) % m;
+            const T d = values[k] - W.y[row];
+
+            W.y[row] = values[k];
+            if (d == T(0)) { continue; }
+
+            for (size_t j = 0; j < n; j++) { u[j] += d * a[row * s0 + j * s1]; }
+        }
+
+        homotopy_report report{ 0u, 0.0 };
+
+        if (W.warm)
+        {
+            bool truncated{ false };
+            W.warm = follow_window(W, u, max_iter, report.iter, truncated);
+
+            if (W.warm && truncated) {
+                /* x solves neither window */
+                W.warm = false;
+                report.truncated = true;
+                report.solution_error = inf_norm(as_span(W.c));
+            }
+            else if (W.warm) {
+                /* that the correlations are within tolerance */
+                if (++W.unverified >= window_verify_interval) {
+                    residual_vector<T>(W.A, as_span(W.y), as_span(W.x), as_span(W.c), W.active);
+                    W.unverified = 0;
+                }
+                report.solution_error = inf_norm(as_span(W.c));
+                W.warm = report.solution_error <= tolerance;
+
+                if (W.warm) {
+                    std::copy(W.x.cbegin(), W.x.cend(), x.begin());
+                    return report;
+                }
+            }
+        }
+
+        if (!report.truncated)
+        {
+            const uint32_t warm_iter = report.iter;
+
+            report = solve_window(W, max_iter, tolerance);
+            report.iter += warm_iter;
+        }
+
+        std::copy(W.x.cbegin(), W.x.cend(), x.begin());
+        return report;
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_window::op<compute_mode::CPU, float>(
+        homotopy_window<float>& W,
+        size_t first,
+        const ndspan<float> values,
+        float tolerance,
+        std::uint32_t max_iterations,
+        ndspan<float> x)
+    {
+        return run_window<float>(W, first, values, max_iterations, tolerance, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_window::op<compute_mode::CPU, double>(
+        homotopy_window<double>& W,
+        size_t first,
+        const ndspan<double> values,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return run_window<double>(W, first, values, max_iterations, tolerance, x);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,361 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "solvers/homotopy.h"
+#include "solvers/fixed_size.h"
+
+#include "linalg/common.h"
+#include "linalg/blas_wrapper.h"
+
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <assert.h>
+
+namespace ss {
+namespace fixed
+{
+    /*  c := transpose(A) * v, where A has M rows, n columns and the strides
+     *  s0 and s1. Row-major matrices are accumulated a row at a time, so
+     *  the inner loop is vectorized along the row; otherwise each column
+     *  is a dot product of constant length.
+     */
+    template <size_t M, typename T>
+    void gemv_t(const T* a, size_t n, size_t s0, size_t s1,
+        const T* __restrict v, T* __restrict c)
+    {
+        if (s1 == 1)
+        {
+            for (size_t j = 0; j < n; j++) { c[j] = T(0); }
+
+            for (size_t m = 0; m < M; m++) {
+                const T* __restrict row = a + m * s0;
+                const T vm = v[m];
+
+                for (size_t j = 0; j < n; j++) { c[j] += vm * row[j]; }
+            }
+        }
+        else if (s0 == 1)
+        {
+            for (size_t j = 0; j < n; j++) {
+                const T* __restrict col = a + j * s1;
+                T s{ 0 };
+
+                for (size_t m = 0; m < M; m++) { s += col[m] * v[m]; }
+                c[j] = s;
+            }
+        }
+        else
+        {
+            for (size_t j = 0; j < n; j++) {
+                T s{ 0 };
+                for (size_t m = 0; m < M; m++) { s += a[m * s0 + j * s1] * v[m]; }
+                c[j] = s;
+            }
+        }
+    }
+
+    /*  The columns of the active set and the inverse of their Gram matrix,
+     *  as online_column_inverse, but of at most M columns kept in the order
+     *  they were inserted; a removed column is replaced by the last one.
+     */
+    template <size_t M, typename T>
+    struct active_set
+    {
+        size_t size = 0;
+
+        /* the column of A held in each position */
+        uint32_t index[M];
+
+        alignas(64) T columns[M][M];
+        alignas(64) T inverse[M][M];
+
+        void insert(uint32_t j, const T* __restrict col)
+        {
+            const size_t K = size;
+            T* __restrict a = columns[K];
+
+            T dot{ 0 };
+            for (size_t m = 0; m < M; m++) {
+                a[m] = col[m];
+                dot += col[m] * col[m];
+            }
+
+            if (K == 0) {
+                inverse[0][0] = T(1) / dot;
+            }
+            else {
+                T u1[M], u2[M];
+
+                /* u1 = transpose(A_active) a */
+                for (size_t k = 0; k < K; k++) {
+                    T s{ 0 };
+                    for (size_t m = 0; m < M; m++) { s += columns[k][m] * a[m]; }
+                    u1[k] = s;
+                }
+
+                /* u2 = inv * u1 */
+                T s{ dot };
+                for (size_t i = 0; i < K; i++) {
+                    T u{ 0 };
+                    for (size_t k = 0; k < K; k++) { u += inverse[i][k] * u1[k]; }
+                    u2[i] = u;
+                    s -= u1[i] * u;
+                }
+
+                const T d = T(1) / s;
+
+                for (size_t i = 0; i < K; i++) {
+                    for (size_t k = 0; k < K; k++) { inverse[i][k] += d * u2[i] * u2[k]; }
+                }
+                for (size_t i = 0; i < K; i++) {
+                    inverse[i][K] = inverse[K][i] = -d * u2[i];
+                }
+                inverse[K][K] = d;
+            }
+
+            index[K] = j;
+            size++;
+        }
+
+        void remove(size_t k)
+        {
+            const size_t L = size - 1;
+
+            if (k != L) {
+                /* exchange positions k and L, symmetrically in the inverse */
+                std::swap(index[k], index[L]);
+                for (size_t m = 0; m < M; m++) { std::swap(columns[k][m], columns[L][m]); }
+                for (size_t i = 0; i < size; i++) { std::swap(inverse[i][k], inverse[i][L]); }
+                for (size_t i = 0; i < size; i++) { std::swap(inverse[k][i], inverse[L][i]); }
+            }
+
+            const T d = inverse[L][L];
+            for (size_t i = 0; i < L; i++) {
+                const T s = inverse[i][L] / d;
+                for (size_t j = 0; j < L; j++) { inverse[i][j] -= s * inverse[L][j]; }
+            }
+
+            size = L;
+        }
+    };
+
+    template <typename T>
+    T sign(T val, T tol) {
+        return val > tol ? T(1) : val < -tol ? T(-1) : T(0);
+    }
+
+    /*  The homotopy solver of solvers/homotopy-cpu.cpp, following the same
+     *  path, with the active set held by position rather than by rank.
+     */
+    template <size_t M, typename T>
+    homotopy_report run_solver(
+        const ndspan<T, 2> A,
+        const std::uint32_t max_iter,
+        const T tolerance,
+        const ndspan<T> y,
+        ndspan<T> x)
+    {
+        assert(max_iter > 0
+            && dim<0>(A) == M
+            && dim<1>(A) <= max_columns
+            && y.size() == M
+            && x.size() == dim<1>(A));
+
+        const size_t N = dim<1>(A);
+        const T* a = blas::detail::data(A);
+        const size_t s0 = stride<0>(A), s1 = stride<1>(A);
+
+        alignas(64) T signal[M], r[M], p[M], direction[M];
+        alignas(64) T c[max_columns], q[max_columns], xs[max_columns];
+
+        /* the position of each column in the active set, or -1 */
+        int32_t position[max_columns];
+        active_set<M, T> S;
+
+        for (size_t m = 0; m < M; m++) { signal[m] = y[m]; }
+        std::fill(xs, xs + N, T(0));
+        std::fill(position, position + N, -1);
+
+        /* c = transpose(A) (y - A x), where x is zero off the active set */
+        auto residual_vector = [&]() {
+            for (size_t m = 0; m < M; m++) { r[m] = signal[m]; }
+            for (size_t k = 0; k < S.size; k++) {
+                const T xk = xs[S.index[k]];
+                for (size_t m = 0; m < M; m++) { r[m] -= xk * S.columns[k][m]; }
+            }
+            gemv_t<M>(a, N, s0, s1, r, c);
+        };
+
+        /* the infinity norm of c, and its first index */
+        auto inf_norm = [&](size_t& idx) {
+            T max{ -1 };
+            for (size_t j = 0; j < N; j++) {
+                if (std::abs(c[j]) > max) { max = std::abs(c[j]); idx = j; }
+            }
+            return max;
+        };
+
+        auto add_or_remove = [&](size_t j) {
+            if (position[j] >= 0) {
+                const size_t k = position[j];
+
+                S.remove(k);
+                if (k < S.size) { position[S.index[k]] = int32_t(k); }
+
+                position[j] = -1;
+                xs[j] = T(0);
+            }
+            else {
+                alignas(64) T col[M];
+                for (size_t m = 0; m < M; m++) { col[m] = a[m * s0 + j * s1]; }
+
+                position[j] = int32_t(S.size);
+                S.insert(uint32_t(j), col);
+            }
+        };
+
+        /* initialise lambda = || c_vec || _inf */
+        residual_vector();
+
+        size_t idx{ 0 };
+        T c_inf = inf_norm(idx);
+
+        add_or_remove(idx);
+        direction[0] = sign(c_inf, tolerance) * S.inverse[0][0];
+
+        const solve_control* control = detail::current_control();
+        bool truncated{ false };
+
+        std::uint32_t iter{ 0u };
+        do {
+            iter++;
+
+            const size_t K = S.size;
+
+            /* p = A d, over the active columns */
+            for (size_t m = 0; m < M; m++) { p[m] = T(0); }
+            for (size_t k = 0; k < K; k++) {
+                for (size_t m = 0; m < M; m++) { p[m] += direction[k] * S.columns[k][m]; }
+            }
+
+            /* q = transpose(A) p */
+            gemv_t<M>(a, N, s0, s1, p, q);
+
+            /* the smallest step at which an element enters or leaves */
+            T min{ std::numeric_limits<T>::max() };
+            idx = 0;
+
+            for (size_t i = 0; i < N; i++) {
+                const T prev = min;
+
+                if (position[i] >= 0) {
+                    T minT = -xs[i] / direction[position[i]];
+                    if (minT > 0.0 && minT < min) { min = minT; }
+                }
+                else {
+                    T di_left{ T(1) - q[i] }, di_right{ T(1) + q[i] };
+
+                    if (di_left != 0.0) {
+                        T leftT = (c_inf - c[i]) / di_left;
+                        if (leftT > 0.0 && leftT < min) { min = leftT; }
+                    }
+                    if (di_right != 0.0) {
+                        T rightT = (c_inf + c[i]) / di_right;
+                        if (rightT > 0.0 && rightT < min) { min = rightT; }
+                    }
+                }
+                if (prev > min) { idx = i; }
+            }
+
+            /*  stop when the active set would empty, or the next column
+                can't be independent of a full one */
+            if (position[idx] >= 0 ? K == 1 : K == M) { break; }
+
+            /* update x */
+            for (size_t k = 0; k < K; k++) { xs[S.index[k]] += min * direction[k]; }
+
+            add_or_remove(idx);
+
+            /* update residual vector */
+            residual_vector();
+
+            {   /* update direction vector */
+                T c_gamma[M];
+                for (size_t k = 0; k < S.size; k++) {
+                    c_gamma[k] = sign(c[S.index[k]], tolerance);
+                }
+                for (size_t i = 0; i < S.size; i++) {
+                    T d{ 0 };
+                    for (size_t k = 0; k < S.size; k++) { d += S.inverse[i][k] * c_gamma[k]; }
+                    direction[i] = d;
+                }
+            }
+
+            /* find lambda (i.e., infinity norm of residual vector) */
+            c_inf = inf_norm(idx);
+        }
+        while (iter < max_iter && c_inf > tolerance
+            && !(truncated = detail::expired(control)));
+
+        for (size_t j = 0; j < N; j++) { x[j] = xs[j]; }
+
+        return{ iter, c_inf, truncated };
+    }
+
+    template <typename T>
+    kernelpp::variant<homotopy_report, error_code> dispatch(
+        const ndspan<T, 2> A,
+        const ndspan<T> y,
+        T tolerance,
+        std::uint32_t max_iterations,
+        ndspan<T> x)
+    {
+        if (dim<1>(A) > max_columns) { return error_code::KERNEL_FAILED; }
+
+        switch (dim<0>(A)) {
+#define SS_FIXED_CASE(M) \
+            case M: return run_solver<M, T>(A, max_iterations, tolerance, y, x);
+            SS_FIXED_SIGNAL_LENGTHS(SS_FIXED_CASE)
+#undef SS_FIXED_CASE
+            default:
+                return error_code::KERNEL_FAILED;
+        }
+    }
+}
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_fixed::op<compute_mode::CPU, float>(
+        const ndspan<float, 2> A,
+        const ndspan<float> y,
+        float tolerance,
+        std::uint32_t max_iterations,
+        ndspan<float> x)
+    {
+        return fixed::dispatch<float>(A, y, tolerance, max_iterations, x);
+    }
+
+    template <> kernelpp::variant<homotopy_report, error_code>
+    solve_homotopy_fixed::op<compute_mode::CPU, double>(
+        const ndspan<double, 2> A,
+        const ndspan<double> y,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return fixed::dispatch<double>(A, y, tolerance, max_iterations, x);
+    }
+}
@@ -18,6 +18,13 @@ limitations under the License.  */
 #include <kernelpp/kernel.h>
 
 #include "ss/ss.h"
+#include "linalg/common.h"
+#include "linalg/half.h"
+#include "linalg/online_inverse.h"
+#include "linalg/quantized.h"
+#include "linalg/rank_index.h"
+
+#include <memory>
 
 namespace ss
 {
@@ -36,4 +43,113 @@ namespace ss
             ndspan<T> x
             );
     };
+
+    KERNEL_DECL(solve_homotopy_sparse,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<homotopy_report, error_code> op(
+            const csc_span<T> A,
+            const ndspan<T> y,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
+
+    KERNEL_DECL(solve_homotopy_reduced,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<homotopy_report, error_code> op(
+            const half::matrix A,
+            const ndspan<T> y,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
+
+    KERNEL_DECL(solve_homotopy_screened,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<homotopy_report, error_code> op(
+            const ndspan<T, 2> A,
+            const quantized::matrix Q,
+            const ndspan<T> y,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
+
+    /*  The homotopy solver specialized on the signal length, see
+     *  solvers/fixed_size.h. A must be eligible for it.
+     */
+    KERNEL_DECL(solve_homotopy_fixed,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<homotopy_report, error_code> op(
+            const ndspan<T, 2> A,
+            const ndspan<T> y,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
+
+    /*  A window of a stream solved by solve_homotopy_window: the window y,
+     *  its solution x, the correlations transpose(A) (y - A x), and the
+     *  active set of x with the inverse of its Gram matrix, all carried
+     *  from one window to the next.
+     */
+    template <typename T>
+    struct homotopy_window
+    {
+        homotopy_window(const mat_view<T> A)
+            : A{ A }
+            , y(xt::zeros<T>({ dim<0>(A) }))
+            , x(xt::zeros<T>({ dim<1>(A) }))
+            , c(xt::zeros<T>({ dim<1>(A) }))
+        {}
+
+        const mat_view<T> A;
+        vec<T> y, x, c;
+
+        /* the correlation of the active set, held while y changes */
+        T lambda{ 0 };
+
+        rank_index<uint32_t> active;
+        std::unique_ptr<online_column_inverse<T>> inv;
+
+        /*  whether x, c and the active set solve the window, so the next
+            may start from them */
+        bool warm{ false };
+
+        /* the warm follows since c was last recomputed from y and x */
+        uint32_t unverified{ 0 };
+    };
+
+    /*  Writes values over rows [first, first + size) of the window, modulo
+     *  its length, and solves it. A warm window follows the path of its
+     *  solution as y moves to the new window, instead of starting from
+     *  x = 0; transpose(A) of the change in y is formed from the changed
+     *  rows alone. Otherwise, or if the path fails, the window is solved
+     *  from x = 0 as solve_homotopy.
+     */
+    KERNEL_DECL(solve_homotopy_window,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<homotopy_report, error_code> op(
+            homotopy_window<T>& W,
+            size_t first,
+            const ndspan<T> values,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
 }
\ No newline at end of file
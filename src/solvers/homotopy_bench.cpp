@@ -3,6 +3,8 @@
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xrandom.hpp>
 #include <xtensor/xview.hpp>
+#include <xtensor/xmath.hpp>
+#include <xtensor/xsort.hpp>
 
 #include <benchmark/benchmark.h>
 
@@ -57,4 +59,54 @@ namespace
 BENCHMARK(homotopy_bench)
     ->RangeMultiplier(4)
     ->Unit(benchmark::kMillisecond)
-    ->Ranges({ { 16, 8 << 6 } /* M */, { 16, 8 << 8 } } /* N */);
\ No newline at end of file
+    ->Ranges({ { 16, 8 << 6 } /* M */, { 16, 8 << 8 } } /* N */);
+
+namespace
+{
+    /*  Solves with the sensing matrix stored as float (0), fp16 (1) or
+     *  bf16 (2), reporting iterations per second and the largest difference
+     *  from the float solution.
+     */
+    inline void homotopy_storage_bench(benchmark::State& state)
+    {
+        xt::random::seed(0);
+
+        const uint32_t M = state.range(0);
+        const uint32_t N = state.range(1);
+        const ss::homotopy_storage storage[] = {
+            ss::homotopy_storage::native, ss::homotopy_storage::fp16, ss::homotopy_storage::bf16 };
+
+        const int PATTERN = 2;
+        const float TOL = 0.1f;
+
+        xtensor<float, 2> haystack = xt::random::randn({ M, N }, .5f, .1f);
+        xt::view(haystack, xt::range(0, int(M), PATTERN), N / 2) += 1.0f;
+
+        xtensor<float, 1> signal = xt::random::randn({ M }, .5f, .1f);
+        xt::view(signal, xt::range(0, int(M), PATTERN)) += 1.0f;
+
+        xtensor<float, 1> expect = xt::zeros<float>({ N });
+        ss::homotopy<float>(as_span(haystack)).solve(as_span(signal), TOL, N, as_span(expect));
+
+        ss::homotopy_options options;
+        options.storage = storage[state.range(2)];
+
+        ss::homotopy<float> solver(as_span(haystack), options);
+        xtensor<float, 1> x = xt::zeros<float>({ N });
+        int64_t iters = 0;
+
+        while (state.KeepRunning())
+        {
+            auto result = solver.solve(as_span(signal), TOL, N, as_span(x));
+            iters += result.get_unchecked<ss::homotopy_report>().iter;
+        }
+
+        state.SetItemsProcessed(iters);
+        state.counters["Max difference"] = xt::amax(xt::abs(x - expect))();
+    }
+}
+
+BENCHMARK(homotopy_storage_bench)
+    ->Unit(benchmark::kMillisecond)
+    ->ArgNames({ "M", "N", "storage" })
+    ->ArgsProduct({ { 256, 1024 } /* M */, { 4096, 32768 } /* N */, { 0, 1, 2 } });
@@ -1,8 +1,15 @@
 #include <ss/ss.h>
 #include "test_util.h"
 
+#include <xtensor/xadapt.hpp>
+#include <xtensor/xmath.hpp>
+
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <memory>
+#include <vector>
+
 namespace
 {
     template <> void check_report<ss::homotopy_report>(
@@ -58,4 +65,360 @@ TEST(homotopy, permutations)
     /* underdetermined */
     ::permutations_test<ss::homotopy, float>(10, 25, .05f, .05f, 50);
     ::permutations_test<ss::homotopy, double>(10, 25, .05f, .05f, 50);
+}
+namespace
+{
+    template <typename T>
+    void layouts_test(uint32_t M, uint32_t N)
+    {
+        xtensor<T, 2> A = needle_dictionary<T>(M, N);
+        xtensor<T, 1> signal = xt::ones<T>({ M });
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+
+        ss::homotopy<T>(as_span(A)).solve(as_span(signal), T(.01), 50, as_span(expect));
+
+        /* column-major copy of A */
+        std::vector<T> col_major(M * N);
+        for (uint32_t i = 0; i < M; i++) {
+            for (uint32_t j = 0; j < N; j++) { col_major[j * M + i] = A(i, j); }
+        }
+
+        /* every other row and column of a larger matrix */
+        std::vector<T> strided(4 * M * N, T(-1));
+        for (uint32_t i = 0; i < M; i++) {
+            for (uint32_t j = 0; j < N; j++) { strided[(2 * i) * (2 * N) + 2 * j] = A(i, j); }
+        }
+
+        const ss::ndspan<T, 2> views[] = {
+            as_span<2>(col_major.data(), { M, N }, { 1, M }),
+            as_span<2>(strided.data(), { M, N }, { 4 * N, 2 })
+        };
+
+        for (auto& view : views) {
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+            ss::homotopy<T>(view).solve(as_span(signal), T(.01), 50, as_span(x));
+
+            EXPECT_TRUE(xt::allclose(expect, x));
+        }
+
+        {   /* solver owned column-major copy */
+            ss::homotopy_options options;
+            options.column_major_copy = true;
+
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+            ss::homotopy<T>(as_span(A), options).solve(as_span(signal), T(.01), 50, as_span(x));
+
+            EXPECT_TRUE(xt::allclose(expect, x));
+        }
+    }
+}
+
+TEST(homotopy, layouts)
+{
+    layouts_test<float>(20, 10);
+    layouts_test<double>(10, 25);
+}
+
+namespace
+{
+    template <typename T>
+    struct compressed
+    {
+        std::vector<T>       values;
+        std::vector<int32_t> indices;
+        std::vector<int32_t> ptr;
+    };
+
+    /* compresses the columns of A, or the rows of A if by_row */
+    template <typename T>
+    compressed<T> compress(const xtensor<T, 2>& A, bool by_row)
+    {
+        const size_t outer = dim<0>(A) * by_row + dim<1>(A) * !by_row;
+        const size_t inner = dim<0>(A) * !by_row + dim<1>(A) * by_row;
+
+        compressed<T> c;
+        c.ptr.push_back(0);
+
+        for (size_t o = 0; o < outer; o++) {
+            for (size_t i = 0; i < inner; i++) {
+                const T v = by_row ? A(o, i) : A(i, o);
+                if (v != T(0)) {
+                    c.values.push_back(v);
+                    c.indices.push_back(int32_t(i));
+                }
+            }
+            c.ptr.push_back(int32_t(c.values.size()));
+        }
+        return c;
+    }
+
+    template <typename T>
+    void sparse_test(uint32_t M, uint32_t N)
+    {
+        /* roughly 1 in 4 nonzeros, besides the column of ones */
+        xtensor<T, 2> A = needle_dictionary<T>(M, N);
+        A = xt::where(A < T(.075), T(0), A);
+
+        auto csc = compress(A, false);
+        auto csr = compress(A, true);
+
+        const ss::csc_span<T> spans[] = {
+            ss::as_csc_span(M, N, csc.values.data(), csc.indices.data(), csc.ptr.data()),
+            ss::as_csc_span(M, N, csc.values.data(), csc.indices.data(), csc.ptr.data(),
+                                  csr.values.data(), csr.indices.data(), csr.ptr.data())
+        };
+
+        xtensor<T, 1> signal = xt::ones<T>({ M });
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+
+        ss::homotopy<T>(as_span(A)).solve(as_span(signal), T(.01), 50, as_span(expect));
+
+        xtensor<T, 1> expect_y = xt::zeros<T>({ M });
+        ss::reconstruct_signal(as_span(A), as_span(expect), as_span(expect_y));
+
+        for (auto& span : spans) {
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+            ss::sparse_homotopy<T>(span).solve(as_span(signal), T(.01), 50, as_span(x));
+
+            EXPECT_TRUE(xt::allclose(expect, x));
+
+            xtensor<T, 1> y = xt::zeros<T>({ M });
+            ss::reconstruct_signal(span, as_span(x), as_span(y));
+
+            EXPECT_TRUE(xt::allclose(expect_y, y));
+        }
+
+        {   /* duplicate entries are summed, as each value split in two */
+            compressed<T> split;
+            split.ptr.push_back(0);
+
+            for (size_t j = 0; j < N; j++) {
+                for (int32_t k = csc.ptr[j]; k < csc.ptr[j + 1]; k++) {
+                    for (int d = 0; d < 2; d++) {
+                        split.values.push_back(csc.values[k] / 2);
+                        split.indices.push_back(csc.indices[k]);
+                    }
+                }
+                split.ptr.push_back(int32_t(split.values.size()));
+            }
+
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+            ss::sparse_homotopy<T>(ss::as_csc_span(M, N,
+                split.values.data(), split.indices.data(), split.ptr.data()))
+                .solve(as_span(signal), T(.01), 50, as_span(x));
+
+            EXPECT_TRUE(xt::allclose(expect, x));
+        }
+
+        {   /* normalization, of both the CSC values and the CSR mirror */
+            ss::norm_l1(as_span(A));
+            ss::norm_l1(spans[1]);
+
+            auto normalized_csc = compress(A, false);
+            auto normalized_csr = compress(A, true);
+
+            EXPECT_TRUE(xt::allclose(xt::adapt(normalized_csc.values), xt::adapt(csc.values)));
+            EXPECT_TRUE(xt::allclose(xt::adapt(normalized_csr.values), xt::adapt(csr.values)));
+        }
+    }
+}
+
+TEST(homotopy, sparse)
+{
+    sparse_test<float>(20, 10);
+    sparse_test<double>(10, 25);
+}
+
+namespace
+{
+    template <typename T>
+    void storage_test(uint32_t M, uint32_t N)
+    {
+        xtensor<T, 2> A = needle_dictionary<T>(M, N);
+        xtensor<T, 1> signal = xt::ones<T>({ M });
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+
+        ss::homotopy<T>(as_span(A)).solve(as_span(signal), T(.01), 50, as_span(expect));
+
+        for (auto storage : { ss::homotopy_storage::fp16, ss::homotopy_storage::bf16 })
+        {
+            ss::homotopy_options options;
+            options.storage = storage;
+
+            /* the float matrix may be released once the solver is constructed */
+            auto released = std::make_unique<xtensor<T, 2>>(A);
+            ss::homotopy<T> solver(as_span(*released), options);
+            released.reset();
+
+            xtensor<T, 1> x = xt::zeros<T>({ N });
+            auto result = solver.solve(as_span(signal), T(.01), 50, as_span(x));
+
+            ::check_report(result, .01f, 50);
+
+            /* the same support, with coefficients within the storage precision */
+            EXPECT_EQ(xt::argmax(expect)(), xt::argmax(x)());
+            EXPECT_TRUE(xt::allclose(expect, x, 1e-2, 1e-2));
+        }
+    }
+}
+
+TEST(homotopy, storage)
+{
+    storage_test<float>(20, 10);
+    storage_test<double>(10, 25);
+}
+
+namespace
+{
+    template <typename T>
+    void screening_test(uint32_t M, uint32_t N)
+    {
+        xtensor<T, 2> A = random_dictionary<T>(M, N);
+        xt::view(A, xt::all(), N / 2) += T(.5);
+        xt::view(A, xt::all(), N / 3) += T(.25);
+
+        xtensor<T, 1> signal = xt::ones<T>({ M });
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+
+        auto expect_result = ss::homotopy<T>(as_span(A))
+            .solve(as_span(signal), T(.01), 50, as_span(expect));
+
+        ss::homotopy_options options;
+        options.quantized_screening = true;
+
+        xtensor<T, 1> x = xt::zeros<T>({ N });
+        auto result = ss::homotopy<T>(as_span(A), options)
+            .solve(as_span(signal), T(.01), 50, as_span(x));
+
+        ::check_report(result, .01f, 50);
+
+        /* the same path, up to the rounding of the exact evaluations */
+        EXPECT_EQ(expect_result.template get<ss::homotopy_report>().iter,
+                  result.template get<ss::homotopy_report>().iter);
+        EXPECT_TRUE(xt::allclose(expect, x));
+    }
+}
+
+TEST(homotopy, quantized_screening)
+{
+    screening_test<float>(20, 10);
+    screening_test<float>(64, 500);
+    screening_test<double>(10, 25);
+    screening_test<double>(128, 1000);
+}
+
+namespace
+{
+    /* stops the homotopy solve of a random signal */
+    template <typename T>
+    void homotopy_control_test(uint32_t M, uint32_t N)
+    {
+        xtensor<T, 2> A = random_dictionary<T>(M, N, T(1));
+        xtensor<T, 1> signal = xt::random::rand<T>({ M }, T(0), T(1));
+
+        ::control_test<ss::homotopy>(A, signal, 100,
+            [](const ss::homotopy_report& r, const xtensor<T, 1>&) {
+                EXPECT_GT(r.solution_error, .001);
+            });
+    }
+}
+
+TEST(homotopy, solve_control)
+{
+    homotopy_control_test<float>(20, 40);
+    homotopy_control_test<double>(20, 40);
+
+    /* the specialized solver of a compiled signal length */
+    homotopy_control_test<float>(32, 64);
+}
+
+
+
+namespace
+{
+    /*  a stream solves each window of a time series to tolerance, from the
+     *  solution of the last, in fewer iterations than solving each window
+     */
+    template <typename T>
+    void stream_test(uint32_t M, uint32_t N)
+    {
+        const T tol{ .005 };
+        const uint32_t max_iter{ 200 };
+
+        xtensor<T, 2> A = random_dictionary<T>(M, N, T(1));
+        xtensor<T, 1> series = xt::random::rand<T>({ 2 * M }, T(0), T(1));
+
+        ss::homotopy<T> solver(as_span(A));
+        ss::homotopy_stream<T> stream(as_span(A), tol, max_iter);
+
+        xtensor<T, 1> y = xt::zeros<T>({ M });
+        xtensor<T, 1> x = xt::zeros<T>({ N });
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+
+        uint32_t stream_iter{ 0 }, solver_iter{ 0 };
+
+        /* the first window at once, then a sample at a time */
+        for (uint32_t t = 0; t < 2 * M; t = (t == 0 ? M : t + 1))
+        {
+            const uint32_t k = t == 0 ? M : 1;
+            for (uint32_t i = t; i < t + k; i++) { y[i % M] = series[i]; }
+
+            auto result = stream.push(as_span(&series[t], k));
+            ::check_report(result, float(tol), max_iter);
+            EXPECT_EQ((t + k) % M, stream.head());
+
+            ss::homotopy_report r;
+            ASSERT_TRUE(stream.pop(as_span(x), &r));
+            EXPECT_FALSE(stream.pop(as_span(x)));
+            EXPECT_EQ(result.template get<ss::homotopy_report>().iter, r.iter);
+
+            /* the correlations of the solution are within tolerance */
+            if (r.iter < max_iter) {
+                xtensor<T, 1> residual = y;
+                for (uint32_t i = 0; i < M; i++) {
+                    for (uint32_t j = 0; j < N; j++) { residual[i] -= A(i, j) * x[j]; }
+                }
+
+                T c_inf{ 0 };
+                for (uint32_t j = 0; j < N; j++) {
+                    T c{ 0 };
+                    for (uint32_t i = 0; i < M; i++) { c += A(i, j) * residual[i]; }
+                    c_inf = std::max(c_inf, std::abs(c));
+                }
+                EXPECT_LE(c_inf, tol * T(1.01));
+            }
+
+            if (t > 0) {
+                stream_iter += r.iter;
+                solver_iter += solver.solve(as_span(y), tol, max_iter, as_span(expect))
+                    .template get<ss::homotopy_report>().iter;
+            }
+        }
+        EXPECT_LT(stream_iter, solver_iter);
+        EXPECT_EQ(0, stream.dropped());
+
+        /* the ring drops the newest solutions when full */
+        ss::homotopy_stream<T> small(as_span(A), tol, max_iter, 2);
+        std::vector<uint32_t> iters;
+
+        for (uint32_t t = 0; t < 4; t++) {
+            auto result = small.update(0, as_span(&series[t], M));
+            iters.push_back(result.template get<ss::homotopy_report>().iter);
+        }
+        EXPECT_EQ(2, small.dropped());
+        EXPECT_EQ(0, small.head());
+
+        for (uint32_t t = 0; t < 2; t++) {
+            ss::homotopy_report r;
+            ASSERT_TRUE(small.pop(as_span(x), &r));
+            EXPECT_EQ(iters[t], r.iter);
+        }
+        EXPECT_FALSE(small.pop(as_span(x)));
+    }
+}
+
+TEST(homotopy, stream)
+{
+    stream_test<float>(20, 40);
+    stream_test<double>(24, 64);
 }
\ No newline at end of file
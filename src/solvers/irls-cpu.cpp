@@ -17,6 +17,7 @@ limitations under the License.  */
 #include "linalg/common.h"
 #include "linalg/blas_wrapper.h"
 #include "linalg/cholesky_decomposition.h"
+#include "linalg/iterative_refinement.h"
 
 #include <xtensor/xmath.hpp>
 #include <xtensor/xsort.hpp>
@@ -36,12 +37,15 @@ namespace ss
         }
     }
 
-    template <typename T>
+    /*  lstsq(t, x) : solves the least squares problem A x = t, where t
+     *                  is in the range of A = QR
+     */
+    template <typename T, typename LeastSquares>
     bool irls_newton(
-        const ndspan<T, 2> R,
         const ndspan<T, 2> Q,
         const ndspan<T> y,
         const ndspan<T> w,
+        LeastSquares&& lstsq,
         ndspan<T> x)
     {
         xt::xtensor<T, 2> qw = ss::view(Q) * w;
@@ -53,15 +57,15 @@ namespace ss
         auto qTb = blas::xgemv(CblasTrans, T{1}, Q, y);
         auto s = chol.solve(qTb);
         auto t = blas::xgemv(CblasNoTrans, T{1}, Q, s);
-        
-        blas::xgemv(CblasTrans, T{1}, Q, t, T{0}, x);
-        blas::xtrsm(CblasUpper, CblasNoTrans, CblasNonUnit, T{1}, R, x);
+
+        lstsq(as_span(t), x);
         return true;
     }
 
-    template <typename T>
+    template <typename T, typename LeastSquares>
     irls_report run_solver(
-        const qr_decomposition<T>& QR,
+        const xt::xtensor<T, 2>& Q,
+        LeastSquares&& lstsq,
         const std::uint32_t max_iter,
         const T tolerance,
         const ndspan<T> y,
@@ -69,9 +73,6 @@ namespace ss
     {
         const T p{ 0.9 };
 
-        auto Q = QR.q();
-        auto R = QR.r();
-
         assert(max_iter > 0
             && y.size() == dim<0>(Q)
             && x.size() == dim<1>(Q));
@@ -81,8 +82,11 @@ namespace ss
         /* initialize the result */
         view(x) = T{ 0 };
 
-        xt::xtensor<T, 1> w = xt::ones<T>({ N });
-        xt::xtensor<T, 1> xnext = xt::ones<T>({ N });
+        vec<T> w = xt::ones<T>({ N });
+        vec<T> xnext = xt::ones<T>({ N });
+
+        const solve_control* control = detail::current_control();
+        bool truncated{ false };
 
         std::uint32_t iter{ 0u };
         bool spd_error{ false };
@@ -91,7 +95,7 @@ namespace ss
 
         do {
             /* update x */
-            if (!irls_newton(as_span(R), as_span(Q), y, as_span(w), as_span(xnext))) {
+            if (!irls_newton(as_span(Q), y, as_span(w), lstsq, as_span(xnext))) {
                 spd_error = true;
                 break;
             }
@@ -115,33 +119,84 @@ namespace ss
 
             iter++;
         }
-        while (iter < max_iter && xnext(1) > abstol);
+        while (iter < max_iter && xnext(1) > abstol
+            && !(truncated = detail::expired(control)));
 
         /* finally, normalize x */
         view(x) /= xt::sum(x);
 
-        return { iter, eps, spd_error };
+        return { iter, eps, spd_error, truncated };
+    }
+
+    template <typename T>
+    irls_report run_solver(
+        const irls_factors<T>& F,
+        const std::uint32_t max_iter,
+        const T tolerance,
+        const ndspan<T> y,
+        ndspan<T> x)
+    {
+        const auto& Q = F.Q;
+        const auto& R = F.R;
+
+        /* x = inv(R) transpose(Q) t */
+        auto lstsq = [&](const ndspan<T> t, ndspan<T> out) {
+            blas::xgemv(CblasTrans, T{1}, as_span(Q), t, T{0}, out);
+            blas::xtrsm(CblasUpper, CblasNoTrans, CblasNonUnit, T{1}, as_span(R), out);
+        };
+
+        return run_solver(Q, lstsq, max_iter, tolerance, y, x);
+    }
+
+    template <typename T>
+    irls_report run_solver(
+        const qr_decomposition<float>& QR,
+        const xt::xtensor<T, 2>& Q,
+        const ndspan<float, 2> A,
+        const std::uint32_t max_iter,
+        const T tolerance,
+        const ndspan<T> y,
+        ndspan<T> x)
+    {
+        /* x from the single precision factorization, refined against A */
+        auto lstsq = [&](const ndspan<T> t, ndspan<T> out) {
+            refine_solve(QR, A, t, out);
+        };
+
+        return run_solver(Q, lstsq, max_iter, tolerance, y, x);
     }
 
     template <> kernelpp::variant<irls_report, error_code>
     solve_irls::op<compute_mode::CPU, float>(
-        const qr_decomposition<float>& QR,
+        const irls_factors<float>& F,
         const ndspan<float> y,
         float tolerance,
         std::uint32_t max_iterations,
         ndspan<float> x)
     {
-        return run_solver<float>(QR, max_iterations, tolerance, y, x);
+        return run_solver<float>(F, max_iterations, tolerance, y, x);
     }
 
     template <> kernelpp::variant<irls_report, error_code>
     solve_irls::op<compute_mode::CPU, double>(
-        const qr_decomposition<double>& QR,
+        const irls_factors<double>& F,
+        const ndspan<double> y,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return run_solver<double>(F, max_iterations, tolerance, y, x);
+    }
+    template <> kernelpp::variant<irls_report, error_code>
+    solve_irls_mixed::op<compute_mode::CPU, double>(
+        const qr_decomposition<float>& QR,
+        const xt::xtensor<double, 2>& Q,
+        const ndspan<float, 2> A,
         const ndspan<double> y,
         double tolerance,
         std::uint32_t max_iterations,
         ndspan<double> x)
     {
-        return run_solver<double>(QR, max_iterations, tolerance, y, x);
+        return run_solver<double>(QR, Q, A, max_iterations, tolerance, y, x);
     }
 }
\ No newline at end of file
@@ -0,0 +1,224 @@
+/*  Copyright 2017 International Business Machines Corporation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.  */
+
+#include "solvers/irls.h"
+#include "solvers/fixed_size.h"
+
+#include "linalg/common.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <assert.h>
+
+namespace ss {
+namespace fixed
+{
+    /*  Unblocked Cholesky factorization of the leading n-by-n block of a,
+     *  referencing only its lower triangle, as detail::potf2. Returns false
+     *  if the block is not positive definite.
+     */
+    template <size_t M, typename T>
+    bool potf2(T (&a)[M][M], size_t n)
+    {
+        const T eps = std::numeric_limits<T>::epsilon();
+
+        for (size_t j = 0; j < n; j++) {
+            /* a(j:n, j) -= a(j:n, 0:j) * a(j, 0:j) */
+            for (size_t i = j; i < n; i++) {
+                T s{ 0 };
+                for (size_t k = 0; k < j; k++) { s += a[i][k] * a[j][k]; }
+                a[i][j] -= s;
+            }
+
+            const T ajj = std::sqrt(a[j][j]);
+            if (!(ajj > eps)) {
+                return false;
+            }
+            for (size_t i = j; i < n; i++) { a[i][j] /= ajj; }
+        }
+        return true;
+    }
+
+    /*  The IRLS solver of solvers/irls-cpu.cpp. Each Newton step there
+     *  forms transpose(Q) Q diag(w) and applies Q and transpose(Q) in turn;
+     *  here transpose(Q) Q and transpose(Q) y are formed once per solve, so
+     *  each iteration is on N-by-N blocks held on the stack.
+     */
+    template <size_t M, typename T>
+    irls_report run_solver(
+        const irls_factors<T>& F,
+        const std::uint32_t max_iter,
+        const T tolerance,
+        const ndspan<T> y,
+        ndspan<T> x)
+    {
+        const T p{ 0.9 };
+
+        const xt::xtensor<T, 2>& Q = F.Q;
+        const xt::xtensor<T, 2>& R = F.R;
+
+        assert(max_iter > 0
+            && dim<0>(Q) == M
+            && y.size() == M
+            && x.size() == dim<1>(Q)
+            && x.size() <= M);
+
+        const size_t N = dim<0>(x);
+
+        alignas(64) T QtQ[M][M], L[M][M], U[M][M];
+        alignas(64) T Qty[M], w[M], s[M], xnext[M], xs[M];
+
+        {   /* transpose(Q) Q and transpose(Q) y, and R */
+            const T* q = Q.raw_data();
+
+            for (size_t i = 0; i < N; i++) {
+                T b{ 0 };
+                for (size_t m = 0; m < M; m++) { b += q[m * N + i] * y[m]; }
+                Qty[i] = b;
+
+                for (size_t j = 0; j <= i; j++) {
+                    T g{ 0 };
+                    for (size_t m = 0; m < M; m++) { g += q[m * N + i] * q[m * N + j]; }
+                    QtQ[i][j] = QtQ[j][i] = g;
+                }
+                for (size_t j = 0; j < N; j++) { U[i][j] = R(i, j); }
+            }
+        }
+
+        /* initialize the result */
+        std::fill(xs, xs + N, T{ 0 });
+        std::fill(w, w + N, T{ 1 });
+
+        const solve_control* control = detail::current_control();
+        bool truncated{ false };
+
+        std::uint32_t iter{ 0u };
+        bool spd_error{ false };
+        T abstol{ 1.0 };
+        T eps{ 1 };
+        T second{ 0 };
+
+        do {
+            /* the lower triangle of transpose(Q) Q diag(w) */
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j <= i; j++) { L[i][j] = QtQ[i][j] * w[j]; }
+            }
+            if (!potf2(L, N)) {
+                spd_error = true;
+                break;
+            }
+
+            /* s = inv(L transpose(L)) transpose(Q) y */
+            for (size_t i = 0; i < N; i++) {
+                T b{ Qty[i] };
+                for (size_t k = 0; k < i; k++) { b -= L[i][k] * s[k]; }
+                s[i] = b / L[i][i];
+            }
+            for (size_t i = N; i-- > 0;) {
+                T b{ s[i] };
+                for (size_t k = i + 1; k < N; k++) { b -= L[k][i] * s[k]; }
+                s[i] = b / L[i][i];
+            }
+
+            /* x = inv(R) transpose(Q) Q s */
+            for (size_t i = N; i-- > 0;) {
+                T b{ 0 };
+                for (size_t k = 0; k < N; k++) { b += QtQ[i][k] * s[k]; }
+                for (size_t k = i + 1; k < N; k++) { b -= U[i][k] * xnext[k]; }
+                xnext[i] = b / U[i][i];
+            }
+
+            /* use tolerance as a proportion of the max value of x */
+            abstol = *std::max_element(xnext, xnext + N) * tolerance;
+
+            /* threshold, and find the second largest value of x */
+            T first{ std::numeric_limits<T>::lowest() };
+            second = std::numeric_limits<T>::lowest();
+
+            for (size_t i = 0; i < N; i++) {
+                if (xnext[i] < abstol) { xnext[i] = T{ 0 }; }
+                xs[i] = xnext[i];
+
+                if (xs[i] > first)       { second = first; first = xs[i]; }
+                else if (xs[i] > second) { second = xs[i]; }
+            }
+
+            /* update eps */
+            eps = std::min(eps, second / T(N));
+
+            /* update weights and normalize */
+            T sum{ 0 };
+            for (size_t i = 0; i < N; i++) {
+                w[i] = T(std::pow(xs[i] * xs[i] + eps, (p / 2.0) - 1.0));
+                sum += w[i];
+            }
+            for (size_t i = 0; i < N; i++) { w[i] /= sum; }
+
+            iter++;
+        }
+        while (iter < max_iter && second > abstol
+            && !(truncated = detail::expired(control)));
+
+        /* finally, normalize x */
+        T sum{ 0 };
+        for (size_t i = 0; i < N; i++) { sum += xs[i]; }
+        for (size_t i = 0; i < N; i++) { x[i] = xs[i] / sum; }
+
+        return { iter, eps, spd_error, truncated };
+    }
+
+    template <typename T>
+    kernelpp::variant<irls_report, error_code> dispatch(
+        const irls_factors<T>& F,
+        const ndspan<T> y,
+        T tolerance,
+        std::uint32_t max_iterations,
+        ndspan<T> x)
+    {
+        if (!irls_eligible(y.size(), x.size())) { return error_code::KERNEL_FAILED; }
+
+        switch (y.size()) {
+#define SS_FIXED_CASE(M) \
+            case M: return run_solver<M, T>(F, max_iterations, tolerance, y, x);
+            SS_FIXED_SIGNAL_LENGTHS(SS_FIXED_CASE)
+#undef SS_FIXED_CASE
+            default:
+                return error_code::KERNEL_FAILED;
+        }
+    }
+}
+
+    template <> kernelpp::variant<irls_report, error_code>
+    solve_irls_fixed::op<compute_mode::CPU, float>(
+        const irls_factors<float>& F,
+        const ndspan<float> y,
+        float tolerance,
+        std::uint32_t max_iterations,
+        ndspan<float> x)
+    {
+        return fixed::dispatch<float>(F, y, tolerance, max_iterations, x);
+    }
+
+    template <> kernelpp::variant<irls_report, error_code>
+    solve_irls_fixed::op<compute_mode::CPU, double>(
+        const irls_factors<double>& F,
+        const ndspan<double> y,
+        double tolerance,
+        std::uint32_t max_iterations,
+        ndspan<double> x)
+    {
+        return fixed::dispatch<double>(F, y, tolerance, max_iterations, x);
+    }
+}
@@ -25,12 +25,62 @@ namespace ss
     using kernelpp::compute_mode;
     using kernelpp::error_code;
 
+    /*  The explicit factors of a QR factorization, which each solve reads.
+     *  They are formed once, in the irls_state shared by every solver of
+     *  the matrix, rather than once per solve.
+     */
+    template <typename T>
+    struct irls_factors
+    {
+        explicit irls_factors(const qr_decomposition<T>& QR)
+            : Q{ QR.q() }, R{ QR.r() }
+        {}
+
+        xt::xtensor<T, 2> Q;
+        xt::xtensor<T, 2> R;
+    };
+
     KERNEL_DECL(solve_irls,
         compute_mode::CPU)
     {
         template <compute_mode, typename T>
         static kernelpp::variant<irls_report, error_code> op(
-            const qr_decomposition<T>& QR,
+            const irls_factors<T>& F,
+            const ndspan<T> y,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
+
+    /*  IRLS where the sensing matrix A and its factorization are single
+     *  precision, and the solution is refined to the precision of T. Q is
+     *  the orthogonal factor of A in the precision of T, from refine_q.
+     */
+    KERNEL_DECL(solve_irls_mixed,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<irls_report, error_code> op(
+            const qr_decomposition<float>& QR,
+            const xt::xtensor<T, 2>& Q,
+            const ndspan<float, 2> A,
+            const ndspan<T> y,
+            T tolerance,
+            std::uint32_t max_iterations,
+            ndspan<T> x
+            );
+    };
+
+    /*  IRLS specialized on the signal length, see solvers/fixed_size.h.
+     *  The factorized matrix must be eligible for it.
+     */
+    KERNEL_DECL(solve_irls_fixed,
+        compute_mode::CPU)
+    {
+        template <compute_mode, typename T>
+        static kernelpp::variant<irls_report, error_code> op(
+            const irls_factors<T>& F,
             const ndspan<T> y,
             T tolerance,
             std::uint32_t max_iterations,
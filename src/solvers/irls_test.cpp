@@ -1,6 +1,8 @@
 #include "test_util.h"
 #include <ss/ss.h>
 
+#include <xtensor/xmath.hpp>
+
 #include <gtest/gtest.h>
 
 namespace
@@ -51,4 +53,89 @@ TEST(irls, permutations)
     ::permutations_test<ss::irls, double>(10, 5, .1f, .1f, 20);
 
     /* TODO(rayg): underdetermined systems not supported by this solver */
-}
\ No newline at end of file
+}
+
+TEST(irls, mixed_precision)
+{
+    const uint32_t M = 10, N = 5;
+    xt::random::seed(0);
+
+    /* single precision sensing matrix with an identity sub-block */
+    xtensor<float, 2> A = xt::random::randn({ M, N }, 0.0f, 0.01f);
+    for (uint32_t n = 0; n < N; n++) { A(n, n) += 1.0f; }
+
+    ss::irls_mixed<double> mixed(as_span(A));
+    ss::irls<float> single(as_span(A));
+
+    for (uint32_t n = 0; n < N; n++)
+    {
+        xtensor<double, 1> signal = xt::view(A, xt::all(), n);
+        xtensor<float, 1> signal_f = signal;
+
+        xtensor<double, 1> x = xt::zeros<double>({ N });
+        xtensor<float, 1> x_f = xt::zeros<float>({ N });
+
+        auto result = mixed.solve(as_span(signal), .001, N, as_span(x));
+        ::check_report(result, .001f, N);
+
+        single.solve(as_span(signal_f), .001f, N, as_span(x_f));
+
+        /* the same solution as the single precision solver */
+        EXPECT_EQ(xt::argmax(x)(), n);
+        EXPECT_TRUE(xt::allclose(x, x_f, 0.0, 1e-4));
+    }
+
+    /*  and as the double precision solver of the same matrix, to double
+        precision, for a signal which isn't a column of A */
+    xtensor<double, 2> A_d = A;
+    ss::irls<double> reference(as_span(A_d));
+
+    for (uint32_t n = 0; n < N; n++)
+    {
+        xtensor<double, 1> signal = xt::view(A_d, xt::all(), n);
+        xt::view(signal, xt::all()) += .4 * xt::view(A_d, xt::all(), (n + 1) % N);
+        xt::view(signal, xt::all()) += 1e-3 * xt::random::randn<double>({ M }, 0., 1.);
+
+        xtensor<double, 1> x = xt::zeros<double>({ N });
+        xtensor<double, 1> expect = xt::zeros<double>({ N });
+
+        auto result = mixed.solve(as_span(signal), 1e-6, 20, as_span(x));
+        auto expect_result = reference.solve(as_span(signal), 1e-6, 20, as_span(expect));
+
+        ASSERT_TRUE(result.is<ss::irls_report>());
+        EXPECT_EQ(expect_result.get<ss::irls_report>().iter, result.get<ss::irls_report>().iter);
+        EXPECT_TRUE(xt::allclose(expect, x, 0.0, 1e-10));
+    }
+}
+
+namespace
+{
+    /* stops the IRLS solve of a mix of two columns */
+    template <typename T>
+    void irls_control_test(uint32_t M, uint32_t N)
+    {
+        xt::random::seed(0);
+
+        xtensor<T, 2> A = xt::random::randn({ M, N }, T(0), T(.01));
+        for (uint32_t n = 0; n < N; n++) { A(n, n) += T(1); }
+
+        xtensor<T, 1> signal = xt::view(A, xt::all(), 0);
+        xt::view(signal, xt::all()) += T(.4) * xt::view(A, xt::all(), 1);
+
+        /* a normalized iterate */
+        ::control_test<ss::irls>(A, signal, 50,
+            [](const ss::irls_report&, const xtensor<T, 1>& x) {
+                EXPECT_NEAR(T(1), xt::sum(x)(), 1e-4);
+            });
+    }
+}
+
+TEST(irls, solve_control)
+{
+    irls_control_test<float>(10, 5);
+    irls_control_test<double>(12, 6);
+
+    /* the specialized solver of a compiled signal length */
+    irls_control_test<double>(32, 10);
+}
+
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xrandom.hpp>
@@ -18,12 +20,73 @@ namespace
     template <size_t D, typename M>
     size_t dim(const M& mat) { return mat.shape()[D]; }
 
+    /* seeds the generator, then draws an M x N matrix uniform in [0, scale) */
+    template <typename T>
+    xtensor<T, 2> random_dictionary(uint32_t M, uint32_t N, T scale = T(.1))
+    {
+        xt::random::seed(0);
+        return xt::random::rand<T>({ M, N }, T(0), scale);
+    }
+
+    /*  a random_dictionary with column N / 2 set to ones, the column a
+     *  signal of ones selects
+     */
+    template <typename T>
+    xtensor<T, 2> needle_dictionary(uint32_t M, uint32_t N)
+    {
+        xtensor<T, 2> A = random_dictionary<T>(M, N);
+        xt::view(A, xt::all(), N / 2) = T(1);
+        return A;
+    }
+
     template <typename Report>
     void check_report(
         kernelpp::maybe<Report>& result,
         float tolerance,
         uint32_t max_iterations);
 
+    /*  a solve stops after the iteration in which its control expires;
+     *  check(report, x) checks the report and iterate of a stopped solve
+     */
+    template <template <typename> class Solver, typename T, typename Check>
+    void control_test(xtensor<T, 2>& A, xtensor<T, 1>& signal,
+        uint32_t max_iterations, Check check)
+    {
+        using report_type = typename Solver<T>::report_type;
+
+        const size_t N = dim<1>(A);
+        Solver<T> solver(as_span(A));
+
+        xtensor<T, 1> expect = xt::zeros<T>({ N });
+        auto full = solver.solve(as_span(signal), T(.001), max_iterations, as_span(expect))
+            .template get<report_type>();
+        ASSERT_GT(full.iter, 1);
+        EXPECT_FALSE(full.truncated);
+
+        /* a generous deadline */
+        xtensor<T, 1> x = xt::zeros<T>({ N });
+        auto r = solver.solve(as_span(signal), T(.001), max_iterations, as_span(x),
+            ss::solve_control::within(std::chrono::hours(1))).template get<report_type>();
+
+        EXPECT_FALSE(r.truncated);
+        EXPECT_EQ(full.iter, r.iter);
+        EXPECT_EQ(expect, x);
+
+        /* cancelled, and past its deadline */
+        std::atomic<bool> cancel{ true };
+        ss::solve_control cancelled;
+        cancelled.cancel = &cancel;
+
+        for (auto& control : { cancelled, ss::solve_control::within({}) }) {
+            r = solver.solve(as_span(signal), T(.001), max_iterations, as_span(x), control)
+                .template get<report_type>();
+
+            EXPECT_TRUE(r.truncated);
+            EXPECT_EQ(1, r.iter);
+            check(r, x);
+        }
+    }
+
     template <template <typename> class Solver, typename T>
     void smoke_test()
     {